@@ -1,6 +1,7 @@
 // expm1.cpp - call expm1()
 #include <cmath>
 #include "xll/xll.h"
+#include "xll_profile.h"
 
 using namespace xll;
 
@@ -13,5 +14,6 @@ static AddInX xai_expm1(
 double WINAPI xll_expm1(double x)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	return expm1(x);
 }
\ No newline at end of file
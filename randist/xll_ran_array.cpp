@@ -0,0 +1,71 @@
+// xll_ran_array.cpp - arrays of variates from any distribution by name
+// http://www.gnu.org/software/gsl/manual/html_node/Random-Number-Distributions.html#Random-Number-Distributions
+#include <string>
+#include "../xll_rng.h"
+#include "../xll_randist.h"
+//#define EXCEL12
+#include "xll/xll.h"
+#include "../xll_profile.h"
+
+using namespace xll;
+
+static AddInX xai_ran_array(
+	FunctionX(XLL_FPX, _T("?xll_ran_array"), _T("GSL.RAN.ARRAY"))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
+	.Arg(XLL_CSTRINGX, _T("Distribution"), _T("is the name of the distribution, e.g. \"GAMMA\"."))
+	.Arg(XLL_WORDX, _T("Rows"), _T("is the number of rows to return."))
+	.Arg(XLL_FPX, _T("Parameters"), _T("is an array of the distribution parameters in the order of the GSL sampler."))
+	.Volatile()
+	.ThreadSafe()
+	.Category(_T("GSL"))
+	.FunctionHelp(_T("Return a one column array of random variates from a distribution using a random number generator."))
+	.Documentation(
+		_T("Distribution is not case sensitive and has the parameters of GSL.RAN.<i>Distribution</i>: ")
+		_T("BERNOULLI(p), BETA(a, b), BINOMIAL(p, n), CAUCHY(a), CHISQ(nu), EXPONENTIAL(mu), EXPPOW(a, b), FDIST(nu1, nu2), ")
+		_T("FLAT(a, b), GAMMA(a, b), GAUSSIAN(sigma), GAUSSIAN_TAIL(a, sigma), GEOMETRIC(p), GUMBEL1(a, b), GUMBEL2(a, b), ")
+		_T("HYPERGEOMETRIC(n1, n2, t), LANDAU(), LAPLACE(a), LEVY(c, alpha), LEVY_SKEW(c, alpha, beta), LOGARITHMIC(p), ")
+		_T("LOGISTIC(a), LOGNORMAL(zeta, sigma), NEGATIVE_BINOMIAL(p, n), PARETO(a, b), PASCAL(p, n), POISSON(mu), ")
+		_T("RAYLEIGH(sigma), RAYLEIGH_TAIL(a, sigma), TDIST(nu), and WEIBULL(a, b). ")
+		_T("Parameters are checked once per call and ignored for LANDAU. ")
+		_T("GAUSSIAN uses the ziggurat method of GSL.RAN.GAUSSIAN.ARRAY. FLAT and EXPONENTIAL transform a block of uniforms ")
+		_T("and give the same values as GSL.RAN.FLAT and GSL.RAN.EXPONENTIAL. ")
+	)
+);
+xfpx* WINAPI xll_ran_array(HANDLEX rng, const xchar* dist, WORD rows, const xfpx* pp)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	static thread_local FPX x;
+
+	try {
+		ensure (rows > 0 || !"GSL.RAN.ARRAY: Rows must be positive");
+
+		std::basic_string<xchar> t(dist);
+		const gsl::ran_distribution* d = gsl::find_ran_distribution(std::string(t.begin(), t.end()).c_str());
+		ensure (d || !"GSL.RAN.ARRAY: unknown Distribution");
+
+		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
+
+		x.resize(rows, 1);
+		gsl::ran_array(*d, *r, x.size(), x.array(), pp->array, d->arity ? size(*pp) : 0);
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+
+		return 0;
+	}
+
+	return x.get();
+}
+
+#ifdef _DEBUG
+
+XLL_TEST_BEGIN(xll_test_ran_array)
+
+	test_gsl_randist();
+
+XLL_TEST_END(xll_test_ran_array)
+
+#endif // _DEBUG
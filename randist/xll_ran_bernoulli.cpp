@@ -4,13 +4,15 @@
 #include "../xll_randist.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_bernoulli(
 	FunctionX(XLL_DOUBLEX, _T("?xll_ran_bernoulli"), _T("GSL.RAN.BERNOULLI"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
 	.Arg(XLL_DOUBLEX, _T("p"), _T("is the probability of returning 1. Default is 1"), 1.0)
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return Bernoulli random deviates using a random number generator."))
 	.Documentation(_T(""))
@@ -18,6 +20,7 @@ static AddInX xai_ran_bernoulli(
 double WINAPI xll_ran_bernoulli(HANDLEX rng, double p)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex x;
 
 	try {
@@ -25,10 +28,12 @@ double WINAPI xll_ran_bernoulli(HANDLEX rng, double p)
 			p = 1;
 
 		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 
 		x = gsl_ran_bernoulli(*r, p);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -46,6 +51,7 @@ static AddInX xai_ran_bernoulli_pdf(
 double WINAPI xll_ran_bernoulli_pdf(USHORT k, double p)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 
 	return gsl_ran_bernoulli_pdf(k, p);
 }
@@ -61,6 +67,7 @@ static AddInX xai_cdf_bernoulli_P(
 double WINAPI xll_cdf_bernoulli_P(USHORT k, double p)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	
 	if (k < 0)
 		return 0;
@@ -81,6 +88,7 @@ static AddInX xai_cdf_bernoulli_Pinv(
 double WINAPI xll_cdf_bernoulli_Pinv(double u, double p)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (u > 0 && u < 1 - p)
 		return 0;
 	else
@@ -4,14 +4,16 @@
 #include "../xll_randist.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_beta(
 	FunctionX(XLL_DOUBLEX, _T("?xll_ran_beta"), _T("GSL.RAN.BETA"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
 	.Arg(XLL_DOUBLEX, _T("alpha"), _T("is the first shape parameter of Beta. Default is 2"), 2.0)
 	.Arg(XLL_DOUBLEX, _T("beta"), _T("is the second shape parameter of Beta. Default is 2"), 2.0)
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return Beta deviates using a random number generator."))
 	.Documentation(_T(""))
@@ -19,6 +21,7 @@ static AddInX xai_ran_beta(
 double WINAPI xll_ran_beta(HANDLEX rng, double a, double b)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex x;
 
 	try {
@@ -28,10 +31,12 @@ double WINAPI xll_ran_beta(HANDLEX rng, double a, double b)
 			b = 2;
 
 		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 
 		x = gsl_ran_beta(*r, a, b);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -50,6 +55,7 @@ static AddInX xai_ran_beta_pdf(
 double WINAPI xll_ran_beta_pdf(double x, double a, double b)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (a == 0)
 		a = 2;
 	if (b == 0)
@@ -70,6 +76,7 @@ static AddInX xai_cdf_beta_P(
 double WINAPI xll_cdf_beta_P(double x, double a, double b)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (a == 0)
 		a = 2;
 	if (b == 0)
@@ -90,6 +97,7 @@ static AddInX xai_cdf_beta_Pinv(
 double WINAPI xll_cdf_beta_Pinv(double p, double a, double b)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (a == 0)
 		a = 2;
 	if (b == 0)
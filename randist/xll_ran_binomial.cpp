@@ -4,14 +4,16 @@
 #include "../xll_randist.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_binomial(
 	FunctionX(XLL_USHORTX, _T("?xll_ran_binomial"), _T("GSL.RAN.BINOMIAL"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
 	.Arg(XLL_DOUBLEX, _T("p"), _T("is the probability of success in each independent trial. Default is 0.5."), 0.5)
 	.Arg(XLL_USHORTX, _T("n"), _T("is the number of independent trials. Default is 100."), 100)
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("This function returns a random integer from the binomial distribution, the number of successes in n independent trials with probability p."))
 	.Documentation(_T(""))
@@ -19,8 +21,10 @@ static AddInX xai_ran_binomial(
 unsigned int WINAPI xll_ran_binomial(HANDLEX rng, double p, unsigned int n)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 
 	handle<gsl::rng> r(rng);
+	auto lock = r->lock();
 	return gsl_ran_binomial(*r, p, n);
 }
 
@@ -36,6 +40,7 @@ static AddInX xai_ran_binomial_pdf(
 double WINAPI xll_ran_binomial_pdf(unsigned int k, double p, unsigned int n)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	
 	return gsl_ran_binomial_pdf(k, p, n);
 }
@@ -52,6 +57,7 @@ static AddInX xai_cdf_binomial_P(
 double WINAPI xll_cdf_binomial_P(unsigned int k, double p, unsigned int n)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 
 	return gsl_cdf_binomial_P(k, p, n);
 }
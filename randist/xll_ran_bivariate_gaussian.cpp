@@ -2,17 +2,19 @@
 #include "../xll_randist.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_bivariate_gaussian(
 	FunctionX(XLL_DOUBLEX, _T("?xll_ran_bivariate_gaussian"), _T("GSL.RAN.BIVARIATE.GAUSSIAN"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
 	.Arg(XLL_DOUBLEX, _T("sigma_x"), _T("is the standard deviation of the BivariateGaussian. Default is 1"), 1.0)
 	.Arg(XLL_DOUBLEX, _T("sigma_y"), _T("is the standard deviation of the BivariateGaussian. Default is 1."), 1.0)
 	.Arg(XLL_DOUBLEX, _T("rho"), _T("is the correlation coefficient of the BivariateGaussian."))
 	.Arg(XLL_DOUBLE_, _T("direct_x"), _T("is the direction of the BivariateGaussian."))
 	.Arg(XLL_DOUBLE_, _T("direct_y"), _T("is the direction of the BivariateGaussian."))
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return Bivariate Gaussian/normal random deviates using a random number generator."))
 	.Documentation(_T(""))
@@ -20,6 +22,7 @@ static AddInX xai_ran_bivariate_gaussian(
 void WINAPI xll_ran_bivariate_gaussian(HANDLEX rng, double sigma_x, double sigma_y, double rho, double * x, double * y)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 
 	try {
 		if (sigma_x == 0)
@@ -32,10 +35,12 @@ void WINAPI xll_ran_bivariate_gaussian(HANDLEX rng, double sigma_x, double sigma
 			rho = -1;
 			
 		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 
 		gsl_ran_bivariate_gaussian(*r, sigma_x, sigma_y, rho, x, y);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -55,6 +60,7 @@ static AddInX xai_ran_bivariate_gaussian_pdf(
 double WINAPI xll_ran_bivariate_gaussian_pdf(double x, double y, double sigma_x, double sigma_y, double rho)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (sigma_x == 0)
 		sigma_x = 1;
 	if (sigma_y == 0)
@@ -4,13 +4,15 @@
 #include "../xll_randist.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_cauchy(
 	FunctionX(XLL_DOUBLEX, _T("?xll_ran_cauchy"), _T("GSL.RAN.CAUCHY"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
 	.Arg(XLL_DOUBLEX, _T("a"), _T("is the scale parameter of the Cauchy. Default is 1"), 1.0)
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return Cauchy random deviates using a random number generator."))
 	.Documentation(R_(
@@ -26,6 +28,7 @@ static AddInX xai_ran_cauchy(
 double WINAPI xll_ran_cauchy(HANDLEX rng, double a)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex x;
 
 	try {
@@ -33,10 +36,12 @@ double WINAPI xll_ran_cauchy(HANDLEX rng, double a)
 			a = 1;
 
 		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 
 		x = gsl_ran_cauchy( *r, a);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -54,6 +59,7 @@ static AddInX xai_ran_cauchy_pdf(
 double WINAPI xll_ran_cauchy_pdf(double x, double a)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (a == 0)
 		a = 1;
 
@@ -71,6 +77,7 @@ static AddInX xai_cdf_cauchy_P(
 double WINAPI xll_cdf_cauchy_P(double x, double a)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (a == 0)
 		a = 1;
 
@@ -88,6 +95,7 @@ static AddInX xai_cdf_cauchy_Pinv(
 double WINAPI xll_cdf_cauchy_Pinv(double p, double a)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (a == 0)
 		a = 1;
 
@@ -4,13 +4,15 @@
 #include "../xll_randist.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_chisq(
 	FunctionX(XLL_DOUBLEX, _T("?xll_ran_chisq"), _T("GSL.RAN.CHISQ"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
 	.Arg(XLL_DOUBLEX, _T("nu"), _T("is the degree of freedom of the Chi-squared."))
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return Chi-squared random deviates using a random number generator."))
 	.Documentation(_T(""))
@@ -18,6 +20,7 @@ static AddInX xai_ran_chisq(
 double WINAPI xll_ran_chisq(HANDLEX rng, double nu)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex x;
 
 	try {
@@ -25,10 +28,12 @@ double WINAPI xll_ran_chisq(HANDLEX rng, double nu)
 			nu = 1;
 
 		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 
 		x = gsl_ran_chisq(*r, nu);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -46,6 +51,7 @@ static AddInX xai_ran_chisq_pdf(
 double WINAPI xll_ran_chisq_pdf(double x, double nu)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (nu == 0)
 		nu = 1;
 
@@ -63,6 +69,7 @@ static AddInX xai_cdf_chisq_P(
 double WINAPI xll_cdf_chisq_P(double x, double nu)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (nu == 0)
 		nu = 1;
 
@@ -80,6 +87,7 @@ static AddInX xai_cdf_chisq_Pinv(
 double WINAPI xll_cdf_chisq_Pinv(double p, double nu)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (nu == 0)
 		nu = 1;
 
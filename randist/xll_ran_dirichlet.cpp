@@ -4,15 +4,17 @@
 #include "../xll_randist.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_dirichlet(
 	FunctionX(XLL_FPX, _T("?xll_ran_dirichlet"), _T("GSL.RAN.DIRICHLET"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
 	
 	.Arg(XLL_FPX, _T("alpha"), _T("is an array of concentration parameters."))
 	
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return dirichlet random deviates using a random number generator."))
 	.Documentation(_T(""))
@@ -22,16 +24,20 @@ xfpx* WINAPI xll_ran_dirichlet(HANDLEX rng, xfpx*alpha)
 {
 	
 #pragma XLLEXPORT
-	static FPX theta;
+	XLL_PROFILE;
+	static thread_local FPX theta;
 	try {
 
 		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 
+		theta.resize(alpha->rows, alpha->columns);
 		gsl_ran_dirichlet(*r, size(*alpha),alpha->array, theta.begin());
 	
 	}
 	
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 	return theta.get();
@@ -53,6 +59,7 @@ static AddInX xai_ran_dirichlet_pdf(
 double WINAPI xll_ran_dirichlet_pdf( xfpx*alpha, xfpx*theta){
 
 #pragma XLLEXPORT
+	XLL_PROFILE;
 
 
 
@@ -2,6 +2,7 @@
 #include "xll_ran_discrete.h"
 #include "../xll_rng.h"
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
@@ -16,6 +17,7 @@ static AddInX xai_ran_discrete_preproc(
 HANDLEX WINAPI xll_ran_discrete_preproc(xfpx* pp)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	handlex h;
 
 	try {
@@ -24,6 +26,7 @@ HANDLEX WINAPI xll_ran_discrete_preproc(xfpx* pp)
 		h = h_.get();
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -32,9 +35,10 @@ HANDLEX WINAPI xll_ran_discrete_preproc(xfpx* pp)
 
 static AddInX xai_ran_discrete(
 	FunctionX(XLL_WORDX, _T("?xll_ran_discrete"), _T("GSL.RAN.DISCRETE"))
-	.Arg(XLL_HANDLEX, _T("Rng"), _T("is a handle returned by GSL.RAN"))
+	.Arg(XLL_HANDLEX, _T("Rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL"))
 	.Arg(XLL_HANDLEX, _T("Discrete"), _T("is a handle returned by GSL.RAN.DISCRETE.PREPROC"))
 	.Volatile()
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return a random value k with probability p[k]."))
 	.Documentation(_T(""))
@@ -42,15 +46,18 @@ static AddInX xai_ran_discrete(
 WORD WINAPI xll_ran_discrete(HANDLEX rng, HANDLEX discrete)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	WORD k = static_cast<WORD>(-1);
 
 	try {
 		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 		handle<gsl::ran_discrete> g(discrete);
 
 		k = static_cast<WORD>(gsl_ran_discrete(*r, *g));
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -67,6 +74,7 @@ static AddInX xai_ran_discrete_pdf(
 double WINAPI xll_ran_discrete_pdf(WORD k, HANDLEX disc)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	handle<gsl::ran_discrete> d(disc);
 
 	return gsl_ran_discrete_pdf(k, *d);
@@ -4,13 +4,15 @@
 #include "../xll_randist.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_exponential(
 	FunctionX(XLL_DOUBLE, _T("?xll_ran_exponential"),_T("GSL.RAN.EXPONENTIAL"))
-	.Arg(XLL_HANDLEX, _T("rng"),_T("is a handle returned by GSL.RNG"))
+	.Arg(XLL_HANDLEX, _T("rng"),_T("is a handle returned by GSL.RNG or GSL.RNG.POOL"))
 	.Arg(XLL_DOUBLEX, _T("mu"), _T("is the mean of the exponential distribution"))
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return exponential random deviates using a random number generator."))
 	.Documentation(_T(""))
@@ -18,16 +20,19 @@ static AddInX xai_ran_exponential(
 double WINAPI xll_ran_exponential(HANDLEX rng, double mu)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex x;
 
 	try {
 		
 
 		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 
 		x = gsl_ran_exponential(*r, mu);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -45,6 +50,7 @@ static AddInX xai_ran_exponential_pdf(
 double WINAPI xll_ran_exponential_pdf(double x, double mu)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	
 
 	return gsl_ran_exponential_pdf(x, mu);
@@ -61,6 +67,7 @@ static AddInX xai_cdf_exponential_P(
 double WINAPI xll_cdf_exponential_P(double x, double mu)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	
 
 	return gsl_cdf_exponential_P(x, mu);
@@ -77,6 +84,7 @@ static AddInX xai_cdf_exponential_Pinv(
 double WINAPI xll_cdf_exponential_Pinv(double p, double mu)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	
 
 	return gsl_cdf_exponential_Pinv(p, mu);
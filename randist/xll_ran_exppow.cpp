@@ -4,14 +4,16 @@
 #include "../xll_randist.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_exppow(
 	FunctionX(XLL_DOUBLEX, _T("?xll_ran_exppow"), _T("GSL.RAN.EXPPOW"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
 	.Arg(XLL_DOUBLEX, _T("a"), _T("is the scale parameter of the Exppow. Default is 1"), 1.0)
 	.Arg(XLL_DOUBLEX, _T("b"), _T("is the exponent of the Exppow. Default is 1"), 1.0)
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return Exponential Power random deviates using a random number generator."))
 	.Documentation(_T(""))
@@ -19,15 +21,18 @@ static AddInX xai_ran_exppow(
 double WINAPI xll_ran_exppow(HANDLEX rng, double a, double b)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex x;
 
 	try {
 
 		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 
 		x = gsl_ran_exppow(*r, a, b);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -46,6 +51,7 @@ static AddInX xai_ran_exppow_pdf(
 double WINAPI xll_ran_exppow_pdf(double x, double a, double b)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	
 
 	return gsl_ran_exppow_pdf(x, a, b);
@@ -63,6 +69,7 @@ static AddInX xai_cdf_exppow_P(
 double WINAPI xll_cdf_exppow_P(double x, double a, double b)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 
 
 	return gsl_cdf_exppow_P(x, a, b);
@@ -3,14 +3,16 @@
 #include "../xll_randist.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_fdist(
 	FunctionX(XLL_DOUBLEX, _T("?xll_ran_fdist"), _T("GSL.RAN.FDIST"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
 	.Arg(XLL_DOUBLEX, _T("d_1"), _T("is the first parameter of the F-distribution"), 1.0)
 	.Arg(XLL_DOUBLEX, _T("d_2"), _T("is the second parameter of the F-distribution"), 1.0)
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return F-distribution random deviates using a random number generator."))
 	.Documentation(_T(""))
@@ -18,6 +20,7 @@ static AddInX xai_ran_fdist(
 double WINAPI xll_ran_fdist(HANDLEX rng, double d_1, double d_2)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex x;
 
 	try {
@@ -26,10 +29,12 @@ double WINAPI xll_ran_fdist(HANDLEX rng, double d_1, double d_2)
 		if (d_2 <= 0)
 			d_2 = 1;
 		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 
 		x = gsl_ran_fdist(*r, d_1, d_2);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -49,6 +54,7 @@ static AddInX xai_ran_fdist_pdf(
 double WINAPI xll_ran_fdist_pdf(double x, double d_1, double d_2)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (d_1 <= 0)
 		d_1 = 1;
 	if (d_2 <= 0)
@@ -68,6 +74,7 @@ static AddInX xai_cdf_fdist_P(
 double WINAPI xll_cdf_fdist_P(double x, double d_1, double d_2)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (d_1 <= 0)
 		d_1 = 1;
 	if (d_2 <= 0)
@@ -87,6 +94,7 @@ static AddInX xai_cdf_fdist_Pinv(
 double WINAPI xll_cdf_fdist_Pinv(double p, double d_1, double d_2)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (d_1 <= 0)
 		d_1 = 1;
 	if (d_2 <= 0)
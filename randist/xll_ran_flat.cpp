@@ -4,14 +4,16 @@
 #include "../xll_randist.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_flat(
 	FunctionX(XLL_DOUBLEX, _T("?xll_ran_flat"), _T("GSL.RAN.FLAT"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
 	.Arg(XLL_DOUBLEX, _T("a"), _T("is the lower bound of the uniformly distributed random variate."))
 	.Arg(XLL_DOUBLEX, _T("b"), _T("is the upper bound of the uniformly distributed random variate."))
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return a uniform random variate using a random number generator."))
 	.Documentation(_T(""))
@@ -19,16 +21,19 @@ static AddInX xai_ran_flat(
 double WINAPI xll_ran_flat(HANDLEX rng, double a, double b)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex x;
 
 	try {
 
 		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 
 		x = gsl_ran_flat(*r, a, b);
 	}
 
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -47,6 +52,7 @@ static AddInX xai_ran_flat_pdf(
 double WINAPI xll_ran_flat_pdf(double x, double a, double b)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 
 	return gsl_ran_flat_pdf(x, a, b);
 }
@@ -63,6 +69,7 @@ static AddInX xai_cdf_flat_P(
 double WINAPI xll_cdf_flat_P(double x, double a, double b)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 
 	return gsl_cdf_flat_P(x, a, b);
 }
@@ -79,6 +86,7 @@ static AddInX xai_cdf_flat_Pinv(
 double WINAPI xll_cdf_flat_Pinv(double p, double a, double b)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 
 	return gsl_cdf_flat_Pinv(p, a, b);
 }
@@ -12,14 +12,16 @@
 #include "../xll_randist.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_gamma(
 	FunctionX(XLL_DOUBLEX, _T("?xll_ran_gamma"), _T("GSL.RAN.GAMMA"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
 	.Arg(XLL_DOUBLEX, _T("k"), _T("shape parameter of Gamma distribution, should be above zero, default value is 1.0"), 1.0)
 	.Arg(XLL_DOUBLEX, _T("theta"), _T("scale parameter of Gamma distribution, should be above zero, default value is 1.0"), 1.0)
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return instance of Gamma distribution using a random number generator."))
 	.Documentation(_T(""))
@@ -27,6 +29,7 @@ static AddInX xai_ran_gamma(
 double WINAPI xll_ran_gamma(HANDLEX rng, double k, double theta)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex x;
 
 	try {
@@ -35,10 +38,12 @@ double WINAPI xll_ran_gamma(HANDLEX rng, double k, double theta)
 		if (theta <= 0)
 			theta = 1;
 		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 
 		x = gsl_ran_gamma(*r, k,theta);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -57,6 +62,7 @@ static AddInX xai_ran_gamma_pdf(
 double WINAPI xll_ran_gamma_pdf(double x, double k, double theta)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (k <= 0)
 		k = 1.0;
 	if (theta <= 0)
@@ -77,6 +83,7 @@ static AddInX xai_cdf_gamma_P(
 double WINAPI xll_cdf_gamma_P(double x, double k, double theta)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (k <= 0)
 		k = 1.0;
 	if (theta <= 0)
@@ -97,6 +104,7 @@ static AddInX xai_cdf_gamma_Pinv(
 double WINAPI xll_cdf_gamma_Pinv(double p, double k, double theta)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (k <= 0)
 		k = 1.0;
 	if (theta <= 0)
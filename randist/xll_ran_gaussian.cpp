@@ -2,16 +2,19 @@
 // http://www.gnu.org/software/gsl/manual/html_node/The-Gaussian-Distribution.html#The-Gaussian-Distribution
 #include "../xll_rng.h"
 #include "../xll_randist.h"
+#include "../xll_ziggurat.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_gaussian(
 	FunctionX(XLL_DOUBLEX, _T("?xll_ran_gaussian"), _T("GSL.RAN.GAUSSIAN"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
 	.Arg(XLL_DOUBLEX, _T("sigma"), _T("is the standard deviation of the Gaussian. Default is 1"), 1.0)
 	.Volatile()
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return Gaussian/normal random deviates using a random number generator."))
 	.Documentation(_T(""))
@@ -19,6 +22,7 @@ static AddInX xai_ran_gaussian(
 double WINAPI xll_ran_gaussian(HANDLEX rng, double sigma)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex x;
 
 	try {
@@ -26,16 +30,70 @@ double WINAPI xll_ran_gaussian(HANDLEX rng, double sigma)
 			sigma = 1;
 
 		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 
 		x = gsl_ran_gaussian(*r, sigma);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
 	return x;
 }
 
+// build the ziggurat tables before the first recalculation
+static int xll_ziggurat_open(void)
+{
+	gsl::ziggurat::instance();
+
+	return 1;
+}
+static Auto<Open> xao_ziggurat_open(xll_ziggurat_open);
+
+static AddInX xai_ran_gaussian_array(
+	FunctionX(XLL_FPX, _T("?xll_ran_gaussian_array"), _T("GSL.RAN.GAUSSIAN.ARRAY"))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
+	.Arg(XLL_WORDX, _T("Rows"), _T("is the number of rows to return."))
+	.Arg(XLL_WORDX, _T("Columns"), _T("is the number of columns to return. Default is 1"))
+	.Arg(XLL_DOUBLEX, _T("sigma"), _T("is the standard deviation of the Gaussian. Default is 1"))
+	.Volatile()
+	.ThreadSafe()
+	.Category(_T("GSL"))
+	.FunctionHelp(_T("Return an array of Gaussian/normal random deviates using the ziggurat method."))
+	.Documentation(
+		_T("Uses a 256 layer ziggurat that needs one uniform per value most of the time ")
+		_T("instead of the two uniforms, logarithm and square root per pair of the polar method used by GSL.RAN.GAUSSIAN. ")
+		_T("Values are filled in row major order. ")
+	)
+);
+xfpx* WINAPI xll_ran_gaussian_array(HANDLEX rng, WORD rows, WORD columns, double sigma)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	static thread_local FPX x;
+
+	try {
+		ensure (rows > 0 || !"GSL.RAN.GAUSSIAN.ARRAY: Rows must be positive");
+		if (sigma == 0)
+			sigma = 1;
+
+		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
+
+		x.resize(rows, columns ? columns : 1);
+		gsl::ran_gaussian(*r, x.size(), x.array(), sigma);
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+
+		return 0;
+	}
+
+	return x.get();
+}
+
 static AddInX xai_ran_gaussian_pdf(
 	FunctionX(XLL_DOUBLEX, _T("?xll_ran_gaussian_pdf"), _T("GSL.DIST.GAUSSIAN.PDF"))
 	.Arg(XLL_HANDLEX, _T("x"), _T("is the value at which to calculate the density function."))
@@ -47,6 +105,7 @@ static AddInX xai_ran_gaussian_pdf(
 double WINAPI xll_ran_gaussian_pdf(double x, double sigma)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (sigma == 0)
 		sigma = 1;
 
@@ -64,6 +123,7 @@ static AddInX xai_cdf_gaussian_P(
 double WINAPI xll_cdf_gaussian_P(double x, double sigma)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (sigma == 0)
 		sigma = 1;
 
@@ -81,6 +141,7 @@ static AddInX xai_cdf_gaussian_Pinv(
 double WINAPI xll_cdf_gaussian_Pinv(double p, double sigma)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (sigma == 0)
 		sigma = 1;
 
@@ -89,6 +150,8 @@ double WINAPI xll_cdf_gaussian_Pinv(double p, double sigma)
 
 XLL_TEST_BEGIN(xll_ran_gaussian)
 
+test_gsl_ziggurat();
+
 double eps = 1e-6;
 
 // http://www.wolframalpha.com/input/?i=Table%5BPDF%5BNormalDistribution%5B0%2C1%5D%2C+x%5D%2C%7Bx%2C+-2%2C+2%2C+.1%7D%5D
@@ -6,14 +6,16 @@
 #include "../xll_randist.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_gaussian_tail(
 	FunctionX(XLL_DOUBLEX, _T("?xll_ran_gaussian_tail"), _T("GSL.RAN.GAUSSIAN_TAIL"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
 	.Arg(XLL_DOUBLEX, _T("a"), _T("is the lower limit of the Gaussian Tail, which must be positive"))
 	.Arg(XLL_DOUBLEX, _T("sigma"), _T("is the standard deviation of the Gaussian Tail. Default is 1"), 1.0)
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return Gaussian Tail random deviates using a random number generator. The values returned are larger than the lower limit"))
 	.Documentation(_T(""))
@@ -21,6 +23,7 @@ static AddInX xai_ran_gaussian_tail(
 double WINAPI xll_ran_gaussian_tail(HANDLEX rng, double a, double sigma)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex x;
 
 	try {
@@ -28,10 +31,12 @@ double WINAPI xll_ran_gaussian_tail(HANDLEX rng, double a, double sigma)
 			sigma = 1;
 
 		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 
 		x = gsl_ran_gaussian_tail(*r, a, sigma);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -50,6 +55,7 @@ static AddInX xai_ran_gaussian_tail_pdf(
 double WINAPI xll_ran_gaussian_tail_pdf(double x, double a, double sigma)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (sigma == 0)
 		sigma = 1;
 
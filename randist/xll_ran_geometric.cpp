@@ -6,14 +6,16 @@
 #include "../xll_randist.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_geometric(
 	FunctionX(XLL_USHORTX, _T("?xll_ran_geometric"), _T("GSL.RAN.GEOMETRIC"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
 	//.Arg(XLL_DOUBLEX, _T("sigma"), _T("is the standard deviation of the Gaussian. Default is 1"), 1.0)
 	.Arg(XLL_DOUBLEX, _T("p"), _T("is the probability of success. Should be within [0,1]"))
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	//.FunctionHelp(_T("Return Gaussian/normal random deviates using a random number generator."))
 	.FunctionHelp(_T("Return a random integer from the geometric distribution."))
@@ -22,15 +24,18 @@ static AddInX xai_ran_geometric(
 unsigned int WINAPI xll_ran_geometric(HANDLEX rng, double p)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	unsigned int x=0;
 
 	try {
 
 		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 
 		x = gsl_ran_geometric(*r, p);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -48,6 +53,7 @@ static AddInX xai_ran_geometric_pdf(
 double WINAPI xll_ran_geometric_pdf(unsigned int k, double p)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 
 	return gsl_ran_geometric_pdf(k, p);
 }
@@ -66,6 +72,7 @@ static AddInX xai_cdf_geometric_P(
 double WINAPI xll_cdf_geometric_P(unsigned int k, double p)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 
 	return gsl_cdf_geometric_P(k, p);
 }
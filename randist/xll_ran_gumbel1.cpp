@@ -4,14 +4,16 @@
 #include "../xll_randist.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_gumbel1(
 	FunctionX(XLL_DOUBLEX, _T("?xll_ran_gumbel1"), _T("GSL.RAN.GUMBEL1"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
 	.Arg(XLL_DOUBLEX, _T("a"), _T("is the parameter a. Default is 1"), 1.0)
 	.Arg(XLL_DOUBLEX, _T("b"), _T("is the parameter b. Default is 1"), 1.0)
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return Type-1 Gumbel random variable using a random number generator and two parameters."))
 	.Documentation(_T(""))
@@ -19,6 +21,7 @@ static AddInX xai_ran_gumbel1(
 double WINAPI xll_ran_gumbel1(HANDLEX rng, double a, double b)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex x;
 
 	try {
@@ -29,10 +32,12 @@ double WINAPI xll_ran_gumbel1(HANDLEX rng, double a, double b)
 			b = 1;
 
 		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 
 		x = gsl_ran_gumbel1(*r, a, b);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -51,6 +56,7 @@ static AddInX xai_ran_gumbel1_pdf(
 double WINAPI xll_ran_gumbel1_pdf(double x, double a, double b)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 
 	if (a == 0)
 		a = 1;
@@ -72,6 +78,7 @@ static AddInX xai_cdf_gumbel1_P(
 double WINAPI xll_cdf_gumbel1_P(double x, double a, double b)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 
 	if (a == 0)
 		a = 1;
@@ -93,6 +100,7 @@ static AddInX xai_cdf_gumbel1_Pinv(
 double WINAPI xll_cdf_gumbel1_Pinv(double p, double a, double b)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 
 	if (a == 0)
 		a = 1;
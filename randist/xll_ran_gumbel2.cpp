@@ -4,14 +4,16 @@
 #include "../xll_randist.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_gumbel2(
 	FunctionX(XLL_DOUBLEX, _T("?xll_ran_gumbel2"), _T("GSL.RAN.GUMBEL2"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
 	.Arg(XLL_DOUBLEX, _T("a"), _T("is the parameter a. Default is 1"), 1.0)
 	.Arg(XLL_DOUBLEX, _T("b"), _T("is the parameter b. Default is 1"), 1.0)
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return Gumbel2 random deviates using a random number generator."))
 	.Documentation(_T(""))
@@ -19,15 +21,18 @@ static AddInX xai_ran_gumbel2(
 double WINAPI xll_ran_gumbel2(HANDLEX rng, double a, double b)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex x;
 
 	try {
 
 		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 
 		x = gsl_ran_gumbel2(*r, a, b);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -46,6 +51,7 @@ static AddInX xai_ran_gumbel2_pdf(
 double WINAPI xll_ran_gumbel2_pdf(double x, double a, double b)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 
 	return gsl_ran_gumbel2_pdf(x, a, b);
 }
@@ -62,6 +68,7 @@ static AddInX xai_cdf_gumbel2_P(
 double WINAPI xll_cdf_gumbel2_P(double x, double a, double b)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 
 	return gsl_cdf_gumbel2_P(x, a, b);
 }
@@ -78,6 +85,7 @@ static AddInX xai_cdf_gumbel2_Pinv(
 double WINAPI xll_cdf_gumbel2_Pinv(double p, double a, double b)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 
 	return gsl_cdf_gumbel2_Pinv(p, a, b);
 }
@@ -94,6 +102,7 @@ static AddInX xai_cdf_gumbel2_Q(
 double WINAPI xll_cdf_gumbel2_Q(double x, double a, double b)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 
 	return gsl_cdf_gumbel2_Q(x, a, b);
 }
@@ -110,6 +119,7 @@ static AddInX xai_cdf_gumbel2_Qinv(
 double WINAPI xll_cdf_gumbel2_Qinv(double p, double a, double b)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 
 	return gsl_cdf_gumbel2_Qinv(p, a, b);
 }
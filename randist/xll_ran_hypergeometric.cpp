@@ -4,16 +4,18 @@
 #include "../xll_randist.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 
 using namespace xll;
 
 static AddInX xai_ran_hypergeometric(
 	FunctionX(XLL_DOUBLEX, _T("?xll_ran_hypergeometric"), _T("GSL.RAN.HYPERGEOMETRIC"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
 	.Arg(XLL_DOUBLEX, _T("n1"), _T("is the standard deviation of the HYPERGEOMETRIC. Default is 1"), 1)
 	.Arg(XLL_DOUBLEX, _T("n2"), _T("is the standard deviation of the HYPERGEOMETRIC. Default is 1"), 1)
 	.Arg(XLL_DOUBLEX, _T("t"), _T("is the standard deviation of the HYPERGEOMETRIC. Default is 1"), 1)
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return Hypergeometric random deviates using a random number generator."))
 	.Documentation(_T(""))
@@ -21,16 +23,19 @@ static AddInX xai_ran_hypergeometric(
 double WINAPI xll_ran_hypergeometric(HANDLEX rng, unsigned int n1, unsigned int n2, unsigned int t)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex x;
 
 	try {
 		
 
 	    handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 
 		x = gsl_ran_hypergeometric(*r, n1, n2, t);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -50,6 +55,7 @@ static AddInX xai_ran_hypergeometric_pdf(
 double WINAPI xll_ran_hypergeometric_pdf(unsigned int x, unsigned int n1, unsigned int n2, unsigned int t)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	
 	return gsl_ran_hypergeometric_pdf(x, n1, n2, t);
 }
@@ -67,6 +73,7 @@ static AddInX xai_cdf_hypergeometric_P(
 double WINAPI xll_cdf_hypergeometric_P(unsigned int x, unsigned int n1, unsigned int n2, unsigned int t)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	
 	return gsl_cdf_hypergeometric_P(x,n1,n2,t);
 }
@@ -4,12 +4,14 @@
 #include "../xll_randist.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_landau(
 	FunctionX(XLL_DOUBLEX, _T("?xll_ran_landau"), _T("GSL.RAN.LANDAU"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return random deviates from Landau distribution using a random number generator."))
 	.Documentation(_T(""))
@@ -17,14 +19,17 @@ static AddInX xai_ran_landau(
 double WINAPI xll_ran_landau(HANDLEX rng)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex x;
 
 	try {
 		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 
 		x = gsl_ran_landau(*r);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -41,6 +46,7 @@ static AddInX xai_ran_landau_pdf(
 double WINAPI xll_ran_landau_pdf(double x)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 
 	return gsl_ran_landau_pdf(x);
 }
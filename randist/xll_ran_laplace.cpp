@@ -4,13 +4,15 @@
 #include "../xll_randist.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_laplace(
 	FunctionX(XLL_DOUBLEX, _T("?xll_ran_laplace"), _T("GSL.RAN.LAPLACE"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
 	.Arg(XLL_DOUBLEX, _T("a"), _T("is the width of the Laplace. Default is 1"), 1.0)
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return Laplace random deviates using a random number generator."))
 	.Documentation(_T(""))
@@ -18,6 +20,7 @@ static AddInX xai_ran_laplace(
 double WINAPI xll_ran_laplace(HANDLEX rng, double a)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex x;
 
 	try {
@@ -25,10 +28,12 @@ double WINAPI xll_ran_laplace(HANDLEX rng, double a)
 			a = 1;
 
 		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 
 		x = gsl_ran_laplace(*r, a);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -46,6 +51,7 @@ static AddInX xai_ran_laplace_pdf(
 double WINAPI xll_ran_laplace_pdf(double x, double a)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (a == 0)
 		a = 1;
 
@@ -63,6 +69,7 @@ static AddInX xai_cdf_laplace_P(
 double WINAPI xll_cdf_laplace_P(double x, double a)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (a == 0)
 		a = 1;
 
@@ -80,6 +87,7 @@ static AddInX xai_cdf_laplace_Pinv(
 double WINAPI xll_cdf_laplace_Pinv(double p, double a)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (a == 0)
 		a = 1;
 
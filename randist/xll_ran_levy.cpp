@@ -4,14 +4,16 @@
 #include "../xll_randist.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_levy(
 	FunctionX(XLL_DOUBLEX, _T("?xll_ran_levy"), _T("GSL.RAN.LEVY"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
 	.Arg(XLL_DOUBLEX, _T("c"), _T("is the scale of the Levy."))
 	.Arg(XLL_DOUBLEX, _T("alpha"), _T("is the exponent of the Levy."))
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return levy random deviates using a random number generator."))
 	.Documentation(_T(""))
@@ -19,16 +21,19 @@ static AddInX xai_ran_levy(
 double WINAPI xll_ran_levy(HANDLEX rng, double c,double alpha)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex x;
 
 	try {
 		
 
 		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 
 		x = gsl_ran_levy(*r, c, alpha);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
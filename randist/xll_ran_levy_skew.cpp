@@ -4,15 +4,17 @@
 #include "../xll_randist.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_levy_skew(
 	FunctionX(XLL_DOUBLEX, _T("?xll_ran_levy_skew"), _T("GSL.RAN.LEVY.SKEW"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
 	.Arg(XLL_DOUBLEX, _T("c"), _T("is the scale. Default is 1"), 1.0)
 	.Arg(XLL_DOUBLEX, _T("alpha"), _T("is the exponent parameter. Default is 2"), 2.0)
 	.Arg(XLL_DOUBLEX, _T("beta"), _T("is the skewness. Default is 1"), 1.0)
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return Stable random deviates using a random number generator."))
 	.Documentation(_T(""))
@@ -20,6 +22,7 @@ static AddInX xai_ran_levy_skew(
 double WINAPI xll_ran_levy_skew(HANDLEX rng, double c, double alpha, double beta)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex x;
 
 	try {
@@ -27,10 +30,12 @@ double WINAPI xll_ran_levy_skew(HANDLEX rng, double c, double alpha, double beta
 			alpha = 2;
 
 		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 
 		x = gsl_ran_levy_skew(*r, c, alpha, beta);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -2,14 +2,16 @@
 #include "../xll_rng.h"
 #include "../xll_randist.h"
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_logarithmic(
 	FunctionX(XLL_DOUBLEX, _T("?xll_ran_logarithmic"), _T("GSL.RAN.LOGARITHMIC"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
 	.Arg(XLL_DOUBLEX, _T("p"), _T("is the parameter p."))
 	.Volatile()
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return Logarithmic random deviates using a random number generator."))
 	.Documentation(_T(""))
@@ -17,6 +19,7 @@ static AddInX xai_ran_logarithmic(
 unsigned int WINAPI xll_ran_logarithmic(HANDLEX rng, double p)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	unsigned int k = 1;
 
 	try {
@@ -27,10 +30,12 @@ unsigned int WINAPI xll_ran_logarithmic(HANDLEX rng, double p)
 			p = 1;
 		}
 		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 
 		k = gsl_ran_logarithmic(*r, p);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -48,6 +53,7 @@ static AddInX xai_ran_logarithmic_pdf(
 double WINAPI xll_ran_logarithmic_pdf(unsigned int k, double p)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 
 	if (p < 0) {
 		p = 0;
@@ -1,13 +1,15 @@
 #include "../xll_rng.h"
 #include "../xll_randist.h"
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_logistic(
 	FunctionX(XLL_DOUBLEX, _T("?xll_ran_logistic"), _T("GSL.RAN.LOGISTIC"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
 	.Arg(XLL_DOUBLEX, _T("a"), _T("is the scale parameter of logistic. Default is 1"), 1.0)
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return logistic random deviates using a random number generator."))
 	.Documentation(_T(""))
@@ -15,6 +17,7 @@ static AddInX xai_ran_logistic(
 double WINAPI xll_ran_logistic(HANDLEX rng, double a)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex x;
 
 	try {
@@ -22,10 +25,12 @@ double WINAPI xll_ran_logistic(HANDLEX rng, double a)
 			a = 1;
 
 		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 
 		x = gsl_ran_logistic(*r, a);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -43,6 +48,7 @@ static AddInX xai_ran_logistic_pdf(
 double WINAPI xll_ran_logistic_pdf(double x, double a)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (a == 0)
 		a = 1;
 
@@ -60,6 +66,7 @@ static AddInX xai_cdf_logistic_P(
 double WINAPI xll_cdf_logistic_P(double x, double a)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (a == 0)
 		a = 1;
 
@@ -77,6 +84,7 @@ static AddInX xai_cdf_logistic_Q(
 double WINAPI xll_cdf_logistic_Q(double x, double a)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (a == 0)
 		a = 1;
 
@@ -94,6 +102,7 @@ static AddInX xai_cdf_logistic_Pinv(
 double WINAPI xll_cdf_logistic_Pinv(double p, double a)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (a == 0)
 		a = 1;
 
@@ -111,6 +120,7 @@ static AddInX xai_cdf_logistic_Qinv(
 double WINAPI xll_cdf_logistic_Qinv(double q, double a)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (a == 0)
 		a = 1;
 
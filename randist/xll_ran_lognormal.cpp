@@ -4,14 +4,16 @@
 #include "../xll_randist.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_lognormal(
 	FunctionX(XLL_DOUBLEX, _T("?xll_ran_lognormal"), _T("GSL.RAN.LOGNORMAL"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
 	.Arg(XLL_DOUBLEX, _T("zeta"), _T("is the mean of the lognormal. Default is 0"), 0.0)
 	.Arg(XLL_DOUBLEX, _T("sigma"), _T("is the standard deviation of the lognormal. Default is 1"), 1.0)
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return lognormal random deviates using a random number generator."))
 	.Documentation(_T(""))
@@ -19,16 +21,19 @@ static AddInX xai_ran_lognormal(
 double WINAPI xll_ran_lognormal(HANDLEX rng, double zeta, double sigma)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex x;
 
 	try {
 		if (sigma == 0)
 			sigma = 1;
 		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 
 		x = gsl_ran_lognormal(*r, zeta, sigma);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -47,6 +52,7 @@ static AddInX xai_ran_lognormal_pdf(
 double WINAPI xll_ran_lognormal_pdf(double x,double zeta, double sigma)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (sigma == 0)
 		sigma = 1;
 	return gsl_ran_lognormal_pdf(x, zeta, sigma);
@@ -64,6 +70,7 @@ static AddInX xai_cdf_lognormal_P(
 double WINAPI xll_cdf_lognormal_P(double x, double zeta, double sigma)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (sigma == 0)
 		sigma = 1;
 	return gsl_cdf_lognormal_P(x, zeta, sigma);
@@ -81,6 +88,7 @@ static AddInX xai_cdf_lognormal_Pinv(
 double WINAPI xll_cdf_lognormal_Pinv(double p, double zeta, double sigma)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (sigma == 0)
 		sigma = 1;
 
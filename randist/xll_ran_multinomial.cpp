@@ -4,15 +4,17 @@
 #include "../xll_randist.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_multinomial(
 	FunctionX(XLL_FPX, _T("?xll_ran_multinomial"), _T("GSL.RAN.MULTINOMIAL"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
 	.Arg(XLL_WORDX,_T("N"),_T("is the sum of n"))
 	.Arg(XLL_FPX, _T("p"), _T("is the probability of each event"))
 	.Arg(XLL_FPX, _T("n"), _T("is the frequency of each event"))
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return multinomial random deviates using a random number generator."))
 	.Documentation(R_(
@@ -26,6 +28,7 @@ static AddInX xai_ran_multinomial(
 void WINAPI xll_ran_multinomial(HANDLEX rng, WORD N, xfpx* p, xfpx* n)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex x;
 
 	try {
@@ -33,6 +36,7 @@ void WINAPI xll_ran_multinomial(HANDLEX rng, WORD N, xfpx* p, xfpx* n)
 		ensure (K == size(*n));
 
 		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 
 		std::vector<unsigned> n_(K);
 		std::transform(begin(*n), end(*n), n_.begin(), [](double x) { return static_cast<unsigned>(x); });
@@ -40,6 +44,7 @@ void WINAPI xll_ran_multinomial(HANDLEX rng, WORD N, xfpx* p, xfpx* n)
 		gsl_ran_multinomial(*r, K, N, p->array, n_.data());
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -58,6 +63,7 @@ static AddInX xai_ran_multinomial_pdf(
 double WINAPI xll_ran_multinomial_pdf(size_t K, const double p[], const unsigned int n[])
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	/*if (sigma == 0)
 		sigma = 1;*/
 
@@ -78,6 +84,7 @@ double WINAPI xll_ran_multinomial_pdf(size_t K, const double p[], const unsigned
 double WINAPI xll_cdf_multinomial_P(size_t K, const double p[], const unsigned int n[])
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	/*if (sigma == 0)
 		sigma = 1;
 return gsl_cdf_multinomial_P( K, p, n);
@@ -94,6 +101,7 @@ return gsl_cdf_multinomial_P( K, p, n);
 double WINAPI xll_cdf_multinomial_Pinv(size_t K, const double p[], const unsigned int n[])
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	/*if (sigma == 0)
 		sigma = 1;
 
@@ -5,15 +5,17 @@
 #include "../xll_randist.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_negative_binomial(
 	FunctionX(XLL_DOUBLEX, _T("?xll_ran_negative_binomial"), _T("GSL.RAN.NEGATIVE.BINOMIAL"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
 	.Arg(XLL_DOUBLEX, _T("p"), _T("is the probability of success. "))
 	.Arg(XLL_DOUBLEX, _T("n"), _T("is the number of successes. "))
 	.Volatile()
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return Negative-binomial deviates using a random number generator."))
 	.Documentation(R_(
@@ -27,15 +29,18 @@ static AddInX xai_ran_negative_binomial(
 double WINAPI xll_ran_negative_binomial(HANDLEX rng, double p, double n)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex x;
 
 	try {
 
 		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 
 		x = gsl_ran_negative_binomial(*r, p,n);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -56,6 +61,7 @@ static AddInX xai_ran_negative_binomial_pdf(
 double WINAPI xll_ran_negative_binomial_pdf(WORD k, double p, double n)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 
 	return gsl_ran_negative_binomial_pdf(k, p, n);
 }
@@ -72,6 +78,7 @@ static AddInX xai_cdf_negative_binomial_P(
 double WINAPI xll_cdf_negative_binomial_P(WORD k, double p, double n)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 
 	return gsl_cdf_negative_binomial_P(k, p, n);
 }
@@ -4,14 +4,16 @@
 #include "../xll_randist.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_pareto(
 	FunctionX(XLL_DOUBLEX, _T("?xll_ran_pareto"), _T("GSL.RAN.PARETO"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
 	.Arg(XLL_DOUBLEX, _T("a"), _T("is the exponent the Pareto. Default is 0"), 0.0)
 	.Arg(XLL_DOUBLEX, _T("b"), _T("is the scale of the Pareto. Default is 1"), 1.0)
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return Pareto random deviates using a random number generator."))
 	.Documentation(_T(""))
@@ -19,6 +21,7 @@ static AddInX xai_ran_pareto(
 double WINAPI xll_ran_pareto(HANDLEX rng, double a, double b)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex x;
 
 	try {
@@ -26,10 +29,12 @@ double WINAPI xll_ran_pareto(HANDLEX rng, double a, double b)
 			b = 1;
 
 		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 
 		x = gsl_ran_pareto(*r, a, b);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -48,6 +53,7 @@ static AddInX xai_ran_pareto_pdf(
 double WINAPI xll_ran_pareto_pdf(double x, double a, double b)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (b == 0)
 		b = 1;
 
@@ -66,6 +72,7 @@ static AddInX xai_cdf_pareto_P(
 double WINAPI xll_cdf_pareto_P(double x, double a, double b)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (b == 0)
 		b = 1;
 
@@ -84,6 +91,7 @@ static AddInX xai_cdf_pareto_Pinv(
 double WINAPI xll_cdf_pareto_Pinv(double p, double a, double b)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (b == 0)
 		b = 1;
 
@@ -6,14 +6,16 @@
 #include "../xll_randist.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_pascal(
 	FunctionX(XLL_USHORTX, _T("?xll_ran_pascal"), _T("GSL.RAN.PASCAL"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
 	.Arg(XLL_DOUBLEX, _T("p"), _T("is the probability of success. It is between 0 and 1."))
 	.Arg(XLL_USHORTX, _T("n"), _T("is the number of trial. It is a positve integer."))
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return Pascal random deviates using a random number generator."))
 	.Documentation(_T(""))
@@ -21,9 +23,11 @@ static AddInX xai_ran_pascal(
 unsigned int WINAPI xll_ran_pascal(HANDLEX rng, double p, unsigned int n)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	unsigned int x;
 
 	handle<gsl::rng> r(rng);
+	auto lock = r->lock();
 	x = gsl_ran_pascal(*r, p, n);
 
 	return x;
@@ -41,6 +45,7 @@ static AddInX xai_ran_pascal_pdf(
 double WINAPI xll_ran_pascal_pdf(unsigned int x, double p, unsigned int n)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 
 	return gsl_ran_pascal_pdf(x-n, p, n);
 }
@@ -57,6 +62,7 @@ static AddInX xai_cdf_pascal_P(
 double WINAPI xll_cdf_pascal_P(unsigned int x, double p, unsigned int n)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 
 
 	return gsl_cdf_pascal_P(x-n, p, n);
@@ -4,13 +4,15 @@
 #include "../xll_randist.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_poisson(
 	FunctionX(XLL_DOUBLEX, _T("?xll_ran_poisson"), _T("GSL.RAN.POISSON"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
 	.Arg(XLL_DOUBLEX, _T("mu"), _T("is the mean of the Poisson."))
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return Poisson random deviates using a random number generator."))
 	.Documentation(_T(""))
@@ -18,15 +20,18 @@ static AddInX xai_ran_poisson(
 unsigned int WINAPI xll_ran_poisson(HANDLEX rng, double mu)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex x;
 
 	try {
 
 		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 
 		x = gsl_ran_poisson(*r, mu);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -44,6 +49,7 @@ static AddInX xai_ran_poisson_pdf(
 double WINAPI xll_ran_poisson_pdf(unsigned int k, double mu)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 
 	return gsl_ran_poisson_pdf(k, mu); 
 }
@@ -59,6 +65,7 @@ static AddInX xai_cdf_poisson_P(
 double WINAPI xll_cdf_poisson_P(unsigned int k, double mu)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 
 
 	return gsl_cdf_poisson_P(k, mu);
@@ -4,13 +4,15 @@
 #include "../xll_randist.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_rayleigh(
 	FunctionX(XLL_DOUBLEX, _T("?xll_ran_rayleigh"), _T("GSL.RAN.RAYLEIGH"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
 	.Arg(XLL_DOUBLEX, _T("sigma"), _T("is the sigma of the Rayleigh Distribution. Default is 1"), 1.0)
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return Rayleigh random deviates using a random number generator."))
 	.Documentation(_T(""))
@@ -18,6 +20,7 @@ static AddInX xai_ran_rayleigh(
 double WINAPI xll_ran_rayleigh(HANDLEX rng, double sigma)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex x;
 
 	try {
@@ -25,10 +28,12 @@ double WINAPI xll_ran_rayleigh(HANDLEX rng, double sigma)
 			sigma = 1;
 
 		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 
 		x = gsl_ran_rayleigh(*r, sigma);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -46,6 +51,7 @@ static AddInX xai_ran_rayleigh_pdf(
 double WINAPI xll_ran_rayleigh_pdf(double x, double sigma)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (sigma == 0)
 		sigma = 1;
 
@@ -63,6 +69,7 @@ static AddInX xai_cdf_rayleigh_P(
 double WINAPI xll_cdf_rayleigh_P(double x, double sigma)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (sigma == 0)
 		sigma = 1;
 
@@ -80,6 +87,7 @@ static AddInX xai_cdf_rayleigh_Pinv(
 double WINAPI xll_cdf_rayleigh_Pinv(double p, double sigma)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (sigma == 0)
 		sigma = 1;
 
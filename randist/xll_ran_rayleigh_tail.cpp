@@ -4,14 +4,16 @@
 #include "../xll_randist.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_rayleigh_tail(
 	FunctionX(XLL_DOUBLEX, _T("?xll_ran_rayleigh_tail"), _T("GSL.RAN.rayleightail"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
 	.Arg(XLL_DOUBLEX, _T("a"), _T("is the lower limit of rayleightail. Default is 0"), 0.0)
 	.Arg(XLL_DOUBLEX, _T("sigma"), _T("is the standard deviation of the rayleightail. Default is 1"), 1.0)
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return rayleightail random deviates using a random number generator."))
 	.Documentation(_T(""))
@@ -19,6 +21,7 @@ static AddInX xai_ran_rayleigh_tail(
 double WINAPI xll_ran_rayleigh_tail(HANDLEX rng, double a, double sigma)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex x;
 	try {
 		if (sigma == 0)
@@ -26,9 +29,11 @@ double WINAPI xll_ran_rayleigh_tail(HANDLEX rng, double a, double sigma)
 		if (a == 0)
 			a = 0;
 		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 		x = gsl_ran_rayleigh_tail(*r, a, sigma);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 	return x;
@@ -46,6 +51,7 @@ static AddInX xai_ran_rayleigh_tail_pdf(
 double WINAPI xll_ran_rayleigh_tail_pdf(double x, double a, double sigma)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (sigma == 0)
 		sigma = 1;
 
@@ -4,14 +4,16 @@
 #include "../xll_randist.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "../xll_profile.h"
 
 using namespace xll;
 
 static AddInX xai_ran_weibull(
 	FunctionX(XLL_DOUBLEX, _T("?xll_ran_weibull"), _T("GSL.RAN.WEIBULL"))
-	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG or GSL.RNG.POOL."))
 	.Arg(XLL_DOUBLEX, _T("a"), _T("is a scale"))
 	.Arg(XLL_DOUBLEX,_T("b"),_T("is a exponent"))
+	.ThreadSafe()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return weilbull random deviates using a random number generator."))
 	.Documentation(_T(""))
@@ -20,14 +22,17 @@ static AddInX xai_ran_weibull(
 double WINAPI xll_ran_weibull(HANDLEX rng, double a, double b)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex x;
 
 	try {
 		handle<gsl::rng> r(rng);
+		auto lock = r->lock();
 
 		x = gsl_ran_weibull(*r, a, b);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -46,6 +51,7 @@ static AddInX xai_ran_weibull_pdf(
 double WINAPI xll_ran_weibull_pdf(double x, double a, double b)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 
 	return gsl_ran_weibull_pdf(x, a, b);
 }
@@ -62,6 +68,7 @@ static AddInX xai_cdf_weibull_P(
 double WINAPI xll_cdf_weibull_P(double x, double a, double b)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	return gsl_cdf_weibull_P(x, a,b);
 }
 
@@ -77,6 +84,7 @@ static AddInX xai_cdf_weibull_Pinv(
 double WINAPI xll_cdf_weibull_Pinv(double p, double a, double b)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 
 	return gsl_cdf_weibull_Pinv(p, a, b);
 }
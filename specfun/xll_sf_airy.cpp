@@ -30,6 +30,7 @@ static AddInX xai_xll_sf_airy_Ai(
 double WINAPI xll_sf_airy_Ai(double x, WORD prec)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	gsl_sf_result result;
 
 	try {
@@ -38,6 +39,7 @@ double WINAPI xll_sf_airy_Ai(double x, WORD prec)
 			throw std::runtime_error(gsl_strerror(status));
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -57,6 +59,7 @@ static AddInX xai_xll_sf_airy_Ai_deriv(
 double WINAPI xll_sf_airy_Ai_deriv(double x, WORD prec)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	gsl_sf_result result;
 
 	try {
@@ -65,6 +68,7 @@ double WINAPI xll_sf_airy_Ai_deriv(double x, WORD prec)
 			throw std::runtime_error(gsl_strerror(status));
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -86,6 +90,7 @@ static AddInX xai_xll_sf_airy_zero_Ai(
 double WINAPI xll_sf_airy_zero_Ai(WORD s)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	gsl_sf_result result;
 
 	try {
@@ -94,6 +99,7 @@ double WINAPI xll_sf_airy_zero_Ai(WORD s)
 			throw std::runtime_error(gsl_strerror(status));
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
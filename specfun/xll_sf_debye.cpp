@@ -30,6 +30,7 @@ static AddInX xai_xll_sf_debye(
 double WINAPI xll_sf_debye(double x)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	gsl_sf_result result;
 
 	try {
@@ -38,6 +39,7 @@ double WINAPI xll_sf_debye(double x)
 			throw std::runtime_error(gsl_strerror(status));
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -26,6 +26,7 @@ static AddInX xai_gsl_sf_erf(
 double WINAPI xll_sf_erf(double x)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	gsl_sf_result result;
 
 	try {
@@ -34,6 +35,7 @@ double WINAPI xll_sf_erf(double x)
 			throw std::runtime_error(gsl_strerror(status));
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -29,6 +29,7 @@ static AddInX xai_xll_sf_expint_En(
 double WINAPI xll_sf_expint_En(WORD n,double x)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	gsl_sf_result result;
 
 	try {
@@ -37,6 +38,7 @@ double WINAPI xll_sf_expint_En(WORD n,double x)
 			throw std::runtime_error(gsl_strerror(status));
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -31,6 +31,7 @@ static AddInX xai_xll_sf_lambert_W0(
 double WINAPI xll_sf_lambert_W0(double x)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	gsl_sf_result result;
 
 	try {
@@ -39,6 +40,7 @@ double WINAPI xll_sf_lambert_W0(double x)
 			throw std::runtime_error(gsl_strerror(status));
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
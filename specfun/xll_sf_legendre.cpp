@@ -28,6 +28,7 @@ static AddInX xai_sf_legendre_p(
 double WINAPI xll_sf_legendre_p (WORD n, double x)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	gsl_sf_result result;
 
 	try {
@@ -36,6 +37,7 @@ double WINAPI xll_sf_legendre_p (WORD n, double x)
 			throw std::runtime_error(gsl_strerror(status));
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
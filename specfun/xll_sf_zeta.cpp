@@ -25,6 +25,7 @@ static AddInX xai_xll_sf_zeta(
 double WINAPI xll_sf_zeta(double x)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	gsl_sf_result result;
 
 	try {
@@ -33,6 +34,7 @@ double WINAPI xll_sf_zeta(double x)
 			throw std::runtime_error(gsl_strerror(status));
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -2,6 +2,7 @@
 // Include appropriate header files below.
 #include "xll_bachelier.h"
 #include "xll/xll.h"
+#include "xll_profile.h"
 
 using namespace xll;
 
@@ -17,12 +18,14 @@ static AddIn xai_bachelier_put(
 double WINAPI xll_bachelier_put(double f, double sigma, double k,double t)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex value;
 
 	try {
 		return bachelier_put(f, sigma, k, t);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
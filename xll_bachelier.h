@@ -18,7 +18,7 @@
 // and d = (f - k)/(sigma sqrt(t)).
 
 // Implement using gsl_ran_gaussian_pdf and gsl_cdf_gaussian_P.
-double bachelier_put(double f, double sigma, double k, double t)
+inline double bachelier_put(double f, double sigma, double k, double t)
 {
 	ensure (f > 0);
 	ensure (sigma > 0);
@@ -0,0 +1,126 @@
+// xll_base64.h - RFC 4648 base64 encoding of binary blobs
+#pragma once
+#include <stdexcept>
+#include <string>
+
+namespace xll {
+
+	namespace base64 {
+
+		inline const char* alphabet()
+		{
+			return "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+		}
+
+		// padded with '='
+		inline std::string encode(const std::string& s)
+		{
+			const char* a = alphabet();
+			std::string t;
+			t.reserve(4*((s.size() + 2)/3));
+
+			size_t i = 0;
+			for (; i + 2 < s.size(); i += 3) {
+				unsigned long u = (static_cast<unsigned char>(s[i]) << 16)
+					| (static_cast<unsigned char>(s[i + 1]) << 8)
+					| static_cast<unsigned char>(s[i + 2]);
+				t += a[(u >> 18) & 63];
+				t += a[(u >> 12) & 63];
+				t += a[(u >> 6) & 63];
+				t += a[u & 63];
+			}
+			if (i < s.size()) {
+				unsigned long u = static_cast<unsigned char>(s[i]) << 16;
+				if (i + 1 < s.size())
+					u |= static_cast<unsigned char>(s[i + 1]) << 8;
+				t += a[(u >> 18) & 63];
+				t += a[(u >> 12) & 63];
+				t += i + 1 < s.size() ? a[(u >> 6) & 63] : '=';
+				t += '=';
+			}
+
+			return t;
+		}
+
+		// whitespace is ignored
+		inline std::string decode(const std::string& t)
+		{
+			std::string s;
+			s.reserve(3*(t.size()/4));
+
+			unsigned long u = 0;
+			int n = 0, pad = 0;
+			for (char c : t) {
+				int d;
+				if (c >= 'A' && c <= 'Z')
+					d = c - 'A';
+				else if (c >= 'a' && c <= 'z')
+					d = c - 'a' + 26;
+				else if (c >= '0' && c <= '9')
+					d = c - '0' + 52;
+				else if (c == '+')
+					d = 62;
+				else if (c == '/')
+					d = 63;
+				else if (c == '=') {
+					++pad;
+					d = 0;
+				}
+				else if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+					continue;
+				else
+					throw std::invalid_argument(__FILE__ ": " __FUNCTION__ ": invalid base64 character");
+
+				if (pad && c != '=')
+					throw std::invalid_argument(__FILE__ ": " __FUNCTION__ ": data after base64 padding");
+
+				u = (u << 6) | d;
+				if (++n == 4) {
+					s += static_cast<char>((u >> 16) & 0xFF);
+					if (pad < 2)
+						s += static_cast<char>((u >> 8) & 0xFF);
+					if (pad < 1)
+						s += static_cast<char>(u & 0xFF);
+					u = 0;
+					n = 0;
+				}
+			}
+			if (n != 0 || pad > 2)
+				throw std::invalid_argument(__FILE__ ": " __FUNCTION__ ": base64 length must be a multiple of 4");
+
+			return s;
+		}
+
+	} // base64
+
+} // xll
+
+#ifdef _DEBUG
+#include <cassert>
+
+inline void test_xll_base64()
+{
+	using namespace xll::base64;
+
+	// RFC 4648 section 10
+	const char* s[] = {"", "f", "fo", "foo", "foob", "fooba", "foobar"};
+	const char* t[] = {"", "Zg==", "Zm8=", "Zm9v", "Zm9vYg==", "Zm9vYmE=", "Zm9vYmFy"};
+	for (int i = 0; i < 7; ++i) {
+		assert (encode(s[i]) == t[i]);
+		assert (decode(t[i]) == s[i]);
+	}
+
+	std::string b;
+	for (int i = 0; i < 256; ++i)
+		b += static_cast<char>(i);
+	assert (decode(encode(b)) == b);
+
+	try {
+		decode("Zm9");
+		assert (false);
+	}
+	catch (const std::invalid_argument&) {
+	}
+}
+
+#endif // _DEBUG
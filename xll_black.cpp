@@ -4,6 +4,7 @@
 #include "xll_roots.h"
 #include "xll_black.h"
 #include "xll/xll.h"
+#include "xll_profile.h"
 
 using namespace xll;
 
@@ -20,12 +21,14 @@ static AddInX xai_black_put_value(
 double WINAPI xll_black_put_value(double f, double sigma, double k, double t)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex v;
 
 	try {
 		v = black_put_value(f, sigma, k, t);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -44,12 +47,14 @@ static AddInX xai_black_put_delta(
 double WINAPI xll_black_put_delta(double f, double sigma, double k, double t)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex v;
 
 	try {
 		v = black_put_delta(f, sigma, k, t);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -67,12 +72,14 @@ static AddInX xai_black_vega(
 double WINAPI xll_black_vega(double f, double sigma, double k, double t)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex v;
 
 	try {
 		v = black_vega(f, sigma, k, t);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -89,6 +96,7 @@ static AddInX xai_corrado_miller_implied_volatility(
 double WINAPI xll_corrado_miller_implied_volatility(double f, double p, double k, double t)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex sigma;
 
 	try {
@@ -96,6 +104,7 @@ double WINAPI xll_corrado_miller_implied_volatility(double f, double p, double k
 		sigma = corrado_miller_implied_volatility<double>(f, v, k, t);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -111,12 +120,14 @@ static AddInX xai_black_put_implied_volatility(
 double WINAPI xll_black_put_implied_volatility(double f, double p, double k, double t)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex v;
 
 	try {
 		v = black_put_implied_volatility(f, p, k, t);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -136,12 +147,14 @@ static AddInX xai_bms_put_value(
 double WINAPI xll_bms_put_value(double r, double s, double sigma, double k, double t)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex v;
 
 	try {
 		v = bms_put_value(r, s, sigma, k, t);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -162,12 +175,14 @@ static AddInX xai_bms_put_delta(
 double WINAPI xll_bms_put_delta(double r, double s, double sigma, double k, double t)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex v;
 
 	try {
 		v = bms_put_delta(r, s, sigma, k, t);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -0,0 +1,514 @@
+// xll_cbrng.h - counter based random number generators as gsl_rng_types
+// Salmon, Moraes, Dror, Shaw "Parallel random numbers: as easy as 1, 2, 3" SC11
+// http://www.thesalmons.org/john/random123/
+#pragma once
+#include <cstdint>
+#include <stdexcept>
+#include "gsl/gsl_rng.h"
+
+namespace gsl {
+
+namespace cbrng {
+
+	// Philox4x32-10 on W blocks at once stored as structure of arrays
+	// The lanes are independent so compilers can vectorize the loops.
+	template<size_t W>
+	inline void philox4x32(const std::uint32_t (&ctr)[4][W], const std::uint32_t (&key)[2], std::uint32_t (&out)[4][W])
+	{
+		const std::uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+		const std::uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+		std::uint32_t k0 = key[0], k1 = key[1];
+
+		for (size_t j = 0; j < W; ++j)
+			for (size_t i = 0; i < 4; ++i)
+				out[i][j] = ctr[i][j];
+
+		for (int r = 0; r < 10; ++r) {
+			for (size_t j = 0; j < W; ++j) {
+				std::uint64_t p0 = static_cast<std::uint64_t>(M0)*out[0][j];
+				std::uint64_t p1 = static_cast<std::uint64_t>(M1)*out[2][j];
+				std::uint32_t x1 = out[1][j], x3 = out[3][j];
+
+				out[0][j] = static_cast<std::uint32_t>(p1 >> 32)^x1^k0;
+				out[1][j] = static_cast<std::uint32_t>(p1);
+				out[2][j] = static_cast<std::uint32_t>(p0 >> 32)^x3^k1;
+				out[3][j] = static_cast<std::uint32_t>(p0);
+			}
+			k0 += W0;
+			k1 += W1;
+		}
+	}
+	// one block
+	inline void philox4x32(const std::uint32_t (&ctr)[4], const std::uint32_t (&key)[2], std::uint32_t (&out)[4])
+	{
+		std::uint32_t c[4][1] = {{ctr[0]}, {ctr[1]}, {ctr[2]}, {ctr[3]}}, o[4][1];
+
+		philox4x32<1>(c, key, o);
+		for (size_t i = 0; i < 4; ++i)
+			out[i] = o[i][0];
+	}
+
+	// Threefry4x64-20 on W blocks at once stored as structure of arrays
+	template<size_t W>
+	inline void threefry4x64(const std::uint64_t (&ctr)[4][W], const std::uint64_t (&key)[4], std::uint64_t (&out)[4][W])
+	{
+		static const unsigned R[8][2] = {{14, 16}, {52, 57}, {23, 40}, {5, 37}, {25, 33}, {46, 12}, {58, 22}, {32, 32}};
+		auto rotl = [](std::uint64_t x, unsigned n) { return (x << n) | (x >> (64 - n)); };
+
+		std::uint64_t ks[5] = {key[0], key[1], key[2], key[3], 0x1BD11BDAA9FC1A22ULL^key[0]^key[1]^key[2]^key[3]};
+
+		for (size_t j = 0; j < W; ++j)
+			for (size_t i = 0; i < 4; ++i)
+				out[i][j] = ctr[i][j] + ks[i];
+
+		for (unsigned r = 0; r < 20; ++r) {
+			const unsigned* Rr = R[r%8];
+			for (size_t j = 0; j < W; ++j) {
+				std::uint64_t x0 = out[0][j], x1 = out[1][j], x2 = out[2][j], x3 = out[3][j];
+
+				if (r%2 == 0) {
+					x0 += x1; x1 = rotl(x1, Rr[0]); x1 ^= x0;
+					x2 += x3; x3 = rotl(x3, Rr[1]); x3 ^= x2;
+				}
+				else {
+					x0 += x3; x3 = rotl(x3, Rr[0]); x3 ^= x0;
+					x2 += x1; x1 = rotl(x1, Rr[1]); x1 ^= x2;
+				}
+				// key injection every four rounds
+				if (r%4 == 3) {
+					unsigned s = (r + 1)/4;
+					x0 += ks[s%5];
+					x1 += ks[(s + 1)%5];
+					x2 += ks[(s + 2)%5];
+					x3 += ks[(s + 3)%5] + s;
+				}
+
+				out[0][j] = x0;
+				out[1][j] = x1;
+				out[2][j] = x2;
+				out[3][j] = x3;
+			}
+		}
+	}
+	// one block
+	inline void threefry4x64(const std::uint64_t (&ctr)[4], const std::uint64_t (&key)[4], std::uint64_t (&out)[4])
+	{
+		std::uint64_t c[4][1] = {{ctr[0]}, {ctr[1]}, {ctr[2]}, {ctr[3]}}, o[4][1];
+
+		threefry4x64<1>(c, key, o);
+		for (size_t i = 0; i < 4; ++i)
+			out[i] = o[i][0];
+	}
+
+	// Outputs are 32 bit words numbered by position within a stream.
+	// Block b of stream s is the counter {b, s} under a 64 bit key, so any
+	// (key, stream, position) can be reached in O(1) without shared state.
+	struct philox {
+		enum : size_t { outputs = 4 };
+
+		static void block(std::uint64_t key, std::uint64_t stream, std::uint64_t b, std::uint32_t* out)
+		{
+			std::uint32_t c[4] = {static_cast<std::uint32_t>(b), static_cast<std::uint32_t>(b >> 32),
+				static_cast<std::uint32_t>(stream), static_cast<std::uint32_t>(stream >> 32)};
+			std::uint32_t k[2] = {static_cast<std::uint32_t>(key), static_cast<std::uint32_t>(key >> 32)};
+			std::uint32_t o[4];
+
+			philox4x32(c, k, o);
+			for (size_t i = 0; i < 4; ++i)
+				out[i] = o[i];
+		}
+		static const char* name()
+		{
+			return "philox4x32";
+		}
+	};
+	struct threefry {
+		enum : size_t { outputs = 8 };
+
+		static void block(std::uint64_t key, std::uint64_t stream, std::uint64_t b, std::uint32_t* out)
+		{
+			std::uint64_t c[4] = {b, stream, 0, 0}, k[4] = {key, 0, 0, 0}, o[4];
+
+			threefry4x64(c, k, o);
+			for (size_t i = 0; i < 4; ++i) {
+				out[2*i] = static_cast<std::uint32_t>(o[i]);
+				out[2*i + 1] = static_cast<std::uint32_t>(o[i] >> 32);
+			}
+		}
+		static const char* name()
+		{
+			return "threefry4x64";
+		}
+	};
+
+	// gsl_rng state for engine E
+	template<class E>
+	struct state {
+		std::uint64_t key, stream;
+		std::uint64_t next;  // next block to generate
+		unsigned n;          // next unused output in out, E::outputs if none
+		std::uint32_t out[E::outputs];
+
+		// move to absolute position p in the stream
+		void seek(std::uint64_t p)
+		{
+			next = p/E::outputs;
+			n = E::outputs;
+			unsigned i = static_cast<unsigned>(p%E::outputs);
+			if (i) {
+				E::block(key, stream, next++, out);
+				n = i;
+			}
+		}
+		std::uint64_t position() const
+		{
+			return next*E::outputs - (E::outputs - n);
+		}
+
+		static void set(void* vs, unsigned long seed)
+		{
+			state& s = *static_cast<state*>(vs);
+
+			s.key = seed;
+			s.stream = 0;
+			s.seek(0);
+		}
+		static unsigned long get(void* vs)
+		{
+			state& s = *static_cast<state*>(vs);
+
+			if (s.n == E::outputs) {
+				E::block(s.key, s.stream, s.next++, s.out);
+				s.n = 0;
+			}
+
+			return s.out[s.n++];
+		}
+		static double get_double(void* vs)
+		{
+			return get(vs)/4294967296.0;
+		}
+
+		static const gsl_rng_type* type()
+		{
+			static const gsl_rng_type t = {E::name(), 0xFFFFFFFFUL, 0, sizeof(state), &set, &get, &get_double};
+
+			return &t;
+		}
+	};
+
+	inline const gsl_rng_type* philox4x32_type()
+	{
+		return state<philox>::type();
+	}
+	inline const gsl_rng_type* threefry4x64_type()
+	{
+		return state<threefry>::type();
+	}
+
+	// true if r is a counter based generator from this file
+	inline bool is_counter(const gsl_rng* r)
+	{
+		return r->type == philox4x32_type() || r->type == threefry4x64_type();
+	}
+
+	namespace detail {
+		template<class F>
+		inline void visit(const gsl_rng* r, F f)
+		{
+			if (r->type == philox4x32_type())
+				f(*static_cast<state<philox>*>(r->state));
+			else if (r->type == threefry4x64_type())
+				f(*static_cast<state<threefry>*>(r->state));
+			else
+				throw std::invalid_argument(__FILE__ ": " __FUNCTION__ ": not a counter based generator");
+		}
+	}
+
+	// independent stream for each (key, stream) pair starting at position
+	inline void set(const gsl_rng* r, std::uint64_t key, std::uint64_t stream, std::uint64_t position = 0)
+	{
+		detail::visit(r, [=](auto& s) {
+			s.key = key;
+			s.stream = stream;
+			s.seek(position);
+		});
+	}
+	// skip the next n outputs in O(1)
+	inline void discard(const gsl_rng* r, std::uint64_t n)
+	{
+		detail::visit(r, [=](auto& s) {
+			s.seek(s.position() + n);
+		});
+	}
+	// number of outputs generated since the start of the stream
+	inline std::uint64_t position(const gsl_rng* r)
+	{
+		std::uint64_t p = 0;
+
+		detail::visit(r, [&p](const auto& s) {
+			p = s.position();
+		});
+
+		return p;
+	}
+
+	// fill x with outputs position, ..., position + n - 1 of Philox stream (key, stream)
+	// Eight outputs are generated at a time from two blocks in parallel lanes.
+	inline void philox_fill(std::uint64_t key, std::uint64_t stream, std::uint64_t position, size_t n, std::uint32_t* x)
+	{
+		enum : size_t { W = 2 };
+		std::uint32_t k[2] = {static_cast<std::uint32_t>(key), static_cast<std::uint32_t>(key >> 32)};
+		std::uint32_t buf[4];
+		std::uint64_t b = position/4;
+
+		// partial leading block
+		size_t i = static_cast<size_t>(position%4);
+		if (i) {
+			philox::block(key, stream, b++, buf);
+			for (; i < 4 && n; ++i, --n)
+				*x++ = buf[i];
+		}
+
+		std::uint32_t c[4][W], o[4][W];
+		for (size_t j = 0; j < W; ++j) {
+			c[2][j] = static_cast<std::uint32_t>(stream);
+			c[3][j] = static_cast<std::uint32_t>(stream >> 32);
+		}
+		for (; n >= 4*W; n -= 4*W, b += W) {
+			for (size_t j = 0; j < W; ++j) {
+				c[0][j] = static_cast<std::uint32_t>(b + j);
+				c[1][j] = static_cast<std::uint32_t>((b + j) >> 32);
+			}
+			philox4x32<W>(c, k, o);
+			for (size_t j = 0; j < W; ++j)
+				for (size_t i = 0; i < 4; ++i)
+					*x++ = o[i][j];
+		}
+
+		// trailing blocks
+		while (n) {
+			philox::block(key, stream, b++, buf);
+			for (size_t i = 0; i < 4 && n; ++i, --n)
+				*x++ = buf[i];
+		}
+	}
+	// fill x with outputs position, ..., position + n - 1 of Threefry stream (key, stream)
+	// Sixteen outputs are generated at a time from two blocks in parallel lanes.
+	inline void threefry_fill(std::uint64_t key, std::uint64_t stream, std::uint64_t position, size_t n, std::uint32_t* x)
+	{
+		enum : size_t { W = 2 };
+		std::uint64_t k[4] = {key, 0, 0, 0};
+		std::uint32_t buf[8];
+		std::uint64_t b = position/8;
+
+		// partial leading block
+		size_t i = static_cast<size_t>(position%8);
+		if (i) {
+			threefry::block(key, stream, b++, buf);
+			for (; i < 8 && n; ++i, --n)
+				*x++ = buf[i];
+		}
+
+		std::uint64_t c[4][W], o[4][W];
+		for (size_t j = 0; j < W; ++j) {
+			c[1][j] = stream;
+			c[2][j] = 0;
+			c[3][j] = 0;
+		}
+		for (; n >= 8*W; n -= 8*W, b += W) {
+			for (size_t j = 0; j < W; ++j)
+				c[0][j] = b + j;
+			threefry4x64<W>(c, k, o);
+			for (size_t j = 0; j < W; ++j) {
+				for (size_t i = 0; i < 4; ++i) {
+					*x++ = static_cast<std::uint32_t>(o[i][j]);
+					*x++ = static_cast<std::uint32_t>(o[i][j] >> 32);
+				}
+			}
+		}
+
+		// trailing blocks
+		while (n) {
+			threefry::block(key, stream, b++, buf);
+			for (size_t i = 0; i < 8 && n; ++i, --n)
+				*x++ = buf[i];
+		}
+	}
+
+	// Bulk draws from the current position of r that leave r where n calls to gsl_rng_get would.
+	// They return false if r is not a counter based generator.
+	inline bool get(const gsl_rng* r, size_t n, std::uint32_t* x)
+	{
+		if (r->type == philox4x32_type()) {
+			state<philox>& s = *static_cast<state<philox>*>(r->state);
+			std::uint64_t p = s.position();
+			philox_fill(s.key, s.stream, p, n, x);
+			s.seek(p + n);
+
+			return true;
+		}
+		if (r->type == threefry4x64_type()) {
+			state<threefry>& s = *static_cast<state<threefry>*>(r->state);
+			std::uint64_t p = s.position();
+			threefry_fill(s.key, s.stream, p, n, x);
+			s.seek(p + n);
+
+			return true;
+		}
+
+		return false;
+	}
+	template<class T>
+	inline bool get(const gsl_rng* r, size_t n, T* x)
+	{
+		if (!is_counter(r))
+			return false;
+
+		std::uint32_t u[256];
+		while (n) {
+			size_t m = n < 256 ? n : 256;
+			get(r, m, u);
+			for (size_t i = 0; i < m; ++i)
+				x[i] = static_cast<T>(u[i]);
+			x += m;
+			n -= m;
+		}
+
+		return true;
+	}
+	// same values as gsl_rng_uniform
+	inline bool uniform(const gsl_rng* r, size_t n, double* x)
+	{
+		if (!is_counter(r))
+			return false;
+
+		std::uint32_t u[256];
+		while (n) {
+			size_t m = n < 256 ? n : 256;
+			get(r, m, u);
+			for (size_t i = 0; i < m; ++i)
+				x[i] = u[i]/4294967296.0;
+			x += m;
+			n -= m;
+		}
+
+		return true;
+	}
+
+} // cbrng
+
+} // gsl
+
+#ifdef _DEBUG
+#include <cassert>
+#include <vector>
+
+// known answers from the Random123 distribution
+inline void test_gsl_cbrng()
+{
+	using namespace gsl::cbrng;
+	{
+		std::uint32_t c[4] = {0, 0, 0, 0}, k[2] = {0, 0}, o[4];
+		philox4x32(c, k, o);
+		assert (o[0] == 0x6627e8d5 && o[1] == 0xe169c58d && o[2] == 0xbc57ac4c && o[3] == 0x9b00dbd8);
+	}
+	{
+		std::uint32_t c[4] = {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, k[2] = {0xffffffff, 0xffffffff}, o[4];
+		philox4x32(c, k, o);
+		assert (o[0] == 0x408f276d && o[1] == 0x41c83b0e && o[2] == 0xa20bc7c6 && o[3] == 0x6d5451fd);
+	}
+	{
+		std::uint32_t c[4] = {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, k[2] = {0xa4093822, 0x299f31d0}, o[4];
+		philox4x32(c, k, o);
+		assert (o[0] == 0xd16cfe09 && o[1] == 0x94fdcceb && o[2] == 0x5001e420 && o[3] == 0x24126ea1);
+	}
+	{
+		std::uint64_t c[4] = {0, 0, 0, 0}, k[4] = {0, 0, 0, 0}, o[4];
+		threefry4x64(c, k, o);
+		assert (o[0] == 0x09218ebde6c85537ULL && o[1] == 0x55941f5266d86105ULL);
+		assert (o[2] == 0x4bd25e16282434dcULL && o[3] == 0xee29ec846bd2e40bULL);
+	}
+	{
+		std::uint64_t c[4] = {~0ULL, ~0ULL, ~0ULL, ~0ULL}, k[4] = {~0ULL, ~0ULL, ~0ULL, ~0ULL}, o[4];
+		threefry4x64(c, k, o);
+		assert (o[0] == 0x29c24097942bba1bULL && o[1] == 0x0371bbfb0f6f4e11ULL);
+		assert (o[2] == 0x3c231ffa33f83a1cULL && o[3] == 0xcd29113fde32d168ULL);
+	}
+
+	for (const gsl_rng_type* T : {philox4x32_type(), threefry4x64_type()}) {
+		gsl_rng* r = gsl_rng_alloc(T);
+		gsl_rng* s = gsl_rng_alloc(T);
+
+		set(r, 123, 7);
+		std::vector<unsigned long> x(100);
+		for (auto& xi : x)
+			xi = gsl_rng_get(r);
+		assert (position(r) == 100);
+
+		// skip ahead lands on the same values
+		for (std::uint64_t p : {0, 1, 3, 4, 9, 16, 17, 99}) {
+			set(s, 123, 7, p);
+			assert (gsl_rng_get(s) == x[p]);
+			set(s, 123, 7);
+			discard(s, p);
+			assert (gsl_rng_get(s) == x[p]);
+		}
+
+		// different streams differ
+		set(s, 123, 8);
+		assert (gsl_rng_get(s) != x[0]);
+
+		gsl_rng_free(s);
+		gsl_rng_free(r);
+	}
+
+	{
+		gsl_rng* r = gsl_rng_alloc(philox4x32_type());
+		for (std::uint64_t p : {0, 1, 2, 5}) {
+			std::vector<std::uint32_t> y(37);
+			philox_fill(99, 3, p, y.size(), y.data());
+			set(r, 99, 3, p);
+			for (auto yi : y)
+				assert (yi == gsl_rng_get(r));
+		}
+		gsl_rng_free(r);
+	}
+	{
+		gsl_rng* r = gsl_rng_alloc(threefry4x64_type());
+		for (std::uint64_t p : {0, 1, 7, 8, 13}) {
+			std::vector<std::uint32_t> y(53);
+			threefry_fill(99, 3, p, y.size(), y.data());
+			set(r, 99, 3, p);
+			for (auto yi : y)
+				assert (yi == gsl_rng_get(r));
+		}
+		gsl_rng_free(r);
+	}
+
+	// bulk draws match single draws and leave the generator in the same place
+	for (const gsl_rng_type* T : {philox4x32_type(), threefry4x64_type()}) {
+		gsl_rng* r = gsl_rng_alloc(T);
+		gsl_rng* s = gsl_rng_alloc(T);
+		set(r, 5, 1);
+		set(s, 5, 1);
+
+		for (size_t n : {0, 1, 3, 17, 300}) {
+			std::vector<std::uint32_t> y(n);
+			std::vector<double> u(n);
+			assert (get(r, n, y.data()));
+			for (auto yi : y)
+				assert (yi == gsl_rng_get(s));
+			assert (uniform(r, n, u.data()));
+			for (auto ui : u)
+				assert (ui == gsl_rng_uniform(s));
+			assert (position(r) == position(s));
+		}
+		assert (gsl_rng_get(r) == gsl_rng_get(s));
+
+		gsl_rng_free(s);
+		gsl_rng_free(r);
+	}
+}
+
+#endif // _DEBUG
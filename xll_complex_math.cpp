@@ -30,6 +30,7 @@ xfpx* WINAPI
 xll_complex_polar(double r, double theta)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	static fpx_complex z;
 
 	z = gsl_complex_polar(r, theta);
@@ -50,6 +51,7 @@ xfpx* WINAPI
 xll_complex_rect(double x, double y)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	static fpx_complex z;
 
 	z = gsl_complex_rect(x, y);
@@ -70,7 +72,9 @@ double WINAPI
 xll_complex_arg(const xfpx* pz)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (size(*pz) != 2) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR("COMPLEX.ARG: the argument must be an array of the real and imaginary parts of a complex number.");
 	}
 
@@ -89,7 +93,9 @@ double WINAPI
 xll_complex_abs(xfpx* pz)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (size(*pz) != 2) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR("COMPLEX.ABS: the argument must be an array of the real and imaginary parts of a complex number.");
 	}
 
@@ -108,7 +114,9 @@ double WINAPI
 xll_complex_abs2(xfpx* pz)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (size(*pz) != 2) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR("COMPLEX.ABS2: the argument must be an array of the real and imaginary parts of a complex number.");
 	}
 
@@ -127,7 +135,9 @@ double WINAPI
 xll_complex_logabs(xfpx* pz)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	if (size(*pz) != 2) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR("COMPLEX.LOGABS: the argument must be an array of the real and imaginary parts of a complex number.");
 	}
 
@@ -147,9 +157,11 @@ xfpx* WINAPI
 xll_complex_add(xfpx* px, xfpx* py)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	static fpx_complex z;
 
 	if (size(*px) != 2) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR("COMPLEX.ADD: the first argument must be an array of the real and imaginary parts of a complex number.");
 
 		return 0;
@@ -175,9 +187,11 @@ xfpx* WINAPI
 xll_complex_sub(xfpx* px, xfpx* py)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	static fpx_complex z;
 
 	if (size(*px) != 2) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR("COMPLEX.SUB: the first argument must be an array of the real and imaginary parts of a complex number.");
 
 		return 0;
@@ -203,9 +217,11 @@ xfpx* WINAPI
 xll_complex_mul(xfpx* px, xfpx* py)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	static fpx_complex z;
 
 	if (size(*px) != 2) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR("COMPLEX.MUL: the first argument must be an array of the real and imaginary parts of a complex number.");
 
 		return 0;
@@ -231,9 +247,11 @@ xfpx* WINAPI
 xll_complex_div(xfpx* px, xfpx* py)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	static fpx_complex z;
 
 	if (size(*px) != 2) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR("COMPLEX.DIV: the first argument must be an array of the real and imaginary parts of a complex number.");
 
 		return 0;
@@ -260,9 +278,11 @@ xfpx* WINAPI
 xll_complex_pow(xfpx* px, xfpx* py)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	static fpx_complex z;
 
 	if (size(*px) != 2) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR("COMPLEX.POW: the first argument must be an array of the real and imaginary parts of a complex number.");
 
 		return 0;
@@ -309,7 +329,9 @@ static AddInX xai_complex_congjugate(
 extern "C" __declspec(dllexport) 
 xfpx* xll_complex_conjugate(xfpx* pz)
 {
+	XLL_PROFILE;
 	if (size(*pz) != 2) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR("COMPLEX.CONJUGATE" ARG_ERR);
 
 		return 0;
@@ -322,7 +344,8 @@ xfpx* xll_complex_conjugate(xfpx* pz)
 #define COMPLEX_UNARY(f, F, FH, D) static AddInX xai_ ## f(FunctionX(XLL_FPX, _T(ENSURE_STRZ_(xll_ ## f)), _T(F)) \
 	.Arg(XLL_FPX, _T("Arg"), IS_COMPLEX).Category(CATEGORY).FunctionHelp(_T(FH)).Documentation(_T(D))); \
 	extern "C" __declspec(dllexport) xfpx* xll_ ## f(xfpx* pz) { \
-	if (size(*pz) != 2) { XLL_ERROR(F ARG_ERR); return 0; } \
+	XLL_PROFILE; \
+	if (size(*pz) != 2) { XLL_PROFILE_ERROR; XLL_ERROR(F ARG_ERR); return 0; } \
 	return complex_unary<XLOPERX>(gsl_ ## f, pz); }
 
 COMPLEX_UNARY(complex_inverse, "GSL.COMPLEX.INVERSE", 
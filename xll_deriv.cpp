@@ -26,10 +26,139 @@ static AddInX xai_function_deriv_central(
 	))
 );
 */
+XLL_ENUM_DOCX(static_cast<int>(gsl::deriv::scheme::central), GSL_DERIV_CENTRAL, CATEGORY, _T("Central differences"), _T("Documentation"));
+XLL_ENUM_DOCX(static_cast<int>(gsl::deriv::scheme::forward), GSL_DERIV_FORWARD, CATEGORY, _T("Forward differences reusing the value at x"), _T("Documentation"));
+XLL_ENUM_DOCX(static_cast<int>(gsl::deriv::scheme::richardson), GSL_DERIV_RICHARDSON, CATEGORY, _T("Richardson extrapolation of central differences"), _T("Documentation"));
+
+#define IS_METHOD _T("is the difference scheme from the GSL_DERIV_* enumeration. Default is central")
+#define IS_STEP _T("is an optional array of absolute steps for each coordinate or a single step for all")
+#define IS_PARALLEL _T("evaluates the points in parallel if true. Only use with functions that do not call Excel")
+
+inline gsl::deriv::options deriv_options(size_t n, WORD method, const xfpx* ph, BOOL parallel)
+{
+	ensure (method <= static_cast<WORD>(gsl::deriv::scheme::richardson));
+
+	gsl::deriv::options o;
+	o.method = static_cast<gsl::deriv::scheme>(method);
+	o.parallel = parallel != 0;
+	if (size(*ph) > 1 || ph->array[0] > 0) {
+		ensure (size(*ph) == 1 || size(*ph) == n);
+		o.h.assign(ph->array, ph->array + size(*ph));
+	}
+
+	return o;
+}
+
+static AddInX xai_deriv_gradient(
+	FunctionX(XLL_FPX, _T("?xll_deriv_gradient"), PREFIX _T("DERIV.GRADIENT"))
+	.Arg(XLL_HANDLEX, _T("f"), _T("is a handle to a function from R^n to R"))
+	.Arg(XLL_FPX, _T("x"), _T("is the point at which to compute the gradient"))
+	.Arg(XLL_WORDX, _T("Method"), IS_METHOD)
+	.Arg(XLL_FPX, _T("h"), IS_STEP)
+	.Arg(XLL_BOOLX, _T("Parallel"), IS_PARALLEL)
+	.Category(CATEGORY)
+	.FunctionHelp(_T("Return the gradient of f at x as a one row array."))
+	.Documentation(_T(""))
+);
+xfpx* WINAPI xll_deriv_gradient(HANDLEX f, const xfpx* px, WORD method, const xfpx* ph, BOOL parallel)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	static FPX df;
+
+	try {
+		handle<gsl::deriv::scalar_function> f_(f);
+
+		size_t n = size(*px);
+		df.resize(1, static_cast<xword>(n));
+		gsl::deriv::gradient(*f_, n, px->array, df.array(), deriv_options(n, method, ph, parallel));
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+
+		return 0;
+	}
+
+	return df.get();
+}
+
+static AddInX xai_deriv_jacobian(
+	FunctionX(XLL_FPX, _T("?xll_deriv_jacobian"), PREFIX _T("DERIV.JACOBIAN"))
+	.Arg(XLL_HANDLEX, _T("f"), _T("is a handle to a function from R^n to R^m"))
+	.Arg(XLL_FPX, _T("x"), _T("is the point at which to compute the Jacobian"))
+	.Arg(XLL_WORDX, _T("m"), _T("is the number of function values. Default is the size of x"))
+	.Arg(XLL_WORDX, _T("Method"), IS_METHOD)
+	.Arg(XLL_FPX, _T("h"), IS_STEP)
+	.Arg(XLL_BOOLX, _T("Parallel"), IS_PARALLEL)
+	.Category(CATEGORY)
+	.FunctionHelp(_T("Return the m x n Jacobian of f at x."))
+	.Documentation(_T("Row i contains the partial derivatives of the i-th function value. "))
+);
+xfpx* WINAPI xll_deriv_jacobian(HANDLEX f, const xfpx* px, WORD m, WORD method, const xfpx* ph, BOOL parallel)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	static FPX J;
+
+	try {
+		handle<gsl::deriv::vector_function> f_(f);
+
+		size_t n = size(*px);
+		if (m == 0)
+			m = static_cast<WORD>(n);
+		J.resize(m, static_cast<xword>(n));
+		gsl::deriv::jacobian(*f_, n, m, px->array, J.array(), deriv_options(n, method, ph, parallel));
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+
+		return 0;
+	}
+
+	return J.get();
+}
+
+static AddInX xai_deriv_hessian(
+	FunctionX(XLL_FPX, _T("?xll_deriv_hessian"), PREFIX _T("DERIV.HESSIAN"))
+	.Arg(XLL_HANDLEX, _T("f"), _T("is a handle to a function from R^n to R"))
+	.Arg(XLL_FPX, _T("x"), _T("is the point at which to compute the Hessian"))
+	.Arg(XLL_WORDX, _T("Method"), _T("is GSL_DERIV_CENTRAL or GSL_DERIV_RICHARDSON. Default is central"))
+	.Arg(XLL_FPX, _T("h"), IS_STEP)
+	.Arg(XLL_BOOLX, _T("Parallel"), IS_PARALLEL)
+	.Category(CATEGORY)
+	.FunctionHelp(_T("Return the n x n matrix of second partial derivatives of f at x."))
+	.Documentation(_T(""))
+);
+xfpx* WINAPI xll_deriv_hessian(HANDLEX f, const xfpx* px, WORD method, const xfpx* ph, BOOL parallel)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	static FPX H;
+
+	try {
+		handle<gsl::deriv::scalar_function> f_(f);
+
+		size_t n = size(*px);
+		H.resize(static_cast<xword>(n), static_cast<xword>(n));
+		gsl::deriv::hessian(*f_, n, px->array, H.array(), deriv_options(n, method, ph, parallel));
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+
+		return 0;
+	}
+
+	return H.get();
+}
+
 #ifdef _DEBUG
 XLL_TEST_BEGIN(test_gsl_deriv)
 
 	test_gsl_deriv();
+	test_gsl_deriv_engine();
 
 XLL_TEST_END(test_gsl_deriv)
 #endif // _DEBUG
\ No newline at end of file
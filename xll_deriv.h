@@ -1,11 +1,17 @@
 // xll_derive.h - numerical differentiation
 // http://www.gnu.org/software/gsl/manual/html_node/Numerical-Differentiation.html#Numerical-Differentiation
 #pragma once
+#include <algorithm>
+#include <cmath>
 #include <functional>
+#include <limits>
 #include <stdexcept>
+#include <vector>
 #include "gsl/gsl_errno.h"
+#include "gsl/gsl_complex.h"
 #include "gsl/gsl_deriv.h"
 #include "xll_math.h"
+#include "xll_parallel.h"
 
 namespace gsl {
 namespace deriv {
@@ -14,10 +20,9 @@ namespace deriv {
 
 	inline auto central(const function& f, double h = 1e-8)
 	{
-		return [f,h](double x) {
+		return [f_ = gsl::function(f),h](double x) mutable {
 			double result, abserr;
-			gsl::function f_(f);
-			
+
 			if (GSL_SUCCESS != gsl_deriv_central(&f_, x, h, &result, &abserr))
 				throw std::runtime_error(__FILE__ ": " __FUNCTION__ ": failed");
 
@@ -26,9 +31,8 @@ namespace deriv {
 	}
 	inline auto forward(const function& f, double h = 1e-8)
 	{
-		return [f,h](double x) {
+		return [f_ = gsl::function(f),h](double x) mutable {
 			double result, abserr;
-			gsl::function f_(f);
 
 			if (GSL_SUCCESS != gsl_deriv_forward(&f_, x, h, &result, &abserr))
 				throw std::runtime_error(__FILE__ ": " __FUNCTION__ ": failed");
@@ -38,9 +42,8 @@ namespace deriv {
 	}
 	inline auto backward(const function& f, double h = 1e-8)
 	{
-		return [f,h](double x) {
+		return [f_ = gsl::function(f),h](double x) mutable {
 			double result, abserr;
-			gsl::function f_(f);
 
 			if (GSL_SUCCESS != gsl_deriv_backward(&f_, x, h, &result, &abserr))
 				throw std::runtime_error(__FILE__ ": " __FUNCTION__ ": failed");
@@ -48,6 +51,195 @@ namespace deriv {
 			return result;
 		};
 	}
+
+	// f extended to complex arguments
+	using complex_function = std::function<gsl_complex(gsl_complex)>;
+
+	// f'(x) = Im f(x + ih)/h for f analytic and real on the real line
+	// There is no subtraction so h can be tiny and the result is accurate to rounding.
+	inline auto complex_step(const complex_function& f, double h = 1e-20)
+	{
+		return [f,h](double x) {
+			gsl_complex z;
+			GSL_SET_COMPLEX(&z, x, h);
+
+			return GSL_IMAG(f(z))/h;
+		};
+	}
+
+	// derivatives of functions of several variables
+
+	// f: R^n -> R
+	using scalar_function = std::function<double(size_t n, const double* x)>;
+	// f: R^n -> R^m, y has m elements
+	using vector_function = std::function<void(size_t n, const double* x, double* y)>;
+
+	enum class scheme {
+		central,    // (f(x + h) - f(x - h))/2h
+		forward,    // (f(x + h) - f(x))/h, reuses f(x)
+		richardson, // (4 D(h/2) - D(h))/3 where D is central
+	};
+
+	struct options {
+		scheme method = scheme::central;
+		std::vector<double> h; // absolute step for each coordinate, empty for automatic
+		bool parallel = false; // only if f can be called from several threads at once
+	};
+
+	// automatic step balancing truncation and rounding error for each scheme
+	inline double relative_step(scheme method, int order = 1)
+	{
+		static const double eps = std::numeric_limits<double>::epsilon();
+
+		if (order == 2)
+			return method == scheme::richardson ? pow(eps, 1./6) : pow(eps, 1./4);
+
+		switch (method) {
+		case scheme::forward:
+			return sqrt(eps);
+		case scheme::central:
+			return cbrt(eps);
+		default:
+			return pow(eps, 1./5);
+		}
+	}
+	// step for coordinate j that is exactly representable at x[j]
+	inline double step(const options& o, size_t j, double xj, int order = 1)
+	{
+		double h = o.h.empty() ? relative_step(o.method, order)*(std::max)(fabs(xj), 1.)
+			: o.h.size() == 1 ? o.h[0] : o.h[j];
+		volatile double xh = xj + h;
+
+		return xh - xj;
+	}
+
+	// J[i*n + j] = df_i/dx_j for the m x n Jacobian, fx = f(x) if known
+	// All perturbed points are evaluated as one batch that runs in parallel if o.parallel.
+	inline void jacobian(const vector_function& f, size_t n, size_t m, const double* x, double* J,
+		const options& o = options{}, const double* fx = nullptr)
+	{
+		// offsets from x in units of h for each column
+		static const double fwd[] = {1}, ctr[] = {1, -1}, rich[] = {1, -1, 0.5, -0.5};
+		const double* a = o.method == scheme::forward ? fwd : o.method == scheme::central ? ctr : rich;
+		size_t k = o.method == scheme::forward ? 1 : o.method == scheme::central ? 2 : 4;
+
+		std::vector<double> f0;
+		if (o.method == scheme::forward && !fx) {
+			f0.resize(m);
+			f(n, x, f0.data());
+			fx = f0.data();
+		}
+
+		std::vector<double> h(n), y(n*k*m);
+		for (size_t j = 0; j < n; ++j)
+			h[j] = step(o, j, x[j]);
+
+		gsl::parallel::for_each(n*k, [&](size_t t) {
+			size_t j = t/k;
+			std::vector<double> xt(x, x + n);
+
+			xt[j] += a[t%k]*h[j];
+			f(n, xt.data(), &y[t*m]);
+		}, o.parallel ? gsl::parallel::concurrency() : 1);
+
+		for (size_t j = 0; j < n; ++j) {
+			const double* yj = &y[j*k*m];
+			for (size_t i = 0; i < m; ++i) {
+				double d;
+				if (o.method == scheme::forward) {
+					d = (yj[i] - fx[i])/h[j];
+				}
+				else {
+					d = (yj[i] - yj[m + i])/(2*h[j]);
+					if (o.method == scheme::richardson) {
+						double d2 = (yj[2*m + i] - yj[3*m + i])/h[j];
+						d = (4*d2 - d)/3;
+					}
+				}
+				J[i*n + j] = d;
+			}
+		}
+	}
+
+	// gradient of a scalar function
+	inline void gradient(const scalar_function& f, size_t n, const double* x, double* df,
+		const options& o = options{}, const double* fx = nullptr)
+	{
+		jacobian([&f](size_t n, const double* x, double* y) {
+			*y = f(n, x);
+		}, n, 1, x, df, o, fx);
+	}
+
+	// H[i*n + j] = d^2f/dx_i dx_j using central differences, fx = f(x) if known
+	// Richardson extrapolation combines the estimates for h and h/2.
+	inline void hessian(const scalar_function& f, size_t n, const double* x, double* H,
+		const options& o = options{}, const double* fx = nullptr)
+	{
+		double f0 = fx ? *fx : f(n, x);
+
+		std::vector<double> h(n);
+		for (size_t j = 0; j < n; ++j)
+			h[j] = step(o, j, x[j], 2);
+
+		// points x + s_i h_i e_i + s_j h_j e_j for i <= j
+		struct point {
+			size_t i, j;
+			double si, sj;
+		};
+		auto points = [n](double scale) {
+			std::vector<point> p;
+			for (size_t i = 0; i < n; ++i) {
+				p.push_back(point{i, i, scale, 0});
+				p.push_back(point{i, i, -scale, 0});
+				for (size_t j = i + 1; j < n; ++j) {
+					p.push_back(point{i, j, scale, scale});
+					p.push_back(point{i, j, scale, -scale});
+					p.push_back(point{i, j, -scale, scale});
+					p.push_back(point{i, j, -scale, -scale});
+				}
+			}
+
+			return p;
+		};
+
+		std::vector<point> p = points(1);
+		size_t np = p.size();
+		if (o.method == scheme::richardson) {
+			std::vector<point> p2 = points(0.5);
+			p.insert(p.end(), p2.begin(), p2.end());
+		}
+
+		std::vector<double> y(p.size());
+		gsl::parallel::for_each(p.size(), [&](size_t t) {
+			std::vector<double> xt(x, x + n);
+
+			xt[p[t].i] += p[t].si*h[p[t].i];
+			xt[p[t].j] += p[t].sj*h[p[t].j];
+			y[t] = f(n, xt.data());
+		}, o.parallel ? gsl::parallel::concurrency() : 1);
+
+		auto combine = [&](const double* y, double scale, double* H) {
+			for (size_t i = 0; i < n; ++i) {
+				double hi = scale*h[i];
+				H[i*n + i] = (y[0] - 2*f0 + y[1])/(hi*hi);
+				y += 2;
+				for (size_t j = i + 1; j < n; ++j) {
+					double hj = scale*h[j];
+					H[i*n + j] = H[j*n + i] = (y[0] - y[1] - y[2] + y[3])/(4*hi*hj);
+					y += 4;
+				}
+			}
+		};
+
+		combine(y.data(), 1, H);
+		if (o.method == scheme::richardson) {
+			std::vector<double> H2(n*n);
+			combine(y.data() + np, 0.5, H2.data());
+			for (size_t k = 0; k < n*n; ++k)
+				H[k] = (4*H2[k] - H[k])/3;
+		}
+	}
+
 } // derive
 } // gsl
 
@@ -73,4 +265,69 @@ inline void test_gsl_deriv()
 
 }
 
-#endif // _DEBUG
\ No newline at end of file
+inline void test_gsl_deriv_engine()
+{
+	using namespace gsl::deriv;
+
+	// f(x, y) = (x^2 y, sin(x) + y^3)
+	auto f = [](size_t n, const double* x, double* y) {
+		assert (n == 2);
+		y[0] = x[0]*x[0]*x[1];
+		y[1] = sin(x[0]) + x[1]*x[1]*x[1];
+	};
+	double x[] = {0.5, 2}, J[4];
+	double J0[] = {2*x[0]*x[1], x[0]*x[0], cos(x[0]), 3*x[1]*x[1]};
+
+	options o;
+	for (auto method : {scheme::forward, scheme::central, scheme::richardson}) {
+		o.method = method;
+		double tol = method == scheme::forward ? 1e-6 : method == scheme::central ? 1e-9 : 1e-11;
+		for (bool parallel : {false, true}) {
+			o.parallel = parallel;
+			jacobian(f, 2, 2, x, J, o);
+			for (size_t k = 0; k < 4; ++k)
+				assert (fabs(J[k] - J0[k]) < tol);
+		}
+	}
+
+	// g(x, y) = x^2 y + exp(y)
+	auto g = [](size_t, const double* x) {
+		return x[0]*x[0]*x[1] + exp(x[1]);
+	};
+	double df[2], H[4];
+	o = options{};
+	gradient(g, 2, x, df, o);
+	assert (fabs(df[0] - 2*x[0]*x[1]) < 1e-9);
+	assert (fabs(df[1] - (x[0]*x[0] + exp(x[1]))) < 1e-9);
+
+	double H0[] = {2*x[1], 2*x[0], 2*x[0], exp(x[1])};
+	hessian(g, 2, x, H, o);
+	for (size_t k = 0; k < 4; ++k)
+		assert (fabs(H[k] - H0[k]) < 1e-5);
+	o.method = scheme::richardson;
+	hessian(g, 2, x, H, o);
+	for (size_t k = 0; k < 4; ++k)
+		assert (fabs(H[k] - H0[k]) < 1e-7);
+
+	// complex step
+	{
+		auto f = [](gsl_complex z) {
+			// z^3
+			double a = GSL_REAL(z), b = GSL_IMAG(z);
+			gsl_complex w;
+			GSL_SET_COMPLEX(&w, a*a*a - 3*a*b*b, 3*a*a*b - b*b*b);
+
+			return w;
+		};
+		auto df = complex_step(f);
+		assert (df(0.1) == 3*0.1*0.1);
+	}
+
+	// user supplied steps
+	o = options{};
+	o.h = {1e-4, 1e-5};
+	gradient(g, 2, x, df, o);
+	assert (fabs(df[0] - 2*x[0]*x[1]) < 1e-7);
+}
+
+#endif // _DEBUG
@@ -0,0 +1,158 @@
+// xll_dual.h - dual numbers for forward mode automatic differentiation
+// If f is written using dual arithmetic then f(x + e) = f(x) + f'(x) e where e^2 = 0.
+#pragma once
+#include <cmath>
+
+namespace gsl {
+
+namespace ad {
+
+	// The functions below are found by argument dependent lookup and
+	// do not hide the standard math functions in namespace gsl.
+	struct dual {
+		double v; // value
+		double d; // derivative
+
+		dual(double v = 0, double d = 0)
+			: v(v), d(d)
+		{ }
+
+		dual& operator+=(const dual& y)
+		{
+			v += y.v;
+			d += y.d;
+
+			return *this;
+		}
+		dual& operator-=(const dual& y)
+		{
+			v -= y.v;
+			d -= y.d;
+
+			return *this;
+		}
+		dual& operator*=(const dual& y)
+		{
+			d = d*y.v + v*y.d;
+			v *= y.v;
+
+			return *this;
+		}
+		dual& operator/=(const dual& y)
+		{
+			d = (d*y.v - v*y.d)/(y.v*y.v);
+			v /= y.v;
+
+			return *this;
+		}
+	};
+
+	inline dual operator-(const dual& x)
+	{
+		return dual(-x.v, -x.d);
+	}
+	inline dual operator+(dual x, const dual& y)
+	{
+		return x += y;
+	}
+	inline dual operator-(dual x, const dual& y)
+	{
+		return x -= y;
+	}
+	inline dual operator*(dual x, const dual& y)
+	{
+		return x *= y;
+	}
+	inline dual operator/(dual x, const dual& y)
+	{
+		return x /= y;
+	}
+
+	// comparison only uses the value
+	inline bool operator<(const dual& x, const dual& y)
+	{
+		return x.v < y.v;
+	}
+	inline bool operator>(const dual& x, const dual& y)
+	{
+		return x.v > y.v;
+	}
+	inline bool operator<=(const dual& x, const dual& y)
+	{
+		return x.v <= y.v;
+	}
+	inline bool operator>=(const dual& x, const dual& y)
+	{
+		return x.v >= y.v;
+	}
+
+	inline dual exp(const dual& x)
+	{
+		double e = ::exp(x.v);
+
+		return dual(e, e*x.d);
+	}
+	inline dual log(const dual& x)
+	{
+		return dual(::log(x.v), x.d/x.v);
+	}
+	inline dual sqrt(const dual& x)
+	{
+		double s = ::sqrt(x.v);
+
+		return dual(s, x.d/(2*s));
+	}
+	inline dual sin(const dual& x)
+	{
+		return dual(::sin(x.v), ::cos(x.v)*x.d);
+	}
+	inline dual cos(const dual& x)
+	{
+		return dual(::cos(x.v), -::sin(x.v)*x.d);
+	}
+	inline dual fabs(const dual& x)
+	{
+		return x.v < 0 ? -x : x;
+	}
+	inline dual pow(const dual& x, double p)
+	{
+		double xp = ::pow(x.v, p - 1);
+
+		return dual(xp*x.v, p*xp*x.d);
+	}
+	inline dual pow(const dual& x, const dual& y)
+	{
+		return exp(y*log(x));
+	}
+
+} // ad
+
+	using ad::dual;
+
+} // gsl
+
+#ifdef _DEBUG
+#include <cassert>
+
+inline void test_gsl_dual()
+{
+	using gsl::dual;
+
+	dual x(2, 1);
+	dual y = x*x*x - 2*x + 1; // 3x^2 - 2
+	assert (y.v == 5 && y.d == 10);
+
+	y = 1/x;
+	assert (y.v == 0.5 && y.d == -0.25);
+
+	y = exp(2*x);
+	assert (fabs(y.d - 2*::exp(4.)) < 1e-12);
+
+	y = pow(x, 3.);
+	assert (y.v == 8 && y.d == 12);
+
+	y = sqrt(x*x);
+	assert (y.v == 2 && y.d == 1);
+}
+
+#endif // _DEBUG
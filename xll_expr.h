@@ -0,0 +1,764 @@
+// xll_expr.h - compile arithmetic expressions to stack bytecode
+// Expressions like "exp(-x)*x^2 - a" are parsed into a directed acyclic graph.
+// Identical subexpressions share a node, subexpressions not involving a variable
+// are folded to constants, and the graph is flattened into a compact program for
+// a stack machine. Shared nodes are computed once and kept in temporaries.
+#pragma once
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "gsl/gsl_complex.h"
+#include "gsl/gsl_complex_math.h"
+
+namespace xll {
+
+namespace expr {
+
+	// OP_ prefix since windows.h defines macros such as CONST
+	enum opcode : std::uint8_t {
+		OP_CONST, // push constant
+		OP_VAR,   // push variable
+		OP_LOAD,  // push temporary
+		OP_STORE, // copy top of stack to temporary
+		OP_NEG, OP_SQR, OP_EXP, OP_LOG, OP_SQRT, OP_ABS, OP_SIN, OP_COS, OP_TAN, OP_ERF, // unary
+		OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_POW, OP_MIN, OP_MAX, // binary
+	};
+
+	inline bool is_unary(opcode op)
+	{
+		return OP_NEG <= op && op <= OP_ERF;
+	}
+	inline bool is_binary(opcode op)
+	{
+		return OP_ADD <= op && op <= OP_MAX;
+	}
+	inline bool is_commutative(opcode op)
+	{
+		return op == OP_ADD || op == OP_MUL || op == OP_MIN || op == OP_MAX;
+	}
+
+	inline double apply(opcode op, double a)
+	{
+		switch (op) {
+		case OP_NEG:  return -a;
+		case OP_SQR:  return a*a;
+		case OP_EXP:  return exp(a);
+		case OP_LOG:  return log(a);
+		case OP_SQRT: return sqrt(a);
+		case OP_ABS:  return fabs(a);
+		case OP_SIN:  return sin(a);
+		case OP_COS:  return cos(a);
+		case OP_TAN:  return tan(a);
+		case OP_ERF:  return erf(a);
+		default:   return a;
+		}
+	}
+	inline double apply(opcode op, double a, double b)
+	{
+		switch (op) {
+		case OP_ADD: return a + b;
+		case OP_SUB: return a - b;
+		case OP_MUL: return a * b;
+		case OP_DIV: return a / b;
+		case OP_POW: return pow(a, b);
+		case OP_MIN: return a < b ? a : b;
+		case OP_MAX: return a > b ? a : b;
+		default:  return a;
+		}
+	}
+
+	// complex arithmetic for complex step differentiation
+	// Operations that are not analytic, or where the real function is not the
+	// restriction of the complex one, use f(a + ib) = f(a) + i b f'(a) which is
+	// exact to machine precision for the tiny imaginary parts used.
+	inline gsl_complex apply(opcode op, gsl_complex z)
+	{
+		double a = GSL_REAL(z), b = GSL_IMAG(z);
+
+		switch (op) {
+		case OP_NEG:  return gsl_complex_negative(z);
+		case OP_SQR:  return gsl_complex_mul(z, z);
+		case OP_EXP:  return gsl_complex_exp(z);
+		case OP_LOG:  return gsl_complex_log(z);
+		case OP_SQRT: return gsl_complex_sqrt(z);
+		case OP_ABS:  return a < 0 ? gsl_complex_negative(z) : z;
+		case OP_SIN:  return gsl_complex_sin(z);
+		case OP_COS:  return gsl_complex_cos(z);
+		case OP_TAN:  return gsl_complex_tan(z);
+		case OP_ERF:  return gsl_complex_rect(erf(a), b*1.1283791670955126*exp(-a*a)); // 2/sqrt(pi)
+		default:   return z;
+		}
+	}
+	inline gsl_complex apply(opcode op, gsl_complex z, gsl_complex w)
+	{
+		switch (op) {
+		case OP_ADD: return gsl_complex_add(z, w);
+		case OP_SUB: return gsl_complex_sub(z, w);
+		case OP_MUL: return gsl_complex_mul(z, w);
+		case OP_DIV: return gsl_complex_div(z, w);
+		case OP_POW:
+			if (GSL_IMAG(w) == 0) {
+				double a = GSL_REAL(z), p = GSL_REAL(w), ap = pow(a, p - 1);
+
+				return gsl_complex_rect(ap*a, GSL_IMAG(z)*p*ap);
+			}
+
+			return gsl_complex_pow(z, w);
+		case OP_MIN: return GSL_REAL(z) <= GSL_REAL(w) ? z : w;
+		case OP_MAX: return GSL_REAL(z) >= GSL_REAL(w) ? z : w;
+		default:  return z;
+		}
+	}
+
+	struct instruction {
+		opcode op;
+		std::uint32_t arg; // constant, variable or temporary index
+	};
+
+	// compiled expression
+	class program {
+		friend class compiler;
+
+		std::vector<instruction> code;
+		std::vector<double> constant;
+		size_t nvar = 0, depth = 0, ntmp = 0;
+
+		// run the program on blocks of n points, where v[k] points to values of variable k
+		// s must have room for (depth + ntmp)*n doubles
+		void run(size_t n, const double* const* v, double* y, double* s) const
+		{
+			double* t = s + depth*n; // temporaries
+			double* top = s - n;     // current top of stack
+
+			for (const auto& i : code) {
+				switch (i.op) {
+				case OP_CONST:
+					top += n;
+					for (size_t j = 0; j < n; ++j)
+						top[j] = constant[i.arg];
+					break;
+				case OP_VAR:
+					top += n;
+					for (size_t j = 0; j < n; ++j)
+						top[j] = v[i.arg][j];
+					break;
+				case OP_LOAD:
+					top += n;
+					for (size_t j = 0; j < n; ++j)
+						top[j] = t[i.arg*n + j];
+					break;
+				case OP_STORE:
+					for (size_t j = 0; j < n; ++j)
+						t[i.arg*n + j] = top[j];
+					break;
+				case OP_NEG:
+					for (size_t j = 0; j < n; ++j)
+						top[j] = -top[j];
+					break;
+				case OP_SQR:
+					for (size_t j = 0; j < n; ++j)
+						top[j] *= top[j];
+					break;
+				case OP_ADD:
+					top -= n;
+					for (size_t j = 0; j < n; ++j)
+						top[j] += top[j + n];
+					break;
+				case OP_SUB:
+					top -= n;
+					for (size_t j = 0; j < n; ++j)
+						top[j] -= top[j + n];
+					break;
+				case OP_MUL:
+					top -= n;
+					for (size_t j = 0; j < n; ++j)
+						top[j] *= top[j + n];
+					break;
+				case OP_DIV:
+					top -= n;
+					for (size_t j = 0; j < n; ++j)
+						top[j] /= top[j + n];
+					break;
+				default:
+					if (is_unary(i.op)) {
+						for (size_t j = 0; j < n; ++j)
+							top[j] = apply(i.op, top[j]);
+					}
+					else {
+						top -= n;
+						for (size_t j = 0; j < n; ++j)
+							top[j] = apply(i.op, top[j], top[j + n]);
+					}
+				}
+			}
+
+			for (size_t j = 0; j < n; ++j)
+				y[j] = top[j];
+		}
+	public:
+		// number of variables the program expects
+		size_t variables() const
+		{
+			return nvar;
+		}
+		// number of instructions
+		size_t size() const
+		{
+			return code.size();
+		}
+		const std::vector<instruction>& instructions() const
+		{
+			return code;
+		}
+
+		// evaluate at a point with v[k] the value of variable k
+		// Stack buffers are used unless the program is unusually large.
+		double eval(const double* v) const
+		{
+			static const size_t N = 64, V = 16;
+			double y, s[N];
+			const double* pv[V];
+			std::vector<double> s_;
+			std::vector<const double*> v_;
+			double* ps = s;
+			const double** ppv = pv;
+
+			if (depth + ntmp > N) {
+				s_.resize(depth + ntmp);
+				ps = s_.data();
+			}
+			if (nvar > V) {
+				v_.resize(nvar);
+				ppv = v_.data();
+			}
+
+			for (size_t k = 0; k < nvar; ++k)
+				ppv[k] = v + k;
+			run(1, ppv, &y, ps);
+
+			return y;
+		}
+		// scalar function of at most one variable
+		double operator()(double x) const
+		{
+			if (nvar > 1)
+				throw std::invalid_argument("xll::expr::program: more than one variable");
+
+			return eval(&x);
+		}
+		// evaluate at a complex point
+		gsl_complex eval(const gsl_complex* v) const
+		{
+			static const size_t N = 64;
+			gsl_complex st[N];
+			std::vector<gsl_complex> st_;
+			gsl_complex* s = st;
+
+			if (depth + ntmp > N) {
+				st_.resize(depth + ntmp);
+				s = st_.data();
+			}
+			gsl_complex* t = s + depth; // temporaries
+			size_t top = 0;
+
+			for (const auto& i : code) {
+				switch (i.op) {
+				case OP_CONST:
+					s[top++] = gsl_complex_rect(constant[i.arg], 0);
+					break;
+				case OP_VAR:
+					s[top++] = v[i.arg];
+					break;
+				case OP_LOAD:
+					s[top++] = t[i.arg];
+					break;
+				case OP_STORE:
+					t[i.arg] = s[top - 1];
+					break;
+				default:
+					if (is_unary(i.op)) {
+						s[top - 1] = apply(i.op, s[top - 1]);
+					}
+					else {
+						--top;
+						s[top - 1] = apply(i.op, s[top - 1], s[top]);
+					}
+				}
+			}
+
+			return s[0];
+		}
+		// complex function of at most one variable
+		gsl_complex operator()(gsl_complex z) const
+		{
+			if (nvar > 1)
+				throw std::invalid_argument("xll::expr::program: more than one variable");
+
+			return eval(&z);
+		}
+		// evaluate at n points with v[k][i] the i-th value of variable k
+		// Each instruction runs over a block of points at a time.
+		void eval(size_t n, const double* const* v, double* y) const
+		{
+			static const size_t B = 256;
+			std::vector<double> s((depth + ntmp)*B);
+			std::vector<const double*> v_(nvar);
+
+			for (size_t i = 0; i < n; i += B) {
+				size_t m = (n - i < B) ? n - i : B;
+				for (size_t k = 0; k < nvar; ++k)
+					v_[k] = v[k] + i;
+				run(m, v_.data(), y + i, s.data());
+			}
+		}
+		// batch evaluation of a function of at most one variable
+		void operator()(size_t n, const double* x, double* y) const
+		{
+			if (nvar > 1)
+				throw std::invalid_argument("xll::expr::program: more than one variable");
+
+			eval(n, &x, y);
+		}
+	};
+
+	// recursive descent parser building a hash consed graph
+	class compiler {
+		struct node {
+			opcode op;
+			std::uint32_t a, b; // children for operators, index for OP_VAR
+			double value;       // for OP_CONST
+		};
+		std::vector<node> nodes;
+		std::map<std::tuple<int,std::uint32_t,std::uint32_t,std::uint64_t>,std::uint32_t> index;
+
+		std::vector<std::string> vars;
+		std::map<std::string,double> consts;
+
+		const char* s;
+		const char* p;
+
+		[[noreturn]] void error(const std::string& msg) const
+		{
+			throw std::invalid_argument("xll::expr: " + msg + " at position " + std::to_string(p - s) + " in \"" + s + "\"");
+		}
+
+		std::uint32_t make(opcode op, std::uint32_t a = 0, std::uint32_t b = 0, double value = 0)
+		{
+			std::uint64_t bits = 0;
+			if (op == OP_CONST)
+				std::memcpy(&bits, &value, sizeof(bits));
+			if (is_commutative(op) && b < a)
+				std::swap(a, b);
+
+			auto key = std::make_tuple(static_cast<int>(op), a, b, bits);
+			auto i = index.find(key);
+			if (i != index.end())
+				return i->second;
+
+			std::uint32_t n = static_cast<std::uint32_t>(nodes.size());
+			nodes.push_back(node{op, a, b, value});
+			index[key] = n;
+
+			return n;
+		}
+		bool is_const(std::uint32_t n, double* value = nullptr) const
+		{
+			if (nodes[n].op != OP_CONST)
+				return false;
+			if (value)
+				*value = nodes[n].value;
+
+			return true;
+		}
+		bool is_const(std::uint32_t n, double value) const
+		{
+			return nodes[n].op == OP_CONST && nodes[n].value == value;
+		}
+
+		// fold constants and simplify identities
+		std::uint32_t unary(opcode op, std::uint32_t a)
+		{
+			double x;
+			if (is_const(a, &x))
+				return make(OP_CONST, 0, 0, apply(op, x));
+			if (op == OP_NEG && nodes[a].op == OP_NEG)
+				return nodes[a].a;
+
+			return make(op, a);
+		}
+		std::uint32_t binary(opcode op, std::uint32_t a, std::uint32_t b)
+		{
+			double x, y;
+			if (is_const(a, &x) && is_const(b, &y))
+				return make(OP_CONST, 0, 0, apply(op, x, y));
+
+			switch (op) {
+			case OP_ADD:
+				if (is_const(a, 0.)) return b;
+				if (is_const(b, 0.)) return a;
+				break;
+			case OP_SUB:
+				if (is_const(b, 0.)) return a;
+				if (is_const(a, 0.)) return unary(OP_NEG, b);
+				break;
+			case OP_MUL:
+				if (is_const(a, 1.)) return b;
+				if (is_const(b, 1.)) return a;
+				if (a == b) return make(OP_SQR, a);
+				break;
+			case OP_DIV:
+				if (is_const(b, 1.)) return a;
+				break;
+			case OP_POW:
+				if (is_const(b, 1.)) return a;
+				if (is_const(b, 2.)) return make(OP_SQR, a);
+				if (is_const(b, 0.5)) return make(OP_SQRT, a);
+				break;
+			default:
+				break;
+			}
+
+			return make(op, a, b);
+		}
+
+		void skip()
+		{
+			while (isspace(static_cast<unsigned char>(*p)))
+				++p;
+		}
+		bool accept(char c)
+		{
+			skip();
+			if (*p != c)
+				return false;
+			++p;
+
+			return true;
+		}
+		void expect(char c)
+		{
+			if (!accept(c))
+				error(std::string("expected '") + c + "'");
+		}
+
+		// expr := term (('+'|'-') term)*
+		std::uint32_t expression()
+		{
+			std::uint32_t a = term();
+
+			for (;;) {
+				if (accept('+'))
+					a = binary(OP_ADD, a, term());
+				else if (accept('-'))
+					a = binary(OP_SUB, a, term());
+				else
+					return a;
+			}
+		}
+		// term := factor (('*'|'/') factor)*
+		std::uint32_t term()
+		{
+			std::uint32_t a = factor();
+
+			for (;;) {
+				if (accept('*'))
+					a = binary(OP_MUL, a, factor());
+				else if (accept('/'))
+					a = binary(OP_DIV, a, factor());
+				else
+					return a;
+			}
+		}
+		// factor := ('-'|'+') factor | primary ('^' factor)?
+		std::uint32_t factor()
+		{
+			if (accept('-'))
+				return unary(OP_NEG, factor());
+			if (accept('+'))
+				return factor();
+
+			std::uint32_t a = primary();
+			if (accept('^'))
+				a = binary(OP_POW, a, factor());
+
+			return a;
+		}
+		// primary := number | name | name '(' expr (',' expr)* ')' | '(' expr ')'
+		std::uint32_t primary()
+		{
+			skip();
+
+			if (accept('(')) {
+				std::uint32_t a = expression();
+				expect(')');
+
+				return a;
+			}
+
+			if (isdigit(static_cast<unsigned char>(*p)) || *p == '.') {
+				char* e;
+				double x = strtod(p, &e);
+				if (e == p)
+					error("invalid number");
+				p = e;
+
+				return make(OP_CONST, 0, 0, x);
+			}
+
+			if (isalpha(static_cast<unsigned char>(*p)) || *p == '_') {
+				const char* b = p;
+				while (isalnum(static_cast<unsigned char>(*p)) || *p == '_')
+					++p;
+				std::string name(b, p);
+
+				if (accept('('))
+					return call(name);
+
+				for (size_t k = 0; k < vars.size(); ++k)
+					if (vars[k] == name)
+						return make(OP_VAR, static_cast<std::uint32_t>(k));
+
+				auto c = consts.find(name);
+				if (c != consts.end())
+					return make(OP_CONST, 0, 0, c->second);
+				if (name == "pi")
+					return make(OP_CONST, 0, 0, 3.14159265358979323846);
+
+				p = b;
+				error("unknown name '" + name + "'");
+			}
+
+			error(*p ? "unexpected character" : "unexpected end");
+		}
+		std::uint32_t call(const std::string& name)
+		{
+			static const std::map<std::string,opcode> unaries = {
+				{"exp", OP_EXP}, {"log", OP_LOG}, {"sqrt", OP_SQRT}, {"abs", OP_ABS},
+				{"sin", OP_SIN}, {"cos", OP_COS}, {"tan", OP_TAN}, {"erf", OP_ERF},
+			};
+			static const std::map<std::string,opcode> binaries = {
+				{"pow", OP_POW}, {"min", OP_MIN}, {"max", OP_MAX},
+			};
+
+			std::uint32_t a = expression();
+
+			auto u = unaries.find(name);
+			if (u != unaries.end()) {
+				expect(')');
+
+				return unary(u->second, a);
+			}
+
+			auto f = binaries.find(name);
+			if (f != binaries.end()) {
+				expect(',');
+				std::uint32_t b = expression();
+				expect(')');
+
+				return binary(f->second, a, b);
+			}
+
+			error("unknown function '" + name + "'");
+		}
+
+		// flatten the graph into stack code
+		void emit(program& prog, std::uint32_t n, const std::vector<unsigned>& uses,
+			std::vector<std::uint32_t>& slot, size_t& depth)
+		{
+			const node& x = nodes[n];
+			static const std::uint32_t none = static_cast<std::uint32_t>(-1);
+
+			if (slot[n] != none) {
+				prog.code.push_back(instruction{OP_LOAD, slot[n]});
+				++depth;
+			}
+			else if (x.op == OP_CONST) {
+				prog.code.push_back(instruction{OP_CONST, static_cast<std::uint32_t>(prog.constant.size())});
+				prog.constant.push_back(x.value);
+				++depth;
+			}
+			else if (x.op == OP_VAR) {
+				prog.code.push_back(instruction{OP_VAR, x.a});
+				++depth;
+			}
+			else {
+				emit(prog, x.a, uses, slot, depth);
+				if (is_binary(x.op)) {
+					emit(prog, x.b, uses, slot, depth);
+					--depth;
+				}
+				prog.code.push_back(instruction{x.op, 0});
+
+				if (uses[n] > 1) {
+					slot[n] = static_cast<std::uint32_t>(prog.ntmp++);
+					prog.code.push_back(instruction{OP_STORE, slot[n]});
+				}
+			}
+
+			if (depth > prog.depth)
+				prog.depth = depth;
+		}
+	public:
+		// vars are the names of the variables in order
+		// consts are names bound to fixed values and folded into the program
+		compiler(const std::vector<std::string>& vars = std::vector<std::string>{"x"},
+			const std::map<std::string,double>& consts = std::map<std::string,double>{})
+			: vars(vars), consts(consts), s(nullptr), p(nullptr)
+		{ }
+
+		program compile(const char* expression_)
+		{
+			s = p = expression_;
+			nodes.clear();
+			index.clear();
+
+			std::uint32_t root = expression();
+			skip();
+			if (*p)
+				error("unexpected character");
+
+			// number of parents of each node reachable from the root
+			std::vector<unsigned> uses(nodes.size(), 0);
+			std::vector<bool> seen(nodes.size(), false);
+			std::vector<std::uint32_t> stack{root};
+			uses[root] = 1;
+			while (!stack.empty()) {
+				std::uint32_t n = stack.back();
+				stack.pop_back();
+				if (seen[n])
+					continue;
+				seen[n] = true;
+				const node& x = nodes[n];
+				if (is_unary(x.op) || is_binary(x.op)) {
+					++uses[x.a];
+					stack.push_back(x.a);
+				}
+				if (is_binary(x.op)) {
+					++uses[x.b];
+					stack.push_back(x.b);
+				}
+			}
+
+			program prog;
+			prog.nvar = vars.size();
+			std::vector<std::uint32_t> slot(nodes.size(), static_cast<std::uint32_t>(-1));
+			size_t depth = 0;
+			emit(prog, root, uses, slot, depth);
+
+			return prog;
+		}
+		program compile(const std::string& expression_)
+		{
+			return compile(expression_.c_str());
+		}
+	};
+
+	// compile a function of x with named parameters folded in
+	inline program compile(const std::string& expression, const std::map<std::string,double>& consts = std::map<std::string,double>{})
+	{
+		return compiler(std::vector<std::string>{"x"}, consts).compile(expression);
+	}
+
+} // expr
+
+} // xll
+
+#ifdef _DEBUG
+#include <cassert>
+#include <functional>
+
+inline void test_xll_expr()
+{
+	using xll::expr::compile;
+	using xll::expr::opcode;
+	{
+		auto f = compile("exp(-x)*x^2 - a", {{"a", 0.5}});
+		for (double x : {0., 0.5, 1., 2.})
+			assert (fabs(f(x) - (exp(-x)*x*x - 0.5)) < 1e-15);
+
+		std::function<double(double)> g = f;
+		assert (g(1) == f(1));
+	}
+	{
+		// constant folding
+		auto f = compile("2*a + 3^2 - sqrt(4)", {{"a", 1}});
+		assert (f.size() == 1);
+		assert (f.instructions()[0].op == xll::expr::OP_CONST);
+		assert (f(0) == 9);
+	}
+	{
+		// common subexpressions are evaluated once
+		auto f = compile("sin(x + 1)*sin(1 + x) + sin(x + 1)");
+		size_t nsin = 0;
+		for (const auto& i : f.instructions())
+			if (i.op == xll::expr::OP_SIN)
+				++nsin;
+		assert (nsin == 1);
+		double x = 0.3;
+		assert (fabs(f(x) - (sin(x + 1)*sin(x + 1) + sin(x + 1))) < 1e-15);
+	}
+	{
+		// precedence and associativity
+		assert (compile("1 - 2 - 3")(0) == -4);
+		assert (compile("2^3^2")(0) == 512);
+		assert (compile("-2^2")(0) == -4);
+		assert (compile("8/2/2")(0) == 2);
+		assert (compile("min(x, 1) + max(x, 1)")(3) == 4);
+		assert (compile("1e-3*1E3")(0) == 1);
+	}
+	{
+		// batch evaluation matches scalar evaluation
+		auto f = compile("log(1 + x*x)/(1 + abs(x))");
+		std::vector<double> x(1000), y(x.size());
+		for (size_t i = 0; i < x.size(); ++i)
+			x[i] = i/100. - 5;
+		f(x.size(), x.data(), y.data());
+		for (size_t i = 0; i < x.size(); ++i)
+			assert (y[i] == f(x[i]));
+	}
+	{
+		// complex step derivative is exact to rounding
+		auto f = compile("exp(-x)*x^3 + abs(x - 2) + max(x, 1)");
+		double x = 0.7, h = 1e-20;
+		gsl_complex z = f(gsl_complex_rect(x, h));
+		assert (GSL_REAL(z) == f(x));
+		double df = exp(-x)*(3*x*x - x*x*x) - 1;
+		assert (fabs(GSL_IMAG(z)/h - df) < 1e-15);
+	}
+	{
+		// several variables
+		xll::expr::compiler c({"x", "y"});
+		auto f = c.compile("x*y + x");
+		double v[] = {2, 3};
+		assert (f.eval(v) == 8);
+	}
+	{
+		bool thrown = false;
+		try {
+			compile("x + ");
+		}
+		catch (const std::invalid_argument&) {
+			thrown = true;
+		}
+		assert (thrown);
+
+		thrown = false;
+		try {
+			compile("foo(x)");
+		}
+		catch (const std::invalid_argument&) {
+			thrown = true;
+		}
+		assert (thrown);
+	}
+}
+
+#endif // _DEBUG
@@ -1,16 +1,36 @@
 // xll_function.cpp - std::function<vector<double>(const vector<double>&)> objects
 // Use allocators to avoid copying???
+#include <algorithm>
+#include <array>
 #include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "gsl/gsl_complex_math.h"
+#include "gsl/gsl_poly.h"
+#include "xll_function.h"
+#include "xll_math.h"
+#include "xll_expr.h"
+#include "xll_interp.h"
+#include "xll_memo.h"
+#include "xll_deriv.h"
 #include "xll_gsl.h"
+#include "xll_bachelier.h"
+#include "xll_black.h"
 
 using namespace xll;
 
 using function = std::function<double(double)>;
+using fdfpair = gsl::function_fdf::fdfpair;
 
-inline double udf(double regid, double x)
+// user defined function returning a two element array
+inline std::pair<double,double> udf_fdf(double regid, double x)
 {
-	// check regid???
-	return XLL_XL_(UDF, OPERX(regid), OPERX(x)).val.num;
+	OPERX y = XLL_XL_(UDF, OPERX(regid), OPERX(x));
+	ensure (y.size() == 2);
+
+	return std::make_pair(y[0].val.num, y[1].val.num);
 }
 
 static AddInX xai_function_call(
@@ -24,6 +44,7 @@ static AddInX xai_function_call(
 double WINAPI xll_std_function_call(HANDLEX f, double x)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	handlex y;
 
 	try {
@@ -32,6 +53,7 @@ double WINAPI xll_std_function_call(HANDLEX f, double x)
 		y = (*f_)(x);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 
 		return 0;
@@ -40,6 +62,39 @@ double WINAPI xll_std_function_call(HANDLEX f, double x)
 	return y;
 }
 
+static AddInX xai_function_call_array(
+	FunctionX(XLL_FPX, _T("?xll_std_function_call_array"), _T("XLL.FUNCTION.CALL.ARRAY"))
+	.Arg(XLL_HANDLEX, _T("f"), _T("is the handle of a std::function<double(double)>."))
+	.Arg(XLL_FPX, _T("x"), _T("is an array of numbers."))
+	.Category(_T("XLL"))
+	.FunctionHelp(_T("Returns f evaluated at each element of x."))
+	.Documentation(
+		_T("Native functions are evaluated over the whole array in one call. ")
+		_T("Other functions are called once for each element. ")
+	)
+);
+xfpx* WINAPI xll_std_function_call_array(HANDLEX f, const xfpx* px)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	static FPX y;
+
+	try {
+		handle<function> f_(f);
+
+		y.resize(px->rows, px->columns);
+		xll::call(*f_, size(*px), px->array, y.array());
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+
+		return 0;
+	}
+
+	return y.get();
+}
+
 static AddInX xai_function_regid(
 	FunctionX(XLL_HANDLEX, _T("?xll_function_regid"), _T("XLL.FUNCTION.REGID"))
 	.Arg(XLL_HANDLEX, _T("Regid"), _T("is the register id of functions taking a number and returning a number."))
@@ -51,6 +106,7 @@ static AddInX xai_function_regid(
 HANDLEX WINAPI xll_function_regid(double regid)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	handlex h;
 
 	try {
@@ -61,6 +117,648 @@ HANDLEX WINAPI xll_function_regid(double regid)
 		h = h_.get();
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return h;
+}
+
+static AddInX xai_function_fdf_regid(
+	FunctionX(XLL_HANDLEX, _T("?xll_function_fdf_regid"), _T("XLL.FUNCTION.FDF.REGID"))
+	.Arg(XLL_HANDLEX, _T("Regid"), _T("is the register id of a function taking a number and returning a two element array."))
+	.Uncalced()
+	.Category(_T("XLL"))
+	.FunctionHelp(_T("Return a handle to a function returning f(x) and f'(x) in one call."))
+	.Documentation(
+		_T("The function must return the value and the derivative at x in a two element array. ")
+		_T("Use this with ROOT.FDFSOLVER.SET when the value and derivative share most of their work. ")
+	)
+);
+HANDLEX WINAPI xll_function_fdf_regid(double regid)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	handlex h;
+
+	try {
+		handle<fdfpair> h_(new fdfpair([regid](double x) {
+			return udf_fdf(regid, x);
+		}));
+
+		h = h_.get();
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return h;
+}
+
+// Native functions are evaluated without calling back into Excel.
+
+static AddInX xai_function_poly(
+	FunctionX(XLL_HANDLEX, _T("?xll_function_poly"), _T("XLL.FUNCTION.POLY"))
+	.Arg(XLL_FPX, _T("Coefficients"), _T("is an array of polynomial coefficients starting with the constant term."))
+	.Uncalced()
+	.Category(_T("XLL"))
+	.FunctionHelp(_T("Return a handle to the polynomial c[0] + c[1] x + ... + c[n-1] x^(n-1)."))
+	.Documentation(_T(""))
+);
+HANDLEX WINAPI xll_function_poly(const xfpx* pc)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	handlex h;
+
+	try {
+		std::vector<double> c(pc->array, pc->array + size(*pc));
+
+		handle<function> h_(new function(native([c](double x) {
+			return gsl_poly_eval(c.data(), static_cast<int>(c.size()), x);
+		}, [c](size_t n, const double* x, double* y) {
+			// Horner's method with the loop over points innermost
+			std::fill(y, y + n, c.empty() ? 0 : c.back());
+			for (size_t k = c.size(); k-- > 1; )
+				for (size_t i = 0; i < n; ++i)
+					y[i] = c[k - 1] + x[i]*y[i];
+		}, [c](gsl_complex z) {
+			gsl_complex w = gsl_complex_rect(c.empty() ? 0 : c.back(), 0);
+			for (size_t k = c.size(); k-- > 1; )
+				w = gsl_complex_add_real(gsl_complex_mul(z, w), c[k - 1]);
+
+			return w;
+		})));
+
+		h = h_.get();
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return h;
+}
+
+XLL_ENUM_DOCX(p2h<const gsl_interp_type>(gsl_interp_linear),GSL_INTERP_LINEAR, CATEGORY, _T("Linear interpolation"), _T("Documentation"));
+XLL_ENUM_DOCX(p2h<const gsl_interp_type>(gsl_interp_polynomial),GSL_INTERP_POLYNOMIAL, CATEGORY, _T("Polynomial interpolation"), _T("Documentation"));
+XLL_ENUM_DOCX(p2h<const gsl_interp_type>(gsl_interp_cspline),GSL_INTERP_CSPLINE, CATEGORY, _T("Cubic spline with natural boundary conditions"), _T("Documentation"));
+XLL_ENUM_DOCX(p2h<const gsl_interp_type>(gsl_interp_cspline_periodic),GSL_INTERP_CSPLINE_PERIODIC, CATEGORY, _T("Cubic spline with periodic boundary conditions"), _T("Documentation"));
+XLL_ENUM_DOCX(p2h<const gsl_interp_type>(gsl_interp_akima),GSL_INTERP_AKIMA, CATEGORY, _T("Non-rounded Akima spline with natural boundary conditions"), _T("Documentation"));
+XLL_ENUM_DOCX(p2h<const gsl_interp_type>(gsl_interp_akima_periodic),GSL_INTERP_AKIMA_PERIODIC, CATEGORY, _T("Non-rounded Akima spline with periodic boundary conditions"), _T("Documentation"));
+
+static AddInX xai_function_spline(
+	FunctionX(XLL_HANDLEX, _T("?xll_function_spline"), _T("XLL.FUNCTION.SPLINE"))
+	.Arg(XLL_FPX, _T("x"), _T("is an increasing array of abscissae."))
+	.Arg(XLL_FPX, _T("y"), _T("is an array of ordinates the same size as x."))
+	.Arg(XLL_HANDLEX, _T("Type"), _T("is the interpolation type from the GSL_INTERP_* enumeration. Default is GSL_INTERP_CSPLINE."))
+	.Uncalced()
+	.Category(_T("XLL"))
+	.FunctionHelp(_T("Return a handle to a spline interpolating the points (x, y)."))
+	.Documentation(_T(""))
+);
+HANDLEX WINAPI xll_function_spline(const xfpx* px, const xfpx* py, HANDLEX type)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	handlex h;
+
+	try {
+		ensure (size(*px) == size(*py));
+		const gsl_interp_type* type_ = type ? h2p<const gsl_interp_type>(type) : gsl_interp_cspline;
+
+		gsl::interp::spline s(type_, size(*px), px->array, py->array);
+
+		handle<function> h_(new function(native(s, s)));
+
+		h = h_.get();
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return h;
+}
+
+static AddInX xai_function_affine(
+	FunctionX(XLL_HANDLEX, _T("?xll_function_affine"), _T("XLL.FUNCTION.AFFINE"))
+	.Arg(XLL_DOUBLEX, _T("a"), _T("is the constant term."))
+	.Arg(XLL_DOUBLEX, _T("b"), _T("is the multiplier."))
+	.Arg(XLL_HANDLEX, _T("f"), _T("is an optional function handle. Default is the identity."))
+	.Uncalced()
+	.Category(_T("XLL"))
+	.FunctionHelp(_T("Return a handle to the function a + b f(x)."))
+	.Documentation(_T(""))
+);
+HANDLEX WINAPI xll_function_affine(double a, double b, HANDLEX f)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	handlex h;
+
+	try {
+		function g;
+
+		if (f == 0) {
+			g = native([a,b](double x) {
+				return a + b*x;
+			}, [a,b](size_t n, const double* x, double* y) {
+				for (size_t i = 0; i < n; ++i)
+					y[i] = a + b*x[i];
+			}, [a,b](gsl_complex z) {
+				return gsl_complex_add_real(gsl_complex_mul_real(z, b), a);
+			});
+		}
+		else {
+			handle<function> f_(f);
+			function f__ = *f_;
+			const complex_function* pz = xll::complex(f__);
+			complex_function z;
+			if (pz) {
+				z = [a,b,fz = *pz](gsl_complex w) {
+					return gsl_complex_add_real(gsl_complex_mul_real(fz(w), b), a);
+				};
+			}
+
+			g = native([a,b,f__](double x) {
+				return a + b*f__(x);
+			}, [a,b,f__](size_t n, const double* x, double* y) {
+				xll::call(f__, n, x, y);
+				for (size_t i = 0; i < n; ++i)
+					y[i] = a + b*y[i];
+			}, z);
+		}
+
+		handle<function> h_(new function(g));
+
+		h = h_.get();
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return h;
+}
+
+// copy the functions so the result does not depend on the lifetime of the handles
+inline std::vector<function> functions(const xfpx* pf)
+{
+	std::vector<function> f;
+
+	f.reserve(size(*pf));
+	for (xword i = 0; i < size(*pf); ++i) {
+		handle<function> f_(pf->array[i]);
+		f.push_back(*f_);
+	}
+
+	return f;
+}
+
+// complex extensions of the functions if they all have one
+inline std::vector<complex_function> complex_functions(const std::vector<function>& f)
+{
+	std::vector<complex_function> z;
+
+	for (const auto& fi : f) {
+		const complex_function* pz = xll::complex(fi);
+		if (!pz)
+			return std::vector<complex_function>{};
+		z.push_back(*pz);
+	}
+
+	return z;
+}
+inline complex_function complex_sum(const std::vector<function>& f)
+{
+	std::vector<complex_function> z = complex_functions(f);
+	if (z.size() != f.size())
+		return complex_function{};
+
+	return [z](gsl_complex w) {
+		gsl_complex y = gsl_complex_rect(0, 0);
+
+		for (const auto& zi : z)
+			y = gsl_complex_add(y, zi(w));
+
+		return y;
+	};
+}
+inline complex_function complex_product(const std::vector<function>& f)
+{
+	std::vector<complex_function> z = complex_functions(f);
+	if (z.size() != f.size())
+		return complex_function{};
+
+	return [z](gsl_complex w) {
+		gsl_complex y = gsl_complex_rect(1, 0);
+
+		for (const auto& zi : z)
+			y = gsl_complex_mul(y, zi(w));
+
+		return y;
+	};
+}
+
+static AddInX xai_function_sum(
+	FunctionX(XLL_HANDLEX, _T("?xll_function_sum"), _T("XLL.FUNCTION.SUM"))
+	.Arg(XLL_FPX, _T("Functions"), _T("is an array of function handles."))
+	.Uncalced()
+	.Category(_T("XLL"))
+	.FunctionHelp(_T("Return a handle to the sum of functions."))
+	.Documentation(_T(""))
+);
+HANDLEX WINAPI xll_function_sum(const xfpx* pf)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	handlex h;
+
+	try {
+		std::vector<function> f = functions(pf);
+
+		handle<function> h_(new function(native([f](double x) {
+			double y = 0;
+
+			for (const auto& fi : f)
+				y += fi(x);
+
+			return y;
+		}, [f](size_t n, const double* x, double* y) {
+			std::vector<double> yi(n);
+
+			std::fill(y, y + n, 0.);
+			for (const auto& fi : f) {
+				xll::call(fi, n, x, yi.data());
+				for (size_t i = 0; i < n; ++i)
+					y[i] += yi[i];
+			}
+		}, complex_sum(f))));
+
+		h = h_.get();
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return h;
+}
+
+static AddInX xai_function_product(
+	FunctionX(XLL_HANDLEX, _T("?xll_function_product"), _T("XLL.FUNCTION.PRODUCT"))
+	.Arg(XLL_FPX, _T("Functions"), _T("is an array of function handles."))
+	.Uncalced()
+	.Category(_T("XLL"))
+	.FunctionHelp(_T("Return a handle to the product of functions."))
+	.Documentation(_T(""))
+);
+HANDLEX WINAPI xll_function_product(const xfpx* pf)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	handlex h;
+
+	try {
+		std::vector<function> f = functions(pf);
+
+		handle<function> h_(new function(native([f](double x) {
+			double y = 1;
+
+			for (const auto& fi : f)
+				y *= fi(x);
+
+			return y;
+		}, [f](size_t n, const double* x, double* y) {
+			std::vector<double> yi(n);
+
+			std::fill(y, y + n, 1.);
+			for (const auto& fi : f) {
+				xll::call(fi, n, x, yi.data());
+				for (size_t i = 0; i < n; ++i)
+					y[i] *= yi[i];
+			}
+		}, complex_product(f))));
+
+		h = h_.get();
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return h;
+}
+
+static AddInX xai_function_compose(
+	FunctionX(XLL_HANDLEX, _T("?xll_function_compose"), _T("XLL.FUNCTION.COMPOSE"))
+	.Arg(XLL_HANDLEX, _T("f"), _T("is the outer function handle."))
+	.Arg(XLL_HANDLEX, _T("g"), _T("is the inner function handle."))
+	.Uncalced()
+	.Category(_T("XLL"))
+	.FunctionHelp(_T("Return a handle to the function f(g(x))."))
+	.Documentation(_T(""))
+);
+HANDLEX WINAPI xll_function_compose(HANDLEX f, HANDLEX g)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	handlex h;
+
+	try {
+		handle<function> f_(f);
+		handle<function> g_(g);
+		function f__ = *f_, g__ = *g_;
+		const complex_function* pf = xll::complex(f__);
+		const complex_function* pg = xll::complex(g__);
+		complex_function z;
+		if (pf && pg) {
+			z = [fz = *pf, gz = *pg](gsl_complex w) {
+				return fz(gz(w));
+			};
+		}
+
+		handle<function> h_(new function(native([f__,g__](double x) {
+			return f__(g__(x));
+		}, [f__,g__](size_t n, const double* x, double* y) {
+			std::vector<double> gx(n);
+
+			xll::call(g__, n, x, gx.data());
+			xll::call(f__, n, gx.data(), y);
+		}, z)));
+
+		h = h_.get();
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return h;
+}
+
+// option pricing parameter that varies
+XLL_ENUM_DOCX(0, XLL_PARAM_FORWARD, _T("XLL"), _T("Index of the forward parameter."), _T(""));
+XLL_ENUM_DOCX(1, XLL_PARAM_VOLATILITY, _T("XLL"), _T("Index of the volatility parameter."), _T(""));
+XLL_ENUM_DOCX(2, XLL_PARAM_STRIKE, _T("XLL"), _T("Index of the strike parameter."), _T(""));
+XLL_ENUM_DOCX(3, XLL_PARAM_EXPIRATION, _T("XLL"), _T("Index of the expiration parameter."), _T(""));
+
+// f(x) = put(p) where p[i] = x
+template<class Put>
+inline function put_function(Put put, double f, double sigma, double k, double t, WORD i)
+{
+	ensure (i < 4);
+	std::array<double,4> p = {f, sigma, k, t};
+
+	return native([put,p,i](double x) {
+		std::array<double,4> p_(p);
+		p_[i] = x;
+
+		return put(p_[0], p_[1], p_[2], p_[3]);
+	}, [put,p,i](size_t n, const double* x, double* y) {
+		std::array<double,4> p_(p);
+
+		for (size_t j = 0; j < n; ++j) {
+			p_[i] = x[j];
+			y[j] = put(p_[0], p_[1], p_[2], p_[3]);
+		}
+	});
+}
+
+static AddInX xai_function_black_put(
+	FunctionX(XLL_HANDLEX, _T("?xll_function_black_put"), _T("XLL.FUNCTION.BLACK.PUT"))
+	.Arg(XLL_DOUBLEX, _T("f"), _T("is the forward."))
+	.Arg(XLL_DOUBLEX, _T("sigma"), _T("is the volatility."))
+	.Arg(XLL_DOUBLEX, _T("k"), _T("is the strike."))
+	.Arg(XLL_DOUBLEX, _T("t"), _T("is the time in years to expiration."))
+	.Arg(XLL_WORDX, _T("Param"), _T("is the parameter to vary from the XLL_PARAM_* enumeration."))
+	.Uncalced()
+	.Category(_T("XLL"))
+	.FunctionHelp(_T("Return a handle to the Black put value as a function of one parameter."))
+	.Documentation(_T("The argument corresponding to Param is ignored. "))
+);
+HANDLEX WINAPI xll_function_black_put(double f, double sigma, double k, double t, WORD i)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	handlex h;
+
+	try {
+		handle<function> h_(new function(put_function([](double f, double s, double k, double t) {
+			return black_put_value(f, s, k, t);
+		}, f, sigma, k, t, i)));
+
+		h = h_.get();
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return h;
+}
+
+static AddInX xai_function_bachelier_put(
+	FunctionX(XLL_HANDLEX, _T("?xll_function_bachelier_put"), _T("XLL.FUNCTION.BACHELIER.PUT"))
+	.Arg(XLL_DOUBLEX, _T("f"), _T("is the forward."))
+	.Arg(XLL_DOUBLEX, _T("sigma"), _T("is the volatility."))
+	.Arg(XLL_DOUBLEX, _T("k"), _T("is the strike."))
+	.Arg(XLL_DOUBLEX, _T("t"), _T("is the time in years to expiration."))
+	.Arg(XLL_WORDX, _T("Param"), _T("is the parameter to vary from the XLL_PARAM_* enumeration."))
+	.Uncalced()
+	.Category(_T("XLL"))
+	.FunctionHelp(_T("Return a handle to the Bachelier put value as a function of one parameter."))
+	.Documentation(_T("The argument corresponding to Param is ignored. "))
+);
+HANDLEX WINAPI xll_function_bachelier_put(double f, double sigma, double k, double t, WORD i)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	handlex h;
+
+	try {
+		handle<function> h_(new function(put_function(bachelier_put, f, sigma, k, t, i)));
+
+		h = h_.get();
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return h;
+}
+
+// expressions are plain ASCII
+inline std::string narrow(const xchar* s)
+{
+	std::string s_;
+
+	while (*s)
+		s_.push_back(static_cast<char>(*s++));
+
+	return s_;
+}
+inline std::string narrow(const XLOPERX& o)
+{
+	ensure (o.xltype == xltypeStr);
+
+	return std::string(o.val.str + 1, o.val.str + 1 + o.val.str[0]);
+}
+
+static AddInX xai_function_expr(
+	FunctionX(XLL_HANDLEX, _T("?xll_function_expr"), _T("XLL.FUNCTION.EXPR"))
+	.Arg(XLL_CSTRINGX, _T("Expr"), _T("is an arithmetic expression in x such as \"exp(-x)*x^2 - a\"."))
+	.Arg(XLL_LPOPERX, _T("Names"), _T("is an optional array of parameter names used in Expr."))
+	.Arg(XLL_FPX, _T("Values"), _T("is an array of parameter values corresponding to Names."))
+	.Uncalced()
+	.Category(_T("XLL"))
+	.FunctionHelp(_T("Return a handle to a function of x compiled from an expression."))
+	.Documentation(
+		_T("Expressions use <codeInline>+ - * / ^</codeInline>, parentheses, numbers, <codeInline>pi</codeInline> and the functions ")
+		_T("<codeInline>exp log sqrt abs sin cos tan erf pow min max</codeInline>. ")
+		_T("Parameters are folded into the compiled program as constants and repeated subexpressions are only evaluated once. ")
+	)
+);
+HANDLEX WINAPI xll_function_expr(const xchar* expr, const LPOPERX pnames, const xfpx* pvalues)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	handlex h;
+
+	try {
+		std::map<std::string,double> params;
+		const OPERX& names = *pnames;
+
+		if (names.xltype != xltypeMissing && names.xltype != xltypeNil) {
+			ensure (names.size() == size(*pvalues));
+			for (xword i = 0; i < names.size(); ++i)
+				params[narrow(names[i])] = pvalues->array[i];
+		}
+
+		xll::expr::program f = xll::expr::compile(narrow(expr), params);
+
+		handle<function> h_(new function(native(f, f, f)));
+
+		h = h_.get();
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return h;
+}
+
+static AddInX xai_function_memo(
+	FunctionX(XLL_HANDLEX, _T("?xll_function_memo"), _T("XLL.FUNCTION.MEMO"))
+	.Arg(XLL_HANDLEX, _T("f"), _T("is a function handle."))
+	.Arg(XLL_LONGX, _T("Capacity"), _T("is the maximum number of values to remember. Default is 1024"), 1024)
+	.Uncalced()
+	.Category(_T("XLL"))
+	.FunctionHelp(_T("Return a handle to f that remembers the most recently used values."))
+	.Documentation(
+		_T("Calling the handle with an argument it has already seen returns the stored value ")
+		_T("instead of calling f. When Capacity values are stored the least recently used is discarded. ")
+		_T("Use XLL.FUNCTION.MEMO.STATS to see how many evaluations were saved. ")
+	)
+);
+HANDLEX WINAPI xll_function_memo(HANDLEX f, LONG capacity)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	handlex h;
+
+	try {
+		if (capacity <= 0)
+			capacity = 1024;
+
+		handle<function> f_(f);
+
+		handle<function> h_(new function(xll::memo(*f_, capacity)));
+
+		h = h_.get();
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return h;
+}
+
+static AddInX xai_function_memo_stats(
+	FunctionX(XLL_FPX, _T("?xll_function_memo_stats"), _T("XLL.FUNCTION.MEMO.STATS"))
+	.Arg(XLL_HANDLEX, _T("f"), _T("is a handle returned by XLL.FUNCTION.MEMO."))
+	.Volatile()
+	.Category(_T("XLL"))
+	.FunctionHelp(_T("Return a one row array of hits, misses, size and capacity of a memoized function."))
+	.Documentation(_T(""))
+);
+xfpx* WINAPI xll_function_memo_stats(HANDLEX f)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	static FPX x(1, 4);
+
+	try {
+		handle<function> f_(f);
+		const xll::memo* pf = f_->target<xll::memo>();
+		ensure (pf || !"XLL.FUNCTION.MEMO.STATS: not a handle returned by XLL.FUNCTION.MEMO");
+
+		x[0] = static_cast<double>(pf->hits());
+		x[1] = static_cast<double>(pf->misses());
+		x[2] = static_cast<double>(pf->size());
+		x[3] = static_cast<double>(pf->capacity());
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+
+		return 0;
+	}
+
+	return x.get();
+}
+
+static AddInX xai_function_deriv(
+	FunctionX(XLL_HANDLEX, _T("?xll_function_deriv"), _T("XLL.FUNCTION.DERIV"))
+	.Arg(XLL_HANDLEX, _T("f"), _T("is a function handle."))
+	.Arg(XLL_DOUBLEX, _T("h"), _T("is the optional step size."))
+	.Uncalced()
+	.Category(_T("XLL"))
+	.FunctionHelp(_T("Return a handle to the derivative of f."))
+	.Documentation(
+		_T("If f has a complex extension the derivative is Im f(x + ih)/h. This takes one evaluation ")
+		_T("per point and is accurate to rounding since there is no subtraction. The default step is 1e-20. ")
+		_T("Polynomial, expression, and affine, sum, product or composition handles of these have complex extensions. ")
+		_T("Otherwise GSL central differences are used with a default step of 1e-8. ")
+	)
+);
+HANDLEX WINAPI xll_function_deriv(HANDLEX f, double dx)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	handlex h;
+
+	try {
+		handle<function> f_(f);
+		const complex_function* pz = xll::complex(*f_);
+		function df;
+
+		if (pz)
+			df = gsl::deriv::complex_step(*pz, dx ? dx : 1e-20);
+		else
+			df = gsl::deriv::central(*f_, dx ? dx : 1e-8);
+
+		handle<function> d_(new function(df));
+
+		h = d_.get();
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -74,6 +772,20 @@ static AddInX xai_foo(
 double WINAPI xll_foo(double x)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 
 	return x*x - 5;
 }
+
+#ifdef _DEBUG
+
+XLL_TEST_BEGIN(xll_test_function)
+
+	test_xll_native();
+	test_gsl_interp_spline();
+	test_xll_expr();
+	test_xll_memo();
+
+XLL_TEST_END(xll_test_function)
+
+#endif // _DEBUG
@@ -1,6 +1,8 @@
 // xll_function.h - wrappers for std::function
 #pragma once
 #include <functional>
+#include <vector>
+#include "gsl/gsl_complex.h"
 //#define EXCEL12
 #include "../xll8/xll/xll.h"
 
@@ -12,4 +14,107 @@ namespace xll {
 		return XLL_XL_(UDF, OPERX(regid), OPERX(x)).val.num;
 	}
 
-}
\ No newline at end of file
+	// y[i] = f(x[i]) for 0 <= i < n
+	using batch_function = std::function<void(size_t n, const double* x, double* y)>;
+
+	// f extended to complex arguments, used for complex step derivatives
+	using complex_function = std::function<gsl_complex(gsl_complex)>;
+
+	// function with a batch implementation and optionally a complex extension
+	// Handles store these as std::function<double(double)> so scalar callers are unaffected.
+	// Batch callers recover the native object using std::function::target.
+	class native {
+		std::function<double(double)> f;
+		batch_function g;
+		complex_function h;
+	public:
+		native(const std::function<double(double)>& f, const batch_function& g, const complex_function& h = complex_function{})
+			: f(f), g(g), h(h)
+		{ }
+
+		double operator()(double x) const
+		{
+			return f(x);
+		}
+		void operator()(size_t n, const double* x, double* y) const
+		{
+			g(n, x, y);
+		}
+		// null if there is no complex extension
+		const complex_function* complex() const
+		{
+			return h ? &h : nullptr;
+		}
+	};
+
+	// complex extension of f if it has one
+	inline const complex_function* complex(const std::function<double(double)>& f)
+	{
+		const native* pf = f.target<native>();
+
+		return pf ? pf->complex() : nullptr;
+	}
+
+	// evaluate f at n points using the batch implementation if there is one
+	inline void call(const std::function<double(double)>& f, size_t n, const double* x, double* y)
+	{
+		const native* pf = f.target<native>();
+
+		if (pf) {
+			(*pf)(n, x, y);
+		}
+		else {
+			for (size_t i = 0; i < n; ++i)
+				y[i] = f(x[i]);
+		}
+	}
+
+}
+
+#ifdef _DEBUG
+#include <cassert>
+
+inline void test_xll_native()
+{
+	int nscalar = 0, nbatch = 0;
+	xll::native f([&nscalar](double x) {
+		++nscalar;
+		return 2*x;
+	}, [&nbatch](size_t n, const double* x, double* y) {
+		++nbatch;
+		for (size_t i = 0; i < n; ++i)
+			y[i] = 2*x[i];
+	});
+
+	double x[] = {1, 2, 3}, y[3];
+	std::function<double(double)> g = f;
+	xll::call(g, 3, x, y);
+	assert (nbatch == 1 && nscalar == 0);
+	assert (y[0] == 2 && y[1] == 4 && y[2] == 6);
+
+	assert (g(4) == 8 && nscalar == 1);
+
+	// scalar functions are called once per point
+	std::function<double(double)> h = [&nscalar](double x) {
+		++nscalar;
+		return x + 1;
+	};
+	xll::call(h, 3, x, y);
+	assert (nscalar == 4);
+	assert (y[0] == 2 && y[1] == 3 && y[2] == 4);
+
+	assert (xll::complex(g) == nullptr);
+	assert (xll::complex(h) == nullptr);
+	std::function<double(double)> k = xll::native(h, [](size_t, const double*, double*) { }, [](gsl_complex z) {
+		z.dat[0] += 1;
+		return z;
+	});
+	assert (xll::complex(k) != nullptr);
+	gsl_complex z;
+	z.dat[0] = 1;
+	z.dat[1] = 2;
+	z = (*xll::complex(k))(z);
+	assert (z.dat[0] == 2 && z.dat[1] == 2);
+}
+
+#endif // _DEBUG
@@ -16,6 +16,7 @@ void xll_error_handler (const char * reason,
 
 	sprintf_s(buf, 255, "GSL error (%d) reason: \"%s\"\nfile: %s line: %d", gsl_errno, reason, file, line);
 
+	XLL_PROFILE_ERROR;
 	XLL_ERROR(buf);
 }
 
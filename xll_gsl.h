@@ -7,6 +7,7 @@
 #include "gsl/gsl_complex.h"
 //#define EXCEL12
 #include "xll/xll.h"
+#include "xll_profile.h"
 
 #define CATEGORY _T("GSL")
 #define PREFIX CATEGORY _T(".")
@@ -0,0 +1,103 @@
+// xll_interp.h - GSL interpolation
+// http://www.gnu.org/software/gsl/manual/html_node/Interpolation.html
+#pragma once
+#include <memory>
+#include <stdexcept>
+#include "gsl/gsl_errno.h"
+#include "gsl/gsl_spline.h"
+
+namespace gsl {
+
+namespace interp {
+
+	// interpolating spline through the points (x[i], y[i])
+	// Copies share the underlying gsl_spline so this can be used as a std::function<double(double)>.
+	class spline {
+		std::shared_ptr<gsl_spline> s;
+	public:
+		spline(const gsl_interp_type* type, size_t n, const double* x, const double* y)
+			: s(gsl_spline_alloc(type, n), &::gsl_spline_free)
+		{
+			if (!s)
+				throw std::runtime_error(__FILE__ ": " __FUNCTION__ ": gsl_spline_alloc failed");
+
+			if (GSL_SUCCESS != gsl_spline_init(s.get(), x, y, n))
+				throw std::runtime_error(__FILE__ ": " __FUNCTION__ ": gsl_spline_init failed");
+		}
+
+		// needed for gsl_spline_* routines
+		gsl_spline* get() const
+		{
+			return s.get();
+		}
+		// syntactic sugar
+		operator gsl_spline*() const
+		{
+			return get();
+		}
+
+		// No accelerator so evaluation does not modify state.
+		double operator()(double x) const
+		{
+			return gsl_spline_eval(s.get(), x, nullptr);
+		}
+		// An accelerator local to the call speeds up lookups of nearby points.
+		void operator()(size_t n, const double* x, double* y) const
+		{
+			std::unique_ptr<gsl_interp_accel,decltype(&::gsl_interp_accel_free)> a(gsl_interp_accel_alloc(), &::gsl_interp_accel_free);
+
+			for (size_t i = 0; i < n; ++i)
+				y[i] = gsl_spline_eval(s.get(), x[i], a.get());
+		}
+		double deriv(double x) const
+		{
+			return gsl_spline_eval_deriv(s.get(), x, nullptr);
+		}
+		double deriv2(double x) const
+		{
+			return gsl_spline_eval_deriv2(s.get(), x, nullptr);
+		}
+		double integ(double a, double b) const
+		{
+			return gsl_spline_eval_integ(s.get(), a, b, nullptr);
+		}
+	};
+
+} // interp
+
+} // gsl
+
+#ifdef _DEBUG
+#include <cassert>
+#include <cmath>
+#include <functional>
+
+inline void test_gsl_interp_spline()
+{
+	{
+		double x[] = {0, 1, 2, 3};
+		double y[] = {1, 3, 5, 7};
+		gsl::interp::spline s(gsl_interp_linear, 4, x, y);
+		assert (s(0) == 1);
+		assert (s(0.5) == 2);
+		assert (s(3) == 7);
+		assert (s.deriv(1.5) == 2);
+
+		std::function<double(double)> f = s;
+		assert (f(2.5) == 6);
+
+		double xi[] = {0.5, 1.5, 2.5}, yi[3];
+		s(3, xi, yi);
+		assert (yi[0] == 2 && yi[1] == 4 && yi[2] == 6);
+	}
+	{
+		double x[] = {0, 1, 2, 3, 4};
+		double y[] = {0, 1, 4, 9, 16};
+		gsl::interp::spline s(gsl_interp_cspline, 5, x, y);
+		for (int i = 0; i < 5; ++i)
+			assert (fabs(s(x[i]) - y[i]) < 1e-12);
+		assert (fabs(s(2.5) - 6.25) < 0.1);
+	}
+}
+
+#endif // _DEBUG
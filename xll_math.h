@@ -1,6 +1,8 @@
 // xll_math.h - wrappers for gsl_math.h to make value-type functions usable in the GSL
 #pragma once
 #include <functional>
+#include <tuple>
+#include <utility>
 #include "gsl/gsl_math.h"
 
 namespace gsl {
@@ -63,32 +65,35 @@ namespace gsl {
 	};
 
 	class function_fdf {
+	public:
 		// function and its derivative
 		using function = std::function<double(double)>;
 		using fdfunction = std::tuple<function,function>;
-
+		// function and its derivative computed together
+		using fdfpair = std::function<std::pair<double,double>(double)>;
+	private:
 		gsl_function_fdf _fdf;
-		fdfunction fdf;
+		std::tuple<function,function,fdfpair> fdf;
 
 		// provide pointers for gsl_function_fdf
 		static double static_f(double x, void* params)
 		{
-			const fdfunction& f = *static_cast<fdfunction*>(params);
+			const auto& f = *static_cast<std::tuple<function,function,fdfpair>*>(params);
 
 			return std::get<0>(f)(x);
 		}
 		static double static_df(double x, void* params)
 		{
-			const fdfunction& f = *static_cast<fdfunction*>(params);
+			const auto& f = *static_cast<std::tuple<function,function,fdfpair>*>(params);
 
 			return std::get<1>(f)(x);
 		}
+		// one call to shared code instead of separate f and df calls
 		static void static_fdf(double x, void* params, double* fx, double* dfx)
 		{
-			const fdfunction& f = *static_cast<fdfunction*>(params);
+			const auto& f = *static_cast<std::tuple<function,function,fdfpair>*>(params);
 
-			*fx = std::get<0>(f)(x);
-			*dfx = std::get<1>(f)(x);
+			std::tie(*fx, *dfx) = std::get<2>(f)(x);
 		}
 	public:
 		function_fdf()
@@ -96,16 +101,29 @@ namespace gsl {
 			_fdf.f = static_f;
 			_fdf.df = static_df;
 			_fdf.fdf = static_fdf;
+			_fdf.params = &fdf;
 		}
 		function_fdf(const fdfunction& F)
 			: function_fdf()
 		{
-			fdf = F;
-			_fdf.params = &fdf;
+			function f = std::get<0>(F), df = std::get<1>(F);
+
+			fdf = std::make_tuple(f, df, [f,df](double x) { return std::make_pair(f(x), df(x)); });
+		}
+		function_fdf(const fdfpair& FdF)
+			: function_fdf()
+		{
+			fdf = std::make_tuple(
+				[FdF](double x) { return FdF(x).first; },
+				[FdF](double x) { return FdF(x).second; },
+				FdF
+			);
 		}
 		function_fdf(const function_fdf& F)
-			: function_fdf(F.fdf)
-		{ }
+			: function_fdf()
+		{
+			fdf = F.fdf;
+		}
 		function_fdf(const function& f_, const function& df_)
 			: function_fdf(std::make_tuple(f_, df_))
 		{ }
@@ -186,6 +204,25 @@ inline void test_xll_math()
 		assert (y == 4);
 		assert (dy == 4);
 	}
+	{
+		int calls = 0;
+		auto fdf = [&calls](double x) { ++calls; return std::make_pair(x*x, 2*x); };
+
+		gsl::function_fdf g(fdf);
+		gsl::function_fdf h;
+		h = g;
+
+		double y, dy;
+		GSL_FN_FDF_EVAL_F_DF(&h, 3, &y, &dy);
+		assert (y == 9);
+		assert (dy == 6);
+		assert (calls == 1);
+
+		assert (GSL_FN_FDF_EVAL_F(&h, 2) == 4);
+		assert (GSL_FN_FDF_EVAL_DF(&h, 2) == 4);
+		h.call(1, y, dy);
+		assert (y == 1 && dy == 2);
+	}
 }
 
 #endif // _DEBUG
\ No newline at end of file
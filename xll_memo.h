@@ -0,0 +1,247 @@
+// xll_memo.h - remember the most recent values of an expensive function
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace xll {
+
+	// least recently used cache of f(x) with a fixed capacity
+	// Lookups use an open addressing hash table with linear probing on the bits of x.
+	// Copies share the cache so this can be used as a std::function<double(double)>.
+	class memo {
+		enum : std::uint32_t { none = 0xFFFFFFFF };
+
+		struct entry {
+			double x, y;
+			std::uint32_t prev, next; // least recently used list
+		};
+
+		struct cache {
+			std::vector<entry> entries;
+			std::vector<std::uint32_t> table; // index into entries or none
+			std::uint32_t head = none, tail = none; // most and least recently used
+			size_t capacity, hits = 0, misses = 0;
+			std::mutex m;
+
+			cache(size_t capacity)
+				: capacity(capacity)
+			{
+				size_t n = 2;
+				while (n < 2*capacity)
+					n *= 2;
+
+				entries.reserve(capacity);
+				table.resize(n, none);
+			}
+
+			static std::uint64_t hash(double x)
+			{
+				std::uint64_t h;
+				std::memcpy(&h, &x, sizeof(h));
+
+				// splitmix64 finalizer
+				h ^= h >> 30;
+				h *= 0xbf58476d1ce4e5b9ULL;
+				h ^= h >> 27;
+				h *= 0x94d049bb133111ebULL;
+				h ^= h >> 31;
+
+				return h;
+			}
+			static bool same(double a, double b)
+			{
+				return std::memcmp(&a, &b, sizeof(double)) == 0;
+			}
+			size_t mask() const
+			{
+				return table.size() - 1;
+			}
+
+			// table slot holding x or the empty slot where it belongs
+			size_t find(double x) const
+			{
+				size_t i = hash(x) & mask();
+
+				while (table[i] != none && !same(entries[table[i]].x, x))
+					i = (i + 1) & mask();
+
+				return i;
+			}
+			// remove slot i and shift later entries of the probe sequence back
+			void erase(size_t i)
+			{
+				size_t j = i;
+
+				for (;;) {
+					table[i] = none;
+					for (;;) {
+						j = (j + 1) & mask();
+						if (table[j] == none)
+							return;
+						size_t k = hash(entries[table[j]].x) & mask();
+						// move j to i if its home slot k is not cyclically in (i, j]
+						if (i <= j ? (i >= k || k > j) : (i >= k && k > j))
+							break;
+					}
+					table[i] = table[j];
+					i = j;
+				}
+			}
+
+			void unlink(std::uint32_t e)
+			{
+				entry& x = entries[e];
+				(x.prev == none ? head : entries[x.prev].next) = x.next;
+				(x.next == none ? tail : entries[x.next].prev) = x.prev;
+			}
+			void push_front(std::uint32_t e)
+			{
+				entries[e].prev = none;
+				entries[e].next = head;
+				(head == none ? tail : entries[head].prev) = e;
+				head = e;
+			}
+
+			bool lookup(double x, double& y)
+			{
+				size_t i = find(x);
+
+				if (table[i] == none) {
+					++misses;
+
+					return false;
+				}
+
+				++hits;
+				std::uint32_t e = table[i];
+				if (e != head) {
+					unlink(e);
+					push_front(e);
+				}
+				y = entries[e].y;
+
+				return true;
+			}
+			void insert(double x, double y)
+			{
+				size_t i = find(x);
+				if (table[i] != none) // another thread got here first
+					return;
+
+				std::uint32_t e;
+				if (entries.size() < capacity) {
+					e = static_cast<std::uint32_t>(entries.size());
+					entries.push_back(entry{x, y, none, none});
+				}
+				else {
+					e = tail;
+					unlink(e);
+					erase(find(entries[e].x));
+					entries[e].x = x;
+					entries[e].y = y;
+					i = find(x);
+				}
+				table[i] = e;
+				push_front(e);
+			}
+		};
+
+		std::function<double(double)> f;
+		std::shared_ptr<cache> c;
+	public:
+		memo(const std::function<double(double)>& f, size_t capacity = 1024)
+			: f(f), c(std::make_shared<cache>(capacity))
+		{
+			if (capacity == 0)
+				throw std::invalid_argument("xll::memo: capacity must be positive");
+		}
+
+		// The lock is not held while f is called.
+		double operator()(double x) const
+		{
+			double y;
+			{
+				std::lock_guard<std::mutex> lock(c->m);
+				if (c->lookup(x, y))
+					return y;
+			}
+
+			y = f(x);
+
+			std::lock_guard<std::mutex> lock(c->m);
+			c->insert(x, y);
+
+			return y;
+		}
+
+		size_t hits() const
+		{
+			std::lock_guard<std::mutex> lock(c->m);
+
+			return c->hits;
+		}
+		size_t misses() const
+		{
+			std::lock_guard<std::mutex> lock(c->m);
+
+			return c->misses;
+		}
+		size_t size() const
+		{
+			std::lock_guard<std::mutex> lock(c->m);
+
+			return c->entries.size();
+		}
+		size_t capacity() const
+		{
+			return c->capacity;
+		}
+	};
+
+} // xll
+
+#ifdef _DEBUG
+#include <cassert>
+
+inline void test_xll_memo()
+{
+	{
+		int n = 0;
+		xll::memo f([&n](double x) { ++n; return x*x; }, 3);
+		assert (f(1) == 1 && f(2) == 4 && f(3) == 9);
+		assert (n == 3 && f.misses() == 3 && f.hits() == 0);
+		assert (f(1) == 1); // 1 is most recently used
+		assert (n == 3 && f.hits() == 1);
+		assert (f(4) == 16); // evicts 2
+		assert (n == 4 && f.size() == 3);
+		assert (f(1) == 1 && f(3) == 9 && f(4) == 16);
+		assert (n == 4);
+		assert (f(2) == 4);
+		assert (n == 5);
+
+		std::function<double(double)> g = f;
+		assert (g(2) == 4);
+		assert (n == 5);
+	}
+	{
+		// many evictions keep the table consistent
+		int n = 0;
+		xll::memo f([&n](double x) { ++n; return 2*x; }, 17);
+		for (int i = 0; i < 1000; ++i)
+			assert (f(i % 50) == 2*(i % 50));
+		for (int i = 0; i < 17; ++i)
+			assert (f(999 % 50 - i) == 2*(999 % 50 - i));
+		assert (f.size() == 17);
+		size_t m = f.misses();
+		for (int i = 0; i < 17; ++i)
+			f(999 % 50 - i);
+		assert (f.misses() == m);
+	}
+}
+
+#endif // _DEBUG
@@ -0,0 +1,162 @@
+// xll_multifit.cpp - GSL nonlinear least-squares fitting
+#include <algorithm>
+#include "xll_multifit.h"
+#include "xll_gsl.h"
+
+using namespace xll;
+
+using function = gsl::multifit::function;
+using jacobian = gsl::multifit::jacobian;
+
+static AddInX xai_multifit_function_regid(
+	FunctionX(XLL_HANDLEX, _T("?xll_multifit_function_regid"), PREFIX _T("MULTIFIT.FUNCTION.REGID"))
+	.Arg(XLL_HANDLEX, _T("Regid"), _T("is the register id of a function taking an array of parameters and returning an array of residuals."))
+	.Arg(XLL_WORDX, _T("n"), _T("is the number of residuals."))
+	.Uncalced()
+	.Category(CATEGORY)
+	.FunctionHelp(_T("Return a handle to a function from R^p to R^n."))
+	.Documentation(_T(""))
+);
+HANDLEX WINAPI xll_multifit_function_regid(double regid, WORD n)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	handlex h;
+
+	try {
+		handle<function> h_(new function([regid,n](size_t p, const double* x, double* f) {
+			OPERX x_(static_cast<xword>(p), 1);
+			for (xword j = 0; j < x_.size(); ++j)
+				x_[j] = x[j];
+
+			OPERX f_ = XLL_XL_(UDF, OPERX(regid), x_);
+			ensure (f_.size() == n);
+
+			for (xword i = 0; i < f_.size(); ++i)
+				f[i] = f_[i].val.num;
+		}));
+
+		h = h_.get();
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return h;
+}
+
+XLL_ENUM_DOCX(p2h<const gsl_multifit_fdfsolver_type>(gsl_multifit_fdfsolver_lmsder),GSL_MULTIFIT_FDFSOLVER_LMSDER, CATEGORY, _T("Scaled Levenberg-Marquardt solver"), _T("Documentation"));
+XLL_ENUM_DOCX(p2h<const gsl_multifit_fdfsolver_type>(gsl_multifit_fdfsolver_lmder),GSL_MULTIFIT_FDFSOLVER_LMDER, CATEGORY, _T("Unscaled Levenberg-Marquardt solver"), _T("Documentation"));
+
+static AddInX xai_multifit_nlin(
+	FunctionX(XLL_FPX, _T("?xll_multifit_nlin"), PREFIX _T("MULTIFIT.NLIN"))
+	.Arg(XLL_HANDLEX, _T("f"), _T("is a handle to the residuals returned by ") PREFIX _T("MULTIFIT.FUNCTION.REGID"))
+	.Arg(XLL_WORDX, _T("n"), _T("is the number of residuals."))
+	.Arg(XLL_FPX, _T("x"), _T("is the initial guess of the p parameters."))
+	.Arg(XLL_HANDLEX, _T("Jacobian"), _T("is an optional handle to the Jacobian returning a row major n x p array."))
+	.Arg(XLL_FPX, _T("Weights"), _T("is an optional array of n non-negative weights."))
+	.Arg(XLL_HANDLEX, _T("Type"), _T("is the type of solver from the GSL_MULTIFIT_FDFSOLVER_* enumeration. Default is LMSDER"))
+	.Arg(XLL_FPX, _T("h"), _T("is an optional array of finite difference steps for each parameter or a single step for all"))
+	.Arg(XLL_BOOLX, _T("Parallel"), _T("evaluates finite difference columns in parallel if true. Default is false"))
+	.Arg(XLL_DOUBLEX, _T("Epsabs"), _T("is the absolute step tolerance. Default is 1e-8"), 1e-8)
+	.Arg(XLL_DOUBLEX, _T("Epsrel"), _T("is the relative step tolerance. Default is 1e-8"), 1e-8)
+	.Arg(XLL_LONGX, _T("Maxiter"), _T("is the maximum number of iterations. Default is 500"), 500)
+	.Category(CATEGORY)
+	.FunctionHelp(_T("Minimize the weighted sum of squared residuals and return parameters, covariance and statistics."))
+	.Documentation(
+		_T("The first row of the result contains the fitted parameters. The next p rows are the ")
+		_T("p x p covariance matrix of the parameters. The last row is chi squared, degrees of freedom n - p, ")
+		_T("the number of iterations and the GSL status of the last iteration. ")
+		_T("The result has at least four columns and unused cells are zero. ")
+		_T("If Weights are missing the covariance is scaled by chi squared over the degrees of freedom. ")
+		_T("If Jacobian is missing then it is computed by forward differences. ")
+		_T("Only set Parallel if the function can be called from several threads at once; ")
+		_T("functions calling back into Excel can not. ")
+	)
+);
+xfpx* WINAPI xll_multifit_nlin(HANDLEX f, WORD n, const xfpx* px, HANDLEX df, const xfpx* pw,
+	HANDLEX type, const xfpx* ph, BOOL parallel, double epsabs, double epsrel, LONG maxiter)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	static FPX x;
+
+	try {
+		if (epsabs <= 0)
+			epsabs = 1e-8;
+		if (epsrel <= 0)
+			epsrel = 1e-8;
+		if (maxiter <= 0)
+			maxiter = 500;
+
+		size_t p = size(*px);
+		ensure (n >= p);
+
+		const double* w = nullptr;
+		if (size(*pw) > 1 || pw->array[0] != 0) {
+			ensure (size(*pw) == n);
+			w = pw->array;
+		}
+
+		const gsl_multifit_fdfsolver_type* T = type ? h2p<const gsl_multifit_fdfsolver_type>(type) : gsl_multifit_fdfsolver_lmsder;
+		gsl::multifit::fdfsolver s(T, n, p);
+		handle<function> f_(f);
+
+		if (df == 0) {
+			std::vector<double> h;
+			if (size(*ph) > 1 || ph->array[0] > 0) {
+				ensure (size(*ph) == 1 || size(*ph) == p);
+				h.assign(ph->array, ph->array + size(*ph));
+			}
+
+			ensure (GSL_SUCCESS == s.set(*f_, p, px->array, w, h, parallel != 0));
+		}
+		else {
+			handle<jacobian> df_(df);
+
+			ensure (GSL_SUCCESS == s.set(*f_, *df_, p, px->array, w));
+		}
+
+		size_t iter = s.solve(gsl::multifit::test_delta(epsabs, epsrel), maxiter);
+
+		size_t c = (std::max)(p, size_t(4));
+		x.resize(static_cast<xword>(p + 2), static_cast<xword>(c));
+		std::fill(x.begin(), x.end(), 0.);
+
+		std::copy(s.x(), s.x() + p, x.begin());
+
+		std::vector<double> C(p*p);
+		s.covariance(C.data());
+		double chisq = s.chisq();
+		double dof = static_cast<double>(n - p);
+		double scale = (w || dof == 0) ? 1 : chisq/dof;
+		for (size_t i = 0; i < p; ++i)
+			for (size_t j = 0; j < p; ++j)
+				x[static_cast<xword>((i + 1)*c + j)] = scale*C[i*p + j];
+
+		xword r = static_cast<xword>((p + 1)*c);
+		x[r] = chisq;
+		x[r + 1] = dof;
+		x[r + 2] = static_cast<double>(iter);
+		x[r + 3] = s.status();
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+
+		return 0;
+	}
+
+	return x.get();
+}
+
+#ifdef _DEBUG
+
+XLL_TEST_BEGIN(xll_test_multifit)
+
+	test_gsl_multifit();
+
+XLL_TEST_END(xll_test_multifit)
+
+#endif // _DEBUG
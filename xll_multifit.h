@@ -0,0 +1,346 @@
+// xll_multifit.h - GSL nonlinear least-squares fitting
+// http://www.gnu.org/software/gsl/manual/html_node/Nonlinear-Least_002dSquares-Fitting.html
+#pragma once
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "gsl/gsl_errno.h"
+#include "gsl/gsl_blas.h"
+#include "gsl/gsl_multifit_nlin.h"
+#include "xll_deriv.h"
+
+namespace gsl {
+
+	namespace multifit {
+
+		// residuals f: R^p -> R^n, f has n elements
+		using function = std::function<void(size_t p, const double* x, double* f)>;
+		// row major n x p Jacobian J[i*p + j] = df_i/dx_j
+		using jacobian = std::function<void(size_t p, const double* x, double* J)>;
+
+		// minimize sum_i w_i f_i(x)^2 using Levenberg-Marquardt
+		// The solver works with the weighted residuals sqrt(w_i) f_i so the
+		// covariance of the fit parameters is (J' W J)^-1 at the solution.
+		// If no Jacobian is supplied it is computed by forward differences
+		// reusing f(x) with the columns optionally evaluated in parallel.
+		class fdfsolver {
+			using multifit_fdfsolver = std::unique_ptr<gsl_multifit_fdfsolver,decltype(&::gsl_multifit_fdfsolver_free)>;
+
+			multifit_fdfsolver s;
+			function F;
+			jacobian dF;
+			std::vector<double> sw; // square roots of the weights, empty if unweighted
+			gsl_multifit_function_fdf FdF_;
+			gsl::deriv::options o;
+			std::vector<double> y;
+			size_t nf, ndf; // number of function and Jacobian evaluations
+			int status_;
+
+			// weighted residuals
+			void f_(size_t p, const double* x, double* f)
+			{
+				F(p, x, f);
+				++nf;
+
+				for (size_t i = 0; i < sw.size(); ++i)
+					f[i] *= sw[i];
+			}
+			// weighted Jacobian given the weighted residuals fx
+			void df_(size_t p, const double* x, const double* fx, double* J)
+			{
+				size_t n = FdF_.n;
+
+				++ndf;
+				if (dF) {
+					dF(p, x, J);
+					for (size_t i = 0; i < sw.size(); ++i)
+						for (size_t j = 0; j < p; ++j)
+							J[i*p + j] *= sw[i];
+				}
+				else {
+					gsl::deriv::jacobian([this](size_t p, const double* x, double* f) {
+						F(p, x, f);
+						for (size_t i = 0; i < sw.size(); ++i)
+							f[i] *= sw[i];
+					}, p, n, x, J, o, fx);
+					nf += o.method == gsl::deriv::scheme::forward ? p : 2*p;
+				}
+			}
+
+			static int static_f(const gsl_vector* x, void* params, gsl_vector* f)
+			{
+				if (x->stride != 1 || f->stride != 1)
+					return GSL_EINVAL;
+
+				try {
+					static_cast<fdfsolver*>(params)->f_(x->size, x->data, f->data);
+				}
+				catch (const std::exception&) {
+					return GSL_EBADFUNC;
+				}
+
+				return GSL_SUCCESS;
+			}
+			static int static_fdf(const gsl_vector* x, void* params, gsl_vector* f, gsl_matrix* J)
+			{
+				if (x->stride != 1 || f->stride != 1 || J->tda != J->size2)
+					return GSL_EINVAL;
+
+				try {
+					fdfsolver& s = *static_cast<fdfsolver*>(params);
+
+					s.f_(x->size, x->data, f->data);
+					s.df_(x->size, x->data, f->data, J->data);
+				}
+				catch (const std::exception&) {
+					return GSL_EBADFUNC;
+				}
+
+				return GSL_SUCCESS;
+			}
+			static int static_df(const gsl_vector* x, void* params, gsl_matrix* J)
+			{
+				fdfsolver& s = *static_cast<fdfsolver*>(params);
+
+				s.y.resize(s.FdF_.n);
+				gsl_vector_view y_ = gsl_vector_view_array(s.y.data(), s.y.size());
+
+				return static_fdf(x, params, &y_.vector, J);
+			}
+
+			int set_(const function& f, const jacobian& df, size_t p, const double* x, const double* w)
+			{
+				size_t n = FdF_.n;
+
+				F = f;
+				dF = df;
+				nf = ndf = 0;
+				sw.clear();
+				if (w) {
+					sw.resize(n);
+					for (size_t i = 0; i < n; ++i) {
+						if (w[i] < 0)
+							throw std::invalid_argument(__FILE__ ": " __FUNCTION__ ": weights must be non-negative");
+						sw[i] = sqrt(w[i]);
+					}
+				}
+
+				if (p != FdF_.p)
+					throw std::invalid_argument(__FILE__ ": " __FUNCTION__ ": wrong number of parameters");
+
+				gsl_vector_const_view x_ = gsl_vector_const_view_array(x, p);
+
+				return gsl_multifit_fdfsolver_set(s.get(), &FdF_, &x_.vector);
+			}
+		public:
+			// n residuals and p parameters
+			fdfsolver(const gsl_multifit_fdfsolver_type* type, size_t n, size_t p)
+				: s{gsl_multifit_fdfsolver_alloc(type, n, p), &::gsl_multifit_fdfsolver_free}, nf(0), ndf(0), status_(GSL_CONTINUE)
+			{
+				if (!s)
+					throw std::runtime_error(__FILE__ ": " __FUNCTION__ ": gsl_multifit_fdfsolver_alloc failed");
+
+				FdF_.f = static_f;
+				FdF_.df = static_df;
+				FdF_.fdf = static_fdf;
+				FdF_.n = n;
+				FdF_.p = p;
+				FdF_.params = this;
+			}
+			fdfsolver(const fdfsolver&) = delete;
+			fdfsolver& operator=(const fdfsolver&) = delete;
+
+			// needed for gsl_multifit_fdfsolver_* routines
+			gsl_multifit_fdfsolver* get() const
+			{
+				return s.get();
+			}
+			// syntactic sugar
+			operator gsl_multifit_fdfsolver*() const
+			{
+				return get();
+			}
+
+			// analytic Jacobian of the unweighted residuals, x is copied, w is null or has n elements
+			int set(const function& f, const jacobian& df, size_t p, const double* x, const double* w = nullptr)
+			{
+				return set_(f, df, p, x, w);
+			}
+			// forward difference Jacobian with optional steps h
+			// Set parallel only if f can be called from several threads at once.
+			int set(const function& f, size_t p, const double* x, const double* w = nullptr,
+				const std::vector<double>& h = std::vector<double>{}, bool parallel = false)
+			{
+				o.method = gsl::deriv::scheme::forward;
+				o.h = h;
+				o.parallel = parallel;
+
+				return set_(f, jacobian(), p, x, w);
+			}
+
+			int iterate()
+			{
+				return gsl_multifit_fdfsolver_iterate(s.get());
+			}
+
+			// number of residuals
+			size_t residuals() const
+			{
+				return FdF_.n;
+			}
+			// number of parameters
+			size_t size() const
+			{
+				return FdF_.p;
+			}
+			// current parameter estimate
+			const double* x() const
+			{
+				return s->x->data;
+			}
+			// weighted residuals at x
+			const double* f() const
+			{
+				return s->f->data;
+			}
+			// last step
+			const double* dx() const
+			{
+				return s->dx->data;
+			}
+			// sum of squared weighted residuals
+			double chisq() const
+			{
+				return pow(gsl_blas_dnrm2(s->f), 2);
+			}
+			// function and Jacobian evaluations including finite differences
+			size_t function_evaluations() const
+			{
+				return nf;
+			}
+			size_t jacobian_evaluations() const
+			{
+				return ndf;
+			}
+
+			// p x p covariance (J' W J)^-1, columns with |R_jj| <= epsrel |R_11| are ignored
+			void covariance(double* C, double epsrel = 0) const
+			{
+				size_t p = size();
+				gsl_matrix_view C_ = gsl_matrix_view_array(C, p, p);
+
+				if (GSL_SUCCESS != gsl_multifit_covar(s->J, epsrel, &C_.matrix))
+					throw std::runtime_error(__FILE__ ": " __FUNCTION__ ": gsl_multifit_covar failed");
+			}
+
+			// iterate until done or at most maxiter times and return the number of iterations
+			size_t solve(const std::function<bool(const fdfsolver&)>& done, size_t maxiter = 500)
+			{
+				size_t iter = 0;
+
+				status_ = GSL_CONTINUE;
+				while (iter < maxiter) {
+					++iter;
+					status_ = iterate();
+					if (status_ != GSL_SUCCESS)
+						break;
+					if (done(*this))
+						return iter;
+					status_ = GSL_CONTINUE;
+				}
+
+				return iter;
+			}
+			// GSL_SUCCESS if the last solve converged, GSL_CONTINUE if it ran out of iterations,
+			// otherwise the error from the last iteration
+			int status() const
+			{
+				return status_;
+			}
+		};
+
+		// convergence helper functions
+		// |dx_i| < epsabs + epsrel |x_i|
+		inline auto test_delta(double epsabs, double epsrel)
+		{
+			return [epsabs,epsrel](const fdfsolver& s) {
+				return GSL_SUCCESS == gsl_multifit_test_delta(s.get()->dx, s.get()->x, epsabs, epsrel);
+			};
+		}
+		// |J' f| < epsabs
+		inline auto test_gradient(double epsabs)
+		{
+			return [epsabs](const fdfsolver& s) {
+				std::vector<double> g(s.size());
+				gsl_vector_view g_ = gsl_vector_view_array(g.data(), g.size());
+				gsl_multifit_gradient(s.get()->J, s.get()->f, &g_.vector);
+
+				return GSL_SUCCESS == gsl_multifit_test_gradient(&g_.vector, epsabs);
+			};
+		}
+
+	} // multifit
+
+} // gsl
+
+#ifdef _DEBUG
+#include <cassert>
+
+// http://www.gnu.org/software/gsl/manual/html_node/Example-programs-for-Nonlinear-Least_002dSquares-Fitting.html
+// fit y = A exp(-lambda t) + b to noise free data
+inline void test_gsl_multifit()
+{
+	const size_t n = 40, p = 3;
+	double A = 5, lambda = 0.1, b = 1;
+	std::vector<double> t(n), y(n), w(n);
+	for (size_t i = 0; i < n; ++i) {
+		t[i] = static_cast<double>(i);
+		y[i] = A*exp(-lambda*t[i]) + b;
+		w[i] = 1/(0.1*0.1);
+	}
+
+	auto f = [&](size_t p_, const double* x, double* r) {
+		assert (p_ == p);
+		for (size_t i = 0; i < n; ++i)
+			r[i] = x[0]*exp(-x[1]*t[i]) + x[2] - y[i];
+	};
+	auto df = [&](size_t p_, const double* x, double* J) {
+		assert (p_ == p);
+		for (size_t i = 0; i < n; ++i) {
+			double e = exp(-x[1]*t[i]);
+			J[i*p + 0] = e;
+			J[i*p + 1] = -t[i]*x[0]*e;
+			J[i*p + 2] = 1;
+		}
+	};
+	double x0[] = {1, 0, 0};
+
+	{
+		gsl::multifit::fdfsolver s(gsl_multifit_fdfsolver_lmsder, n, p);
+		s.set(f, df, p, x0, w.data());
+		size_t iter = s.solve(gsl::multifit::test_delta(1e-10, 1e-10));
+		assert (iter < 500 && s.status() == GSL_SUCCESS);
+		assert (fabs(s.x()[0] - A) < 1e-6);
+		assert (fabs(s.x()[1] - lambda) < 1e-6);
+		assert (fabs(s.x()[2] - b) < 1e-6);
+		assert (s.chisq() < 1e-12);
+
+		double C[p*p];
+		s.covariance(C);
+		for (size_t j = 0; j < p; ++j)
+			assert (C[j*p + j] > 0);
+	}
+	{
+		gsl::multifit::fdfsolver s(gsl_multifit_fdfsolver_lmder, n, p);
+		s.set(f, p, x0, nullptr, std::vector<double>{}, true);
+		s.solve(gsl::multifit::test_delta(1e-10, 1e-10));
+		assert (fabs(s.x()[0] - A) < 1e-5);
+		assert (fabs(s.x()[1] - lambda) < 1e-5);
+		assert (fabs(s.x()[2] - b) < 1e-5);
+		assert (s.function_evaluations() >= p*s.jacobian_evaluations());
+	}
+}
+
+#endif // _DEBUG
@@ -5,6 +5,81 @@
 
 using namespace xll;
 
+static AddInX xai_multimin_function_regid(
+	FunctionX(XLL_HANDLEX, _T("?xll_multimin_function_regid"), PREFIX _T("MULTMIN.FUNCTION.REGID"))
+	.Arg(XLL_HANDLEX, _T("Regid"), _T("is the register id of a function taking an array and returning a number."))
+	.Uncalced()
+	.Category(CATEGORY)
+	.FunctionHelp(_T("Return a handle to a function from R^n to R."))
+	.Documentation(_T("The handle can be used as the function to minimize in ") PREFIX _T("MULTMIN.FMINIMIZER.SET and ") PREFIX _T("MULTMIN.FDFMINIMIZER.SET. "))
+);
+HANDLEX WINAPI xll_multimin_function_regid(double regid)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	handlex h;
+
+	try {
+		using function = gsl::multimin::function<double>;
+		handle<function> h_(new function([regid](size_t n, const double* x) {
+			OPERX x_(static_cast<xword>(n), 1);
+			for (xword i = 0; i < x_.size(); ++i)
+				x_[i] = x[i];
+
+			OPERX f_ = XLL_XL_(UDF, OPERX(regid), x_);
+			ensure (f_.xltype == xltypeNum || !"MULTMIN.FUNCTION.REGID: function must return a number");
+
+			return f_.val.num;
+		}));
+
+		h = h_.get();
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return h;
+}
+
+static AddInX xai_multimin_gradient_regid(
+	FunctionX(XLL_HANDLEX, _T("?xll_multimin_gradient_regid"), PREFIX _T("MULTMIN.GRADIENT.REGID"))
+	.Arg(XLL_HANDLEX, _T("Regid"), _T("is the register id of a function taking an array and returning an array of the same size."))
+	.Uncalced()
+	.Category(CATEGORY)
+	.FunctionHelp(_T("Return a handle to the gradient of a function from R^n to R."))
+	.Documentation(_T("The handle can be used as the gradient in ") PREFIX _T("MULTMIN.FDFMINIMIZER.SET. "))
+);
+HANDLEX WINAPI xll_multimin_gradient_regid(double regid)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	handlex h;
+
+	try {
+		using gradient = gsl::multimin::gradient;
+		handle<gradient> h_(new gradient([regid](size_t n, const double* x, double* df) {
+			OPERX x_(static_cast<xword>(n), 1);
+			for (xword i = 0; i < x_.size(); ++i)
+				x_[i] = x[i];
+
+			OPERX df_ = XLL_XL_(UDF, OPERX(regid), x_);
+			ensure (df_.size() == n || !"MULTMIN.GRADIENT.REGID: gradient must have the same size as x");
+
+			for (xword i = 0; i < df_.size(); ++i)
+				df[i] = df_[i].val.num;
+		}));
+
+		h = h_.get();
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return h;
+}
+
 XLL_ENUM_DOCX(p2h<const gsl_multimin_fminimizer_type>(gsl_multimin_fminimizer_nmsimplex),GSL_MULTIMIN_FMINIMIZER_NMSIMPLEX, CATEGORY, _T("Simplex method solver"), _T("Documentation"));
 XLL_ENUM_DOCX(p2h<const gsl_multimin_fminimizer_type>(gsl_multimin_fminimizer_nmsimplex2),GSL_MULTIMIN_FMINIMIZER_NMSIMPLEX2, CATEGORY, _T("Simplex2 method solver"), _T("Documentation"));
 XLL_ENUM_DOCX(p2h<const gsl_multimin_fminimizer_type>(gsl_multimin_fminimizer_nmsimplex2rand),GSL_MULTIMIN_FMINIMIZER_NMSIMPLEX2RAND, CATEGORY, _T("Simplex2 method solver"), _T("Documentation"));
@@ -21,6 +96,7 @@ static AddInX xai_multimin_fminimizer(
 HANDLEX WINAPI xll_multimin_fminimizer(HANDLEX type, WORD n)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	handlex h;
 
 	try {
@@ -29,6 +105,7 @@ HANDLEX WINAPI xll_multimin_fminimizer(HANDLEX type, WORD n)
 		h = h_.get();
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -38,7 +115,7 @@ HANDLEX WINAPI xll_multimin_fminimizer(HANDLEX type, WORD n)
 static AddInX xai_multimin_fminimizer_set(
 	FunctionX(XLL_HANDLEX, _T("?xll_multimin_fminimizer_set"), PREFIX _T("MULTMIN.FMINIMIZER.SET"))
 	.Arg(XLL_HANDLEX, _T("Minimizer"), _T("is a handle returned by GSL.MULTIMIN.fminimizer"))
-	.Arg(XLL_HANDLEX, _T("f"), _T("is a handle to a function object"))
+	.Arg(XLL_HANDLEX, _T("f"), _T("is a handle returned by ") PREFIX _T("MULTMIN.FUNCTION.REGID"))
 	.Arg(XLL_FPX, _T("x"), _T("is the initial root guess"))
 	.Arg(XLL_FPX, _T("dx"), _T("is the initial root setp"))
 	.FunctionHelp(_T("Return a handle to a gsl::multimin::fminimizer object"))
@@ -48,6 +125,7 @@ static AddInX xai_multimin_fminimizer_set(
 HANDLEX WINAPI xll_multimin_fminimizer_set(HANDLEX s, HANDLEX f, xfpx* px, xfpx* pdx)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	try {
 		ensure (size(*px) == size(*pdx));
 
@@ -57,6 +135,7 @@ HANDLEX WINAPI xll_multimin_fminimizer_set(HANDLEX s, HANDLEX f, xfpx* px, xfpx*
 		ensure (GSL_SUCCESS == s_->set(*f_, size(*px), px->array, pdx->array));
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -73,12 +152,14 @@ static AddInX xai_multimin_fminimizer_iterate(
 HANDLEX WINAPI xll_multimin_fminimizer_iterate(HANDLEX s)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	try {
 		handle<gsl::multimin::fminimizer> s_(s);
 
 		ensure (GSL_SUCCESS == s_->iterate());
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -95,6 +176,7 @@ static AddInX xai_multimin_fminimizer_minimum(
 double WINAPI xll_multimin_fminimizer_minimum(HANDLEX s)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex min;
 
 	try {
@@ -103,6 +185,7 @@ double WINAPI xll_multimin_fminimizer_minimum(HANDLEX s)
 		min = s_->minumum();
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -119,6 +202,7 @@ static AddInX xai_multimin_fminimizer_radius(
 double WINAPI xll_multimin_fminimizer_radius(HANDLEX s)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex r;
 
 	try {
@@ -127,6 +211,7 @@ double WINAPI xll_multimin_fminimizer_radius(HANDLEX s)
 		r = s_->radius();
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -143,6 +228,7 @@ static AddInX xai_multimin_fminimizer_x(
 xfpx* WINAPI xll_multimin_fminimizer_x(HANDLEX s)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	static FPX x;
 
 	try {
@@ -153,12 +239,335 @@ xfpx* WINAPI xll_multimin_fminimizer_x(HANDLEX s)
 		std::copy(s_->x(), s_->x() + n, x.begin());		
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return x.get();
+}
+
+XLL_ENUM_DOCX(p2h<const gsl_multimin_fdfminimizer_type>(gsl_multimin_fdfminimizer_steepest_descent),GSL_MULTIMIN_FDFMINIMIZER_STEEPEST_DESCENT, CATEGORY, _T("Steepest descent method"), _T("Documentation"));
+XLL_ENUM_DOCX(p2h<const gsl_multimin_fdfminimizer_type>(gsl_multimin_fdfminimizer_conjugate_pr),GSL_MULTIMIN_FDFMINIMIZER_CONJUGATE_PR, CATEGORY, _T("Polak-Ribiere conjugate gradient method"), _T("Documentation"));
+XLL_ENUM_DOCX(p2h<const gsl_multimin_fdfminimizer_type>(gsl_multimin_fdfminimizer_conjugate_fr),GSL_MULTIMIN_FDFMINIMIZER_CONJUGATE_FR, CATEGORY, _T("Fletcher-Reeves conjugate gradient method"), _T("Documentation"));
+XLL_ENUM_DOCX(p2h<const gsl_multimin_fdfminimizer_type>(gsl_multimin_fdfminimizer_vector_bfgs),GSL_MULTIMIN_FDFMINIMIZER_VECTOR_BFGS, CATEGORY, _T("Broyden-Fletcher-Goldfarb-Shanno method"), _T("Documentation"));
+XLL_ENUM_DOCX(p2h<const gsl_multimin_fdfminimizer_type>(gsl_multimin_fdfminimizer_vector_bfgs2),GSL_MULTIMIN_FDFMINIMIZER_VECTOR_BFGS2, CATEGORY, _T("Improved Broyden-Fletcher-Goldfarb-Shanno method"), _T("Documentation"));
+
+static AddInX xai_multimin_fdfminimizer(
+	FunctionX(XLL_HANDLEX, _T("?xll_multimin_fdfminimizer"), PREFIX _T("MULTMIN.FDFMINIMIZER"))
+	.Arg(XLL_HANDLEX, _T("Type"), _T("is the type of solver from the GSL_MULTIMIN_FDFMINIMIZER_* enumeration"))
+	.Arg(XLL_WORDX, _T("n"), _T("is the dimension of the problem"))
+	.Uncalced()
+	.FunctionHelp(_T("Return a handle to a gsl::multimin::fdfminimizer object"))
+	.Category(CATEGORY)
+	.Documentation(_T(""))
+);
+HANDLEX WINAPI xll_multimin_fdfminimizer(HANDLEX type, WORD n)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	handlex h;
+
+	try {
+		handle<gsl::multimin::fdfminimizer> h_(new gsl::multimin::fdfminimizer(h2p<gsl_multimin_fdfminimizer_type>(type), n));
+
+		h = h_.get();
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return h;
+}
+
+static AddInX xai_multimin_fdfminimizer_set(
+	FunctionX(XLL_HANDLEX, _T("?xll_multimin_fdfminimizer_set"), PREFIX _T("MULTMIN.FDFMINIMIZER.SET"))
+	.Arg(XLL_HANDLEX, _T("Minimizer"), _T("is a handle returned by GSL.MULTMIN.FDFMINIMIZER"))
+	.Arg(XLL_HANDLEX, _T("f"), _T("is a handle returned by ") PREFIX _T("MULTMIN.FUNCTION.REGID"))
+	.Arg(XLL_HANDLEX, _T("df"), _T("is an optional handle to the gradient of f returned by ") PREFIX _T("MULTMIN.GRADIENT.REGID"))
+	.Arg(XLL_FPX, _T("x"), _T("is the initial guess"))
+	.Arg(XLL_DOUBLEX, _T("Step"), _T("is the size of the first trial step. Default is 0.01"), 0.01)
+	.Arg(XLL_DOUBLEX, _T("Tol"), _T("is the accuracy of the line minimization. Default is 0.1"), 0.1)
+	.Arg(XLL_DOUBLEX, _T("h"), _T("is the relative finite difference step if df is missing. Default is 6e-6"))
+	.Arg(XLL_BOOLX, _T("Parallel"), _T("evaluates the finite difference gradient in parallel if true. Default is false"))
+	.FunctionHelp(_T("Return a handle to a gsl::multimin::fdfminimizer object"))
+	.Category(CATEGORY)
+	.Documentation(
+		_T("If df is missing the gradient is computed using central differences. ")
+		_T("Only set Parallel if f can be called from several threads at once; ")
+		_T("functions calling back into Excel can not. ")
+	)
+);
+HANDLEX WINAPI xll_multimin_fdfminimizer_set(HANDLEX s, HANDLEX f, HANDLEX df, xfpx* px, double step, double tol, double dx, BOOL parallel)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	try {
+		handle<gsl::multimin::fdfminimizer> s_(s);
+		handle<gsl::multimin::function<double>> f_(f);
+
+		if (step <= 0)
+			step = 0.01;
+		if (tol <= 0)
+			tol = 0.1;
+
+		if (df == 0) {
+			if (dx <= 0)
+				dx = 6.0554544523933395e-06;
+
+			ensure (GSL_SUCCESS == s_->set(*f_, size(*px), px->array, step, tol, dx, parallel != 0));
+		}
+		else {
+			handle<gsl::multimin::gradient> df_(df);
+
+			ensure (GSL_SUCCESS == s_->set(*f_, *df_, size(*px), px->array, step, tol));
+		}
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return s;
+}
+
+static AddInX xai_multimin_fdfminimizer_iterate(
+	FunctionX(XLL_HANDLEX, _T("?xll_multimin_fdfminimizer_iterate"), PREFIX _T("MULTMIN.FDFMINIMIZER.ITERATE"))
+	.Arg(XLL_HANDLEX, _T("Minimizer"), _T("is a handle returned by GSL.MULTMIN.FDFMINIMIZER"))
+	.FunctionHelp(_T("Return a handle to a gsl::multimin::fdfminimizer object after one iteration step."))
+	.Category(CATEGORY)
+	.Documentation(_T(""))
+);
+HANDLEX WINAPI xll_multimin_fdfminimizer_iterate(HANDLEX s)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	try {
+		handle<gsl::multimin::fdfminimizer> s_(s);
+
+		ensure (GSL_SUCCESS == s_->iterate());
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return s;
+}
+
+static AddInX xai_multimin_fdfminimizer_restart(
+	FunctionX(XLL_HANDLEX, _T("?xll_multimin_fdfminimizer_restart"), PREFIX _T("MULTMIN.FDFMINIMIZER.RESTART"))
+	.Arg(XLL_HANDLEX, _T("Minimizer"), _T("is a handle returned by GSL.MULTMIN.FDFMINIMIZER"))
+	.FunctionHelp(_T("Return a handle to a gsl::multimin::fdfminimizer object restarted at the current point."))
+	.Category(CATEGORY)
+	.Documentation(_T(""))
+);
+HANDLEX WINAPI xll_multimin_fdfminimizer_restart(HANDLEX s)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	try {
+		handle<gsl::multimin::fdfminimizer> s_(s);
+
+		ensure (GSL_SUCCESS == s_->restart());
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return s;
+}
+
+static AddInX xai_multimin_fdfminimizer_minimum(
+	FunctionX(XLL_DOUBLEX, _T("?xll_multimin_fdfminimizer_minimum"), PREFIX _T("MULTMIN.FDFMINIMIZER.MINIMUM"))
+	.Arg(XLL_HANDLEX, _T("Minimizer"), _T("is a handle returned by GSL.MULTMIN.FDFMINIMIZER"))
+	.FunctionHelp(_T("Return the current minimum."))
+	.Category(CATEGORY)
+	.Documentation(_T(""))
+);
+double WINAPI xll_multimin_fdfminimizer_minimum(HANDLEX s)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	doublex min;
+
+	try {
+		handle<gsl::multimin::fdfminimizer> s_(s);
+
+		min = s_->minimum();
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return min;
+}
+
+static AddInX xai_multimin_fdfminimizer_x(
+	FunctionX(XLL_FPX, _T("?xll_multimin_fdfminimizer_x"), PREFIX _T("MULTMIN.FDFMINIMIZER.X"))
+	.Arg(XLL_HANDLEX, _T("Minimizer"), _T("is a handle returned by GSL.MULTMIN.FDFMINIMIZER"))
+	.FunctionHelp(_T("Return the current best guess."))
+	.Category(CATEGORY)
+	.Documentation(_T(""))
+);
+xfpx* WINAPI xll_multimin_fdfminimizer_x(HANDLEX s)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	static FPX x;
+
+	try {
+		handle<gsl::multimin::fdfminimizer> s_(s);
+
+		ensure (s_->x() || !"GSL.MULTMIN.FDFMINIMIZER.X: minimizer was not allocated");
+		xword n = static_cast<xword>(s_->size());
+		x.resize(1, n);
+		std::copy(s_->x(), s_->x() + n, x.begin());
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
 	return x.get();
 }
 
+static AddInX xai_multimin_fdfminimizer_gradient(
+	FunctionX(XLL_FPX, _T("?xll_multimin_fdfminimizer_gradient"), PREFIX _T("MULTMIN.FDFMINIMIZER.GRADIENT"))
+	.Arg(XLL_HANDLEX, _T("Minimizer"), _T("is a handle returned by GSL.MULTMIN.FDFMINIMIZER"))
+	.FunctionHelp(_T("Return the gradient at the current best guess."))
+	.Category(CATEGORY)
+	.Documentation(_T(""))
+);
+xfpx* WINAPI xll_multimin_fdfminimizer_gradient(HANDLEX s)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	static FPX df;
+
+	try {
+		handle<gsl::multimin::fdfminimizer> s_(s);
+
+		ensure (s_->df() || !"GSL.MULTMIN.FDFMINIMIZER.GRADIENT: minimizer was not allocated");
+		xword n = static_cast<xword>(s_->size());
+		df.resize(1, n);
+		std::copy(s_->df(), s_->df() + n, df.begin());
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return df.get();
+}
+
+static AddInX xai_multimin_fdfminimizer_solve(
+	FunctionX(XLL_FPX, _T("?xll_multimin_fdfminimizer_solve"), PREFIX _T("MULTMIN.FDFMINIMIZER.SOLVE"))
+	.Arg(XLL_HANDLEX, _T("Minimizer"), _T("is a handle returned by GSL.MULTMIN.FDFMINIMIZER.SET"))
+	.Arg(XLL_DOUBLEX, _T("Epsabs"), _T("is the gradient norm tolerance. Default is 1e-8"), 1e-8)
+	.Arg(XLL_LONGX, _T("Maxiter"), _T("is the maximum number of iterations. Default is 1000"), 1000)
+	.FunctionHelp(_T("Iterate until the norm of the gradient is less than Epsabs and return the best guess."))
+	.Category(CATEGORY)
+	.Documentation(_T("Iteration also stops if the minimizer can not make progress. "))
+);
+xfpx* WINAPI xll_multimin_fdfminimizer_solve(HANDLEX s, double epsabs, LONG maxiter)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	static FPX x;
+
+	try {
+		if (epsabs <= 0)
+			epsabs = 1e-8;
+		if (maxiter <= 0)
+			maxiter = 1000;
+
+		handle<gsl::multimin::fdfminimizer> s_(s);
+
+		xword n = static_cast<xword>(s_->size());
+		const double* x_ = s_->solve(gsl::multimin::test_gradient(epsabs), maxiter);
+		ensure (x_ || !"GSL.MULTMIN.FDFMINIMIZER.SOLVE: minimizer was not allocated");
+		x.resize(1, n);
+		std::copy(x_, x_ + n, x.begin());
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+
+		return 0;
+	}
+
+	return x.get();
+}
+
+XLL_ENUM_DOCX(static_cast<int>(gsl::multimin::seeding::sobol), GSL_MULTIMIN_SEEDING_SOBOL, CATEGORY, _T("Sobol sequence starting points"), _T("Documentation"));
+XLL_ENUM_DOCX(static_cast<int>(gsl::multimin::seeding::latin_hypercube), GSL_MULTIMIN_SEEDING_LATIN_HYPERCUBE, CATEGORY, _T("Latin hypercube starting points"), _T("Documentation"));
+
+static AddInX xai_multimin_multistart(
+	FunctionX(XLL_FPX, _T("?xll_multimin_multistart"), PREFIX _T("MULTMIN.MULTISTART"))
+	.Arg(XLL_HANDLEX, _T("f"), _T("is a handle returned by ") PREFIX _T("MULTMIN.FUNCTION.REGID"))
+	.Arg(XLL_FPX, _T("Lo"), _T("is the lower corner of the box containing the starting points"))
+	.Arg(XLL_FPX, _T("Hi"), _T("is the upper corner of the box containing the starting points"))
+	.Arg(XLL_LONGX, _T("Starts"), _T("is the number of starting points. Default is 32"), 32)
+	.Arg(XLL_WORDX, _T("Seeding"), _T("is the method from the GSL_MULTIMIN_SEEDING_* enumeration. Default is Sobol"))
+	.Arg(XLL_BOOLX, _T("Parallel"), _T("runs the starts on all cores if true. Default is false"))
+	.Arg(XLL_DOUBLEX, _T("Epsabs"), _T("is the simplex size for convergence. Default is 1e-6"), 1e-6)
+	.Arg(XLL_LONGX, _T("Maxiter"), _T("is the maximum number of iterations for each start. Default is 1000"), 1000)
+	.FunctionHelp(_T("Return the distinct local minima found from many starting points, best first."))
+	.Category(CATEGORY)
+	.Documentation(
+		_T("Each row of the result is the value of f followed by the location of a local minimum. ")
+		_T("The Nelder-Mead simplex method is run from each starting point. ")
+		_T("Every 25 iterations the starts that have reached a minimum already found with a lower value are dropped. ")
+		_T("Each coordinate of Lo must be less than the one in Hi. ")
+		_T("Only set Parallel if f can be called from several threads at once; ")
+		_T("functions from ") PREFIX _T("MULTMIN.FUNCTION.REGID call back into Excel and can not. ")
+	)
+);
+xfpx* WINAPI xll_multimin_multistart(HANDLEX f, xfpx* plo, xfpx* phi, LONG starts, WORD seeding, BOOL parallel, double epsabs, LONG maxiter)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	static FPX m;
+
+	try {
+		ensure (size(*plo) == size(*phi));
+		ensure (seeding <= static_cast<WORD>(gsl::multimin::seeding::latin_hypercube));
+
+		handle<gsl::multimin::function<double>> f_(f);
+
+		gsl::multimin::multistart_options o;
+		if (starts > 0)
+			o.starts = starts;
+		o.seed = static_cast<gsl::multimin::seeding>(seeding);
+		o.parallel = parallel != 0;
+		if (epsabs > 0)
+			o.epsabs = epsabs;
+		if (maxiter > 0)
+			o.maxiter = maxiter;
+
+		size_t n = size(*plo);
+		auto minima = gsl::multimin::multistart(*f_, n, plo->array, phi->array, o);
+		ensure (minima.size() > 0);
+
+		m.resize(static_cast<xword>(minima.size()), static_cast<xword>(n + 1));
+		for (size_t i = 0; i < minima.size(); ++i) {
+			m[static_cast<xword>(i*(n + 1))] = minima[i].f;
+			std::copy(minima[i].x.begin(), minima[i].x.end(), m.begin() + i*(n + 1) + 1);
+		}
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+
+		return 0;
+	}
+
+	return m.get();
+}
+
 #ifdef _DEBUG
 
 static AddInX xai_sumsq(
@@ -171,6 +580,7 @@ static AddInX xai_sumsq(
 HANDLEX WINAPI xll_sumsq()
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	handlex h;
 
 	try {
@@ -182,6 +592,35 @@ HANDLEX WINAPI xll_sumsq()
 		h = h_.get();
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return h;
+}
+static AddInX xai_sumsq_gradient(
+	FunctionX(XLL_HANDLEX, _T("?xll_sumsq_gradient"), _T("XLL.SUMSQ.GRADIENT"))
+	.Uncalced()
+	.Category(CATEGORY)
+	.FunctionHelp(_T("Return a handle to the gradient of XLL.SUMSQ."))
+	.Documentation(_T(""))
+);
+HANDLEX WINAPI xll_sumsq_gradient()
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	handlex h;
+
+	try {
+		handle<gsl::multimin::gradient> h_(new gsl::multimin::gradient([](size_t n, const double* x, double* df) {
+			for (size_t i = 0; i < n; ++i)
+				df[i] = 2*x[i];
+		}));
+
+		h = h_.get();
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -193,7 +632,10 @@ HANDLEX WINAPI xll_sumsq()
 XLL_TEST_BEGIN(xll_multimin_fmininimizer)
 
 //_crtBreakAlloc = 4385;
+	test_gsl_dual();
 	test_gsl_multimin_fminimizer();
+	test_gsl_multimin_fdfminimizer();
+	test_gsl_multimin_multistart();
 
 XLL_TEST_END(xll_multimin_fmininimizer)
 
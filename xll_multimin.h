@@ -1,10 +1,19 @@
 // xll_multimin.h - Wrappers for gsl_multimin.h
 // http://www.gnu.org/software/gsl/manual/html_node/Multidimensional-Minimization.html#Multidimensional-Minimization
 #pragma once
+#include <algorithm>
+#include <cmath>
 #include <functional>
+#include <limits>
+#include <memory>
 #include <stdexcept>
 #include <vector>
 #include "gsl/gsl_multimin.h"
+#include "gsl/gsl_qrng.h"
+#include "xll_deriv.h"
+#include "xll_dual.h"
+#include "xll_parallel.h"
+#include "xll_rng.h"
 #include "xll_vector.h"
 
 namespace gsl {
@@ -15,24 +24,38 @@ namespace gsl {
 		template<class T>
 		using function = std::function<T(size_t n, const T* x)>;
 
+		// Nelder-Mead minimizer working directly on caller arrays
+		// set passes x and dx to GSL as views so nothing is copied or allocated, and the
+		// workspace is only reallocated when the dimension changes. Pass std::cref(f) to set
+		// to avoid copying f when the caller keeps it alive while minimizing.
 		class fminimizer {
+			const gsl_multimin_fminimizer_type* type;
 			gsl_multimin_fminimizer* s;
 			function<double> F;
 			gsl_multimin_function F_;
-			gsl::vector<double> x_, dx_;
+			std::vector<double> y; // contiguous copy of strided points
 			int status;
+			// NaN instead of letting exceptions escape into C code, GSL reports GSL_EBADFUNC
 			static double static_function(const gsl_vector* v, void* params)
 			{
-				const function<double>& f = *static_cast<function<double>*>(params);
+				fminimizer& m = *static_cast<fminimizer*>(params);
 
-				if (v->stride != 1)
-					throw std::runtime_error(__FILE__ ": " __FUNCTION__ ": gsl_vector must have stride 1");
+				try {
+					if (v->stride == 1)
+						return m.F(v->size, v->data);
+
+					for (size_t i = 0; i < v->size; ++i)
+						m.y[i] = v->data[i*v->stride];
 
-				return f(v->size, v->data);
+					return m.F(v->size, m.y.data());
+				}
+				catch (const std::exception&) {
+					return GSL_NAN;
+				}
 			}
 		public:
 			fminimizer(const gsl_multimin_fminimizer_type* type, size_t n)
-				: s(gsl_multimin_fminimizer_alloc(type, n)), status(GSL_SUCCESS)
+				: type(type), s(gsl_multimin_fminimizer_alloc(type, n)), y(n), status(GSL_SUCCESS)
 			{
 				if (s == 0)
 					status = GSL_ENOMEM;
@@ -54,21 +77,26 @@ namespace gsl {
 				return get();
 			}
 
-			// caller responsible for x, dx memory
-			int set(const function<double>& f, size_t n, const double* x, const double* dx)
+			// x[i*incx] and dx[i*incdx] for 0 <= i < n are only read during the call
+			int set(const function<double>& f, size_t n, const double* x, const double* dx, size_t incx = 1, size_t incdx = 1)
 			{
-				if (status != GSL_SUCCESS)
-					return status;
+				if (s && s->x->size != n) {
+					gsl_multimin_fminimizer_free(s);
+					s = gsl_multimin_fminimizer_alloc(type, n);
+					y.resize(n);
+				}
+				if (s == 0)
+					return status = GSL_ENOMEM;
 
 				F = f;
 				F_.n = n;
-				F_.params = &F;
+				F_.params = this;
 				F_.f = static_function;
 
-				x_ = gsl::vector<double>(n, 1, x);
-				dx_ = gsl::vector<double>(n, 1, dx);
+				gsl_vector_const_view x_ = gsl_vector_const_view_array_with_stride(x, incx, n);
+				gsl_vector_const_view dx_ = gsl_vector_const_view_array_with_stride(dx, incdx, n);
 
-				return status = gsl_multimin_fminimizer_set(s, &F_, &x_, &dx_);
+				return status = gsl_multimin_fminimizer_set(s, &F_, &x_.vector, &dx_.vector);
 			}
 
 			int iterate()
@@ -110,23 +138,403 @@ namespace gsl {
 
 				return gsl_multimin_fminimizer_x(s)->data;
 			}
+			// copy the current best guess to x[i*incx]
+			void x(double* x_, size_t incx = 1) const
+			{
+				const gsl_vector* v = gsl_multimin_fminimizer_x(s);
+
+				for (size_t i = 0; i < v->size; ++i)
+					x_[i*incx] = gsl_vector_get(v, i);
+			}
 
 		};
 
+		// gradient of f: R^n -> R
+		using gradient = std::function<void(size_t n, const double* x, double* df)>;
+
 		class fdfminimizer {
 			gsl_multimin_fdfminimizer* s;
+			function<double> F;
+			gradient dF;
+			gsl_multimin_function_fdf F_;
+			gsl::vector<double> x_;
+			int status;
+
+			static const double* data(const gsl_vector* v)
+			{
+				if (v->stride != 1)
+					throw std::runtime_error(__FILE__ ": " __FUNCTION__ ": gsl_vector must have stride 1");
+
+				return v->data;
+			}
+			// exceptions must not escape into C code, a failed call shows up as NaN in the minimum or gradient
+			static double static_f(const gsl_vector* v, void* params)
+			{
+				const fdfminimizer& s = *static_cast<fdfminimizer*>(params);
+
+				try {
+					return s.F(v->size, data(v));
+				}
+				catch (const std::exception&) {
+					return GSL_NAN;
+				}
+			}
+			static void static_df(const gsl_vector* v, void* params, gsl_vector* df)
+			{
+				const fdfminimizer& s = *static_cast<fdfminimizer*>(params);
+
+				try {
+					s.dF(v->size, data(v), const_cast<double*>(data(df)));
+				}
+				catch (const std::exception&) {
+					gsl_vector_set_all(df, GSL_NAN);
+				}
+			}
+			static void static_fdf(const gsl_vector* v, void* params, double* f, gsl_vector* df)
+			{
+				*f = static_f(v, params);
+				static_df(v, params, df);
+			}
+
+			// clears an error left by an earlier iteration
+			int set(size_t n, const double* x, double step_size, double tol)
+			{
+				if (s == 0)
+					return status = GSL_ENOMEM;
+
+				F_.n = n;
+				F_.params = this;
+				F_.f = static_f;
+				F_.df = static_df;
+				F_.fdf = static_fdf;
+
+				x_ = gsl::vector<double>(n, 1, x);
+
+				return status = gsl_multimin_fdfminimizer_set(s, &F_, &x_, step_size, tol);
+			}
 		public:
 			fdfminimizer(const gsl_multimin_fdfminimizer_type* type, size_t n)
-				: s(gsl_multimin_fdfminimizer_alloc(type, n))
-			{ }
+				: s(gsl_multimin_fdfminimizer_alloc(type, n)), status(GSL_SUCCESS)
+			{
+				if (s == 0)
+					status = GSL_ENOMEM;
+			}
 			fdfminimizer(const fdfminimizer&) = delete;
 			fdfminimizer& operator=(const fdfminimizer&) = delete;
 			~fdfminimizer()
 			{
 				gsl_multimin_fdfminimizer_free(s);
 			}
+
+			// to interface with gsl_multimin_* functions
+			gsl_multimin_fdfminimizer* get()
+			{
+				return status == GSL_SUCCESS ? s : nullptr;
+			}
+			gsl_multimin_fdfminimizer* operator&()
+			{
+				return get();
+			}
+
+			// step_size is the size of the first trial step and tol the accuracy of the line minimization
+			int set(const function<double>& f, const gradient& df, size_t n, const double* x, double step_size = 0.01, double tol = 0.1)
+			{
+				F = f;
+				dF = df;
+
+				return set(n, x, step_size, tol);
+			}
+			// gradient by central differences with relative step h
+			// Only use parallel if f can be called from several threads at once.
+			int set(const function<double>& f, size_t n, const double* x, double step_size = 0.01, double tol = 0.1,
+				double h = 6.0554544523933395e-06, bool parallel = false)
+			{
+				F = f;
+				dF = [f,h,parallel](size_t n, const double* x, double* df) {
+					gsl::deriv::options o;
+					o.parallel = parallel;
+					o.h.resize(n);
+					for (size_t i = 0; i < n; ++i)
+						o.h[i] = h*(std::max)(fabs(x[i]), 1.);
+
+					gsl::deriv::gradient(f, n, x, df, o);
+				};
+
+				return set(n, x, step_size, tol);
+			}
+			// exact gradient by forward mode automatic differentiation
+			int set(const function<dual>& f, size_t n, const double* x, double step_size = 0.01, double tol = 0.1)
+			{
+				F = [f](size_t n, const double* x) {
+					std::vector<dual> x_(x, x + n);
+
+					return f(n, x_.data()).v;
+				};
+				dF = [f](size_t n, const double* x, double* df) {
+					std::vector<dual> x_(x, x + n);
+
+					for (size_t i = 0; i < n; ++i) {
+						x_[i].d = 1;
+						df[i] = f(n, x_.data()).d;
+						x_[i].d = 0;
+					}
+				};
+
+				return set(n, x, step_size, tol);
+			}
+
+			int iterate()
+			{
+				if (status != GSL_SUCCESS)
+					return status;
+
+				return status = gsl_multimin_fdfminimizer_iterate(s);
+			}
+			int restart()
+			{
+				if (status != GSL_SUCCESS)
+					return status;
+
+				return gsl_multimin_fdfminimizer_restart(s);
+			}
+
+			// The current point stays valid after iterate fails, e.g. with GSL_ENOPROG near the minimum.
+
+			// current minimum
+			double minimum() const
+			{
+				if (s == 0)
+					return std::numeric_limits<double>::quiet_NaN();
+
+				return gsl_multimin_fdfminimizer_minimum(s);
+			}
+			size_t size() const
+			{
+				if (s == 0)
+					return 0;
+
+				return gsl_multimin_fdfminimizer_x(s)->size;
+			}
+			// current best guess
+			const double* x() const
+			{
+				if (s == 0)
+					return 0;
+
+				return gsl_multimin_fdfminimizer_x(s)->data;
+			}
+			// gradient at the current best guess
+			const double* df() const
+			{
+				if (s == 0)
+					return 0;
+
+				return gsl_multimin_fdfminimizer_gradient(s)->data;
+			}
+
+			// iterate until done or no progress is made
+			const double* solve(const std::function<bool(const fdfminimizer&)>& done, size_t maxiter = 1000)
+			{
+				for (size_t i = 0; i < maxiter && GSL_SUCCESS == iterate(); ++i) {
+					if (done(*this))
+						break;
+				}
+
+				return x();
+			}
+		};
+
+		// convergence helper functions
+		inline auto test_gradient(double epsabs)
+		{
+			return [epsabs](const fdfminimizer& s) {
+				gsl_vector_const_view g = gsl_vector_const_view_array(s.df(), s.size());
+
+				return GSL_SUCCESS == gsl_multimin_test_gradient(&g.vector, epsabs);
+			};
+		}
+
+		// local minimum found by multistart
+		struct local_minimum {
+			double f;
+			std::vector<double> x;
+			size_t iterations;
+			bool converged;
+		};
+
+		// how multistart picks starting points in the box [lo, hi]
+		enum class seeding { sobol, latin_hypercube };
+
+		// m points in [0,1)^n, row major
+		inline std::vector<double> sobol_points(size_t m, size_t n)
+		{
+			std::unique_ptr<gsl_qrng,decltype(&::gsl_qrng_free)> q(gsl_qrng_alloc(gsl_qrng_sobol, static_cast<unsigned>(n)), &::gsl_qrng_free);
+			if (!q)
+				throw std::runtime_error(__FILE__ ": " __FUNCTION__ ": gsl_qrng_alloc failed");
+
+			std::vector<double> u(m*n);
+			for (size_t i = 0; i < m; ++i)
+				gsl_qrng_get(q.get(), &u[i*n]);
+
+			return u;
+		}
+		// each coordinate has exactly one point in each of m equal strata
+		inline std::vector<double> latin_hypercube_points(size_t m, size_t n, unsigned long seed)
+		{
+			gsl::rng r;
+			r.set(seed);
+
+			std::vector<double> u(m*n);
+			std::vector<size_t> p(m);
+			for (size_t j = 0; j < n; ++j) {
+				for (size_t i = 0; i < m; ++i)
+					p[i] = i;
+				for (size_t i = m; i > 1; --i)
+					std::swap(p[i - 1], p[r.uniform_int(static_cast<unsigned long>(i))]);
+				for (size_t i = 0; i < m; ++i)
+					u[i*n + j] = (p[i] + r.uniform())/m;
+			}
+
+			return u;
+		}
+
+		struct multistart_options {
+			size_t starts = 32;        // number of starting points
+			seeding seed = seeding::sobol; // Sobol needs n <= 40, otherwise Latin hypercube is used
+			unsigned long rng_seed = 0;    // for Latin hypercube
+			double step = 0.1;         // initial simplex size as a fraction of hi - lo
+			size_t round = 25;         // iterations between pruning
+			double keep = 1;           // fraction of unconverged starts kept after each round, 1 to keep all
+			double epsabs = 1e-6;      // simplex size for convergence
+			size_t maxiter = 1000;     // per start
+			double distinct = 1e-4;    // minima closer than this fraction of hi - lo are the same
+			bool parallel = false;     // only if f can be called from several threads at once
 		};
 
+		// Run Nelder-Mead from many starting points and return the distinct local minima, best first.
+		// Every round the starts that have not converged but are already within distinct of a
+		// converged minimum with a lower value are dropped since they can only find it again.
+		// If keep < 1 the remaining starts are also ranked by their current value and only the
+		// best keep fraction continue. This is faster but can cut basins before they converge.
+		inline std::vector<local_minimum> multistart(const function<double>& f, size_t n, const double* lo, const double* hi,
+			const multistart_options& o = multistart_options{})
+		{
+			for (size_t j = 0; j < n; ++j)
+				if (!(lo[j] < hi[j]))
+					throw std::invalid_argument(__FILE__ ": " __FUNCTION__ ": lo must be less than hi");
+
+			// max norm distance scaled by the box
+			auto distance = [n, lo, hi](const double* x, const double* y) {
+				double d = 0;
+				for (size_t j = 0; j < n; ++j)
+					d = (std::max)(d, fabs(x[j] - y[j])/(hi[j] - lo[j]));
+
+				return d;
+			};
+
+			size_t m = (std::max)(o.starts, size_t(1));
+			std::vector<double> u = (o.seed == seeding::sobol && n <= 40)
+				? sobol_points(m, n) : latin_hypercube_points(m, n, o.rng_seed);
+
+			std::vector<double> dx(n);
+			for (size_t j = 0; j < n; ++j)
+				dx[j] = o.step*(hi[j] - lo[j]);
+
+			struct start {
+				std::unique_ptr<fminimizer> s;
+				size_t iterations = 0;
+				bool done = false, converged = false;
+			};
+			std::vector<start> starts(m);
+			gsl::parallel::for_each(m, [&](size_t i) {
+				std::vector<double> x(n);
+				for (size_t j = 0; j < n; ++j)
+					x[j] = lo[j] + u[i*n + j]*(hi[j] - lo[j]);
+
+				starts[i].s.reset(new fminimizer(gsl_multimin_fminimizer_nmsimplex2, n));
+				if (GSL_SUCCESS != starts[i].s->set(f, n, x.data(), dx.data()))
+					starts[i].done = true;
+			}, o.parallel ? gsl::parallel::concurrency() : 1);
+
+			std::vector<size_t> active;
+			for (size_t i = 0; i < m; ++i)
+				if (!starts[i].done)
+					active.push_back(i);
+
+			std::vector<size_t> finished;
+			while (!active.empty()) {
+				gsl::parallel::for_each(active.size(), [&](size_t k) {
+					start& s = starts[active[k]];
+
+					for (size_t i = 0; i < o.round && s.iterations < o.maxiter; ++i) {
+						++s.iterations;
+						if (GSL_SUCCESS != s.s->iterate()) {
+							s.done = true;
+
+							return;
+						}
+						if (s.s->radius() < o.epsabs) {
+							s.done = s.converged = true;
+
+							return;
+						}
+					}
+					if (s.iterations >= o.maxiter)
+						s.done = true;
+				}, o.parallel ? gsl::parallel::concurrency() : 1);
+
+				std::vector<size_t> running;
+				for (auto i : active)
+					(starts[i].done ? finished : running).push_back(i);
+
+				// drop starts that are dominated by a converged minimum
+				running.erase(std::remove_if(running.begin(), running.end(), [&](size_t i) {
+					const fminimizer& s = *starts[i].s;
+					for (auto k : finished) {
+						const fminimizer& t = *starts[k].s;
+						if (starts[k].converged && t.minumum() <= s.minumum() && distance(s.x(), t.x()) < o.distinct)
+							return true;
+					}
+
+					return false;
+				}), running.end());
+
+				if (o.keep < 1) {
+					std::sort(running.begin(), running.end(), [&starts](size_t i, size_t j) {
+						return starts[i].s->minumum() < starts[j].s->minumum();
+					});
+					size_t nkeep = static_cast<size_t>(ceil(o.keep*running.size()));
+					if (nkeep < running.size())
+						running.resize(nkeep);
+				}
+
+				active.swap(running);
+			}
+
+			std::sort(finished.begin(), finished.end(), [&starts](size_t i, size_t j) {
+				return starts[i].s->minumum() < starts[j].s->minumum();
+			});
+
+			std::vector<local_minimum> minima;
+			for (auto i : finished) {
+				const fminimizer& s = *starts[i].s;
+				if (s.x() == 0)
+					continue;
+
+				bool same = false;
+				for (const auto& mi : minima) {
+					if (distance(s.x(), mi.x.data()) < o.distinct) {
+						same = true;
+						break;
+					}
+				}
+				if (!same)
+					minima.push_back(local_minimum{s.minumum(), std::vector<double>(s.x(), s.x() + n), starts[i].iterations, starts[i].converged});
+			}
+
+			return minima;
+		}
+
 	} // multimin
 
 } // gsl
@@ -172,6 +580,145 @@ inline void test_gsl_multimin_fminimizer()
 		assert (fabs(s.x()[0] - a[1]) < eps);
 		assert (fabs(s.x()[1] - a[2]) < eps);
 	}
+	{
+		gsl::multimin::fminimizer s(gsl_multimin_fminimizer_nmsimplex2, 2);
+		auto f = [](size_t n, const double* x) {
+			assert (n == 2);
+
+			return (x[0] - 2)*(x[0] - 2) + (x[1] - 3)*(x[1] - 3);
+		};
+
+		// x and dx are the first column of a row major 2 x 2 matrix
+		double x[] = {0, -1, 0, -1}, dx[] = {.1, -1, .1, -1};
+		s.set(std::cref(f), 2, x, dx, 2, 2);
+		gsl_multimin_fminimizer* p = s.get();
+		while (s.iterate() == GSL_SUCCESS && s.radius() > 1e-6)
+			;
+		s.x(x + 1, 2);
+		assert (fabs(x[1] - 2) < 1e-5 && fabs(x[3] - 3) < 1e-5);
+		assert (x[0] == 0 && x[2] == 0);
+
+		// restart with the same dimension reuses the workspace
+		s.set(std::cref(f), 2, x, dx, 2, 2);
+		assert (s.get() == p);
+		while (s.iterate() == GSL_SUCCESS && s.radius() > 1e-6)
+			;
+		assert (fabs(s.x()[0] - 2) < 1e-5);
+
+		double y[] = {0, 0, 0}, dy[] = {.1, .1, .1};
+		s.set([](size_t n, const double* x) { return x[0]*x[0] + x[1]*x[1] + (x[2] - 1)*(x[2] - 1) + n; }, 3, y, dy);
+		assert (s.size() == 3);
+	}
+}
+
+inline void test_gsl_multimin_fdfminimizer()
+{
+	// f(x, y) = a0 + (x - a1)^2 + (y - a2)^2 + x y/2
+	std::vector<double> a = {1,2,3}, x = {0,0};
+	auto f = [&a](size_t n, const double* x) {
+		assert (n == 2);
+
+		return a[0] + (x[0] - a[1])*(x[0] - a[1]) + (x[1] - a[2])*(x[1] - a[2]) + x[0]*x[1]/2;
+	};
+	auto df = [&a](size_t n, const double* x, double* df) {
+		assert (n == 2);
+
+		df[0] = 2*(x[0] - a[1]) + x[1]/2;
+		df[1] = 2*(x[1] - a[2]) + x[0]/2;
+	};
+	// 2(x - 2) + y/2 = 0, 2(y - 3) + x/2 = 0
+	double x0 = 1.0666666666666667, y0 = 2.7333333333333333;
+	double eps = 1e-6;
+
+	for (auto type : {gsl_multimin_fdfminimizer_vector_bfgs2, gsl_multimin_fdfminimizer_conjugate_fr, gsl_multimin_fdfminimizer_conjugate_pr}) {
+		gsl::multimin::fdfminimizer s(type, 2);
+
+		s.set(f, df, x.size(), &x[0]);
+		s.solve(gsl::multimin::test_gradient(1e-8));
+		assert (fabs(s.x()[0] - x0) < eps);
+		assert (fabs(s.x()[1] - y0) < eps);
+	}
+	{
+		gsl::multimin::fdfminimizer s(gsl_multimin_fdfminimizer_vector_bfgs2, 2);
+
+		s.set(f, x.size(), &x[0], 0.01, 0.1, 6.0554544523933395e-06, true);
+		s.solve(gsl::multimin::test_gradient(1e-8));
+		assert (fabs(s.x()[0] - x0) < eps);
+		assert (fabs(s.x()[1] - y0) < eps);
+	}
+	{
+		using gsl::dual;
+		gsl::multimin::fdfminimizer s(gsl_multimin_fdfminimizer_vector_bfgs2, 2);
+
+		s.set([](size_t, const dual* x) {
+			return 1 + (x[0] - 2)*(x[0] - 2) + (x[1] - 3)*(x[1] - 3) + x[0]*x[1]/2;
+		}, x.size(), &x[0]);
+		s.solve(gsl::multimin::test_gradient(1e-8));
+		assert (fabs(s.x()[0] - x0) < eps);
+		assert (fabs(s.x()[1] - y0) < eps);
+	}
+	{
+		// the point is still valid after iterate stops making progress, and set clears the error
+		gsl::multimin::fdfminimizer s(gsl_multimin_fdfminimizer_vector_bfgs2, 2);
+
+		s.set(f, df, x.size(), &x[0]);
+		for (int i = 0; i < 1000 && GSL_SUCCESS == s.iterate(); ++i)
+			;
+		assert (s.x() && s.df());
+		assert (fabs(s.x()[0] - x0) < eps);
+		assert (fabs(s.x()[1] - y0) < eps);
+
+		assert (GSL_SUCCESS == s.set(f, df, x.size(), &x[0]));
+		assert (GSL_SUCCESS == s.iterate());
+	}
+}
+
+inline void test_gsl_multimin_multistart()
+{
+	// f(x) = (x^2 - 1)^2 + x/4 + y^2 has local minima near x = -1 and x = 1, y = 0
+	auto f = [](size_t n, const double* x) {
+		assert (n == 2);
+
+		return (x[0]*x[0] - 1)*(x[0]*x[0] - 1) + x[0]/4 + x[1]*x[1];
+	};
+	double lo[] = {-2, -2}, hi[] = {2, 2};
+
+	for (auto seed : {gsl::multimin::seeding::sobol, gsl::multimin::seeding::latin_hypercube}) {
+		gsl::multimin::multistart_options o;
+		o.seed = seed;
+		o.parallel = true;
+
+		auto m = gsl::multimin::multistart(f, 2, lo, hi, o);
+		assert (m.size() >= 2);
+		assert (m[0].converged);
+		assert (m[0].x[0] < -0.9 && m[0].x[0] > -1.1);
+		assert (fabs(m[0].x[1]) < 1e-3);
+		for (size_t i = 1; i < m.size(); ++i)
+			assert (m[i - 1].f <= m[i].f);
+
+		// the other well is found too
+		bool right = false;
+		for (const auto& mi : m)
+			right = right || (mi.converged && mi.x[0] > 0.9 && mi.x[0] < 1.1 && fabs(mi.x[1]) < 1e-3);
+		assert (right);
+	}
+	try {
+		double hi0[] = {2, -2};
+		gsl::multimin::multistart(f, 2, lo, hi0);
+		assert (false);
+	}
+	catch (const std::invalid_argument&) {
+	}
+	{
+		auto u = gsl::multimin::latin_hypercube_points(10, 3, 1);
+		for (size_t j = 0; j < 3; ++j) {
+			std::vector<int> strata(10, 0);
+			for (size_t i = 0; i < 10; ++i)
+				++strata[static_cast<size_t>(u[i*3 + j]*10)];
+			for (auto s : strata)
+				assert (s == 1);
+		}
+	}
 }
 
-#endif // _DEBUG
\ No newline at end of file
+#endif // _DEBUG
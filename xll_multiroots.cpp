@@ -0,0 +1,476 @@
+// xll_multiroots.cpp - GSL multidimensional root finding
+#include "xll_multiroots.h"
+#include "xll_gsl.h"
+
+using namespace xll;
+
+using function = gsl::multiroot::function;
+using jacobian = gsl::multiroot::jacobian;
+
+// call a user defined function taking an array of size n and returning an array of size m
+inline void udf_vector(double regid, size_t n, const double* x, size_t m, double* y)
+{
+	OPERX x_(static_cast<xword>(n), 1);
+	for (xword i = 0; i < x_.size(); ++i)
+		x_[i] = x[i];
+
+	OPERX y_ = XLL_XL_(UDF, OPERX(regid), x_);
+	ensure (y_.size() == m);
+
+	for (xword i = 0; i < y_.size(); ++i)
+		y[i] = y_[i].val.num;
+}
+
+static AddInX xai_multiroot_function_regid(
+	FunctionX(XLL_HANDLEX, _T("?xll_multiroot_function_regid"), PREFIX _T("MULTIROOT.FUNCTION.REGID"))
+	.Arg(XLL_HANDLEX, _T("Regid"), _T("is the register id of a function taking an array and returning an array of the same size."))
+	.Uncalced()
+	.Category(CATEGORY)
+	.FunctionHelp(_T("Return a handle to a function from R^n to R^n."))
+	.Documentation(_T(""))
+);
+HANDLEX WINAPI xll_multiroot_function_regid(double regid)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	handlex h;
+
+	try {
+		handle<function> h_(new function([regid](size_t n, const double* x, double* y) {
+			udf_vector(regid, n, x, n, y);
+		}));
+
+		h = h_.get();
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return h;
+}
+
+static AddInX xai_multiroot_jacobian_regid(
+	FunctionX(XLL_HANDLEX, _T("?xll_multiroot_jacobian_regid"), PREFIX _T("MULTIROOT.JACOBIAN.REGID"))
+	.Arg(XLL_HANDLEX, _T("Regid"), _T("is the register id of a function taking an array of size n and returning n*n values."))
+	.Uncalced()
+	.Category(CATEGORY)
+	.FunctionHelp(_T("Return a handle to the Jacobian of a function from R^n to R^n."))
+	.Documentation(_T("The values are the row major n x n matrix of partial derivatives df_i/dx_j and may be returned in any shape. "))
+);
+HANDLEX WINAPI xll_multiroot_jacobian_regid(double regid)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	handlex h;
+
+	try {
+		handle<jacobian> h_(new jacobian([regid](size_t n, const double* x, double* J) {
+			udf_vector(regid, n, x, n*n, J);
+		}));
+
+		h = h_.get();
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return h;
+}
+
+XLL_ENUM_DOCX(p2h<const gsl_multiroot_fsolver_type>(gsl_multiroot_fsolver_hybrids),GSL_MULTIROOT_FSOLVER_HYBRIDS, CATEGORY, _T("Scaled hybrid method solver"), _T("Documentation"));
+XLL_ENUM_DOCX(p2h<const gsl_multiroot_fsolver_type>(gsl_multiroot_fsolver_hybrid),GSL_MULTIROOT_FSOLVER_HYBRID, CATEGORY, _T("Unscaled hybrid method solver"), _T("Documentation"));
+XLL_ENUM_DOCX(p2h<const gsl_multiroot_fsolver_type>(gsl_multiroot_fsolver_dnewton),GSL_MULTIROOT_FSOLVER_DNEWTON, CATEGORY, _T("Discrete Newton method solver"), _T("Documentation"));
+XLL_ENUM_DOCX(p2h<const gsl_multiroot_fsolver_type>(gsl_multiroot_fsolver_broyden),GSL_MULTIROOT_FSOLVER_BROYDEN, CATEGORY, _T("Broyden method solver"), _T("Documentation"));
+
+static AddInX xai_multiroot_fsolver(
+	FunctionX(XLL_HANDLEX, _T("?xll_multiroot_fsolver"), PREFIX _T("MULTIROOT.FSOLVER"))
+	.Arg(XLL_HANDLEX, _T("Type"), _T("is the type of solver from the GSL_MULTIROOT_FSOLVER_* enumeration"))
+	.Arg(XLL_WORDX, _T("n"), _T("is the dimension of the problem"))
+	.Uncalced()
+	.Category(CATEGORY)
+	.FunctionHelp(_T("Return a handle to a gsl::multiroot::fsolver object."))
+	.Documentation(_T(""))
+);
+HANDLEX WINAPI xll_multiroot_fsolver(HANDLEX type, WORD n)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	handlex h;
+
+	try {
+		handle<gsl::multiroot::fsolver> h_(new gsl::multiroot::fsolver(h2p<gsl_multiroot_fsolver_type>(type), n));
+
+		h = h_.get();
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return h;
+}
+
+static AddInX xai_multiroot_fsolver_set(
+	FunctionX(XLL_HANDLEX, _T("?xll_multiroot_fsolver_set"), PREFIX _T("MULTIROOT.FSOLVER.SET"))
+	.Arg(XLL_HANDLEX, _T("Solver"), _T("is a handle returned by ") PREFIX _T("MULTIROOT.FSOLVER"))
+	.Arg(XLL_HANDLEX, _T("Function"), _T("is a handle to a function from R^n to R^n."))
+	.Arg(XLL_FPX, _T("x"), _T("is the initial root guess."))
+	.Category(CATEGORY)
+	.FunctionHelp(_T("Return a handle to a gsl::multiroot::fsolver object with function and initial guess set."))
+	.Documentation(_T(""))
+);
+HANDLEX WINAPI xll_multiroot_fsolver_set(HANDLEX h, HANDLEX f, xfpx* px)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	try {
+		handle<gsl::multiroot::fsolver> h_(h);
+		handle<function> f_(f);
+
+		ensure (GSL_SUCCESS == h_->set(*f_, size(*px), px->array));
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return h;
+}
+
+static AddInX xai_multiroot_fsolver_iterate(
+	FunctionX(XLL_HANDLEX, _T("?xll_multiroot_fsolver_iterate"), PREFIX _T("MULTIROOT.FSOLVER.ITERATE"))
+	.Arg(XLL_HANDLEX, _T("Solver"), _T("is a handle returned by ") PREFIX _T("MULTIROOT.FSOLVER"))
+	.Category(CATEGORY)
+	.FunctionHelp(_T("Return a handle to a gsl::multiroot::fsolver object after one iteration step."))
+	.Documentation(_T(""))
+);
+HANDLEX WINAPI xll_multiroot_fsolver_iterate(HANDLEX h)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	try {
+		handle<gsl::multiroot::fsolver> h_(h);
+
+		ensure (GSL_SUCCESS == h_->iterate());
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return h;
+}
+
+static AddInX xai_multiroot_fsolver_root(
+	FunctionX(XLL_FPX, _T("?xll_multiroot_fsolver_root"), PREFIX _T("MULTIROOT.FSOLVER.ROOT"))
+	.Arg(XLL_HANDLEX, _T("Solver"), _T("is a handle returned by ") PREFIX _T("MULTIROOT.FSOLVER"))
+	.Category(CATEGORY)
+	.FunctionHelp(_T("Return the current root estimate of a gsl::multiroot::fsolver object."))
+	.Documentation(_T(""))
+);
+xfpx* WINAPI xll_multiroot_fsolver_root(HANDLEX h)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	static FPX x;
+
+	try {
+		handle<gsl::multiroot::fsolver> h_(h);
+
+		xword n = static_cast<xword>(h_->size());
+		x.resize(1, n);
+		std::copy(h_->root(), h_->root() + n, x.begin());
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+
+		return 0;
+	}
+
+	return x.get();
+}
+
+static AddInX xai_multiroot_fsolver_f(
+	FunctionX(XLL_FPX, _T("?xll_multiroot_fsolver_f"), PREFIX _T("MULTIROOT.FSOLVER.F"))
+	.Arg(XLL_HANDLEX, _T("Solver"), _T("is a handle returned by ") PREFIX _T("MULTIROOT.FSOLVER"))
+	.Category(CATEGORY)
+	.FunctionHelp(_T("Return the function value at the current root estimate of a gsl::multiroot::fsolver object."))
+	.Documentation(_T(""))
+);
+xfpx* WINAPI xll_multiroot_fsolver_f(HANDLEX h)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	static FPX y;
+
+	try {
+		handle<gsl::multiroot::fsolver> h_(h);
+
+		xword n = static_cast<xword>(h_->size());
+		y.resize(1, n);
+		std::copy(h_->f(), h_->f() + n, y.begin());
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+
+		return 0;
+	}
+
+	return y.get();
+}
+
+static AddInX xai_multiroot_fsolver_solve(
+	FunctionX(XLL_FPX, _T("?xll_multiroot_fsolver_solve"), PREFIX _T("MULTIROOT.FSOLVER.SOLVE"))
+	.Arg(XLL_HANDLEX, _T("Solver"), _T("is a handle returned by ") PREFIX _T("MULTIROOT.FSOLVER.SET"))
+	.Arg(XLL_DOUBLEX, _T("Epsabs"), _T("is the absolute residual tolerance. Default is 1e-10"), 1e-10)
+	.Arg(XLL_LONGX, _T("Maxiter"), _T("is the maximum number of iterations. Default is 1000"), 1000)
+	.Category(CATEGORY)
+	.FunctionHelp(_T("Iterate until all residuals are less than Epsabs and return the root."))
+	.Documentation(_T(""))
+);
+xfpx* WINAPI xll_multiroot_fsolver_solve(HANDLEX h, double epsabs, LONG maxiter)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	static FPX x;
+
+	try {
+		if (epsabs <= 0)
+			epsabs = 1e-10;
+		if (maxiter <= 0)
+			maxiter = 1000;
+
+		handle<gsl::multiroot::fsolver> h_(h);
+
+		xword n = static_cast<xword>(h_->size());
+		const double* root = h_->solve(gsl::multiroot::test_residual(epsabs), maxiter);
+		x.resize(1, n);
+		std::copy(root, root + n, x.begin());
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+
+		return 0;
+	}
+
+	return x.get();
+}
+
+XLL_ENUM_DOCX(p2h<const gsl_multiroot_fdfsolver_type>(gsl_multiroot_fdfsolver_hybridsj),GSL_MULTIROOT_FDFSOLVER_HYBRIDSJ, CATEGORY, _T("Scaled hybrid method solver"), _T("Documentation"));
+XLL_ENUM_DOCX(p2h<const gsl_multiroot_fdfsolver_type>(gsl_multiroot_fdfsolver_hybridj),GSL_MULTIROOT_FDFSOLVER_HYBRIDJ, CATEGORY, _T("Unscaled hybrid method solver"), _T("Documentation"));
+XLL_ENUM_DOCX(p2h<const gsl_multiroot_fdfsolver_type>(gsl_multiroot_fdfsolver_newton),GSL_MULTIROOT_FDFSOLVER_NEWTON, CATEGORY, _T("Newton method solver"), _T("Documentation"));
+XLL_ENUM_DOCX(p2h<const gsl_multiroot_fdfsolver_type>(gsl_multiroot_fdfsolver_gnewton),GSL_MULTIROOT_FDFSOLVER_GNEWTON, CATEGORY, _T("Globally convergent Newton method solver"), _T("Documentation"));
+
+static AddInX xai_multiroot_fdfsolver(
+	FunctionX(XLL_HANDLEX, _T("?xll_multiroot_fdfsolver"), PREFIX _T("MULTIROOT.FDFSOLVER"))
+	.Arg(XLL_HANDLEX, _T("Type"), _T("is the type of solver from the GSL_MULTIROOT_FDFSOLVER_* enumeration"))
+	.Arg(XLL_WORDX, _T("n"), _T("is the dimension of the problem"))
+	.Uncalced()
+	.Category(CATEGORY)
+	.FunctionHelp(_T("Return a handle to a gsl::multiroot::fdfsolver object."))
+	.Documentation(_T(""))
+);
+HANDLEX WINAPI xll_multiroot_fdfsolver(HANDLEX type, WORD n)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	handlex h;
+
+	try {
+		handle<gsl::multiroot::fdfsolver> h_(new gsl::multiroot::fdfsolver(h2p<gsl_multiroot_fdfsolver_type>(type), n));
+
+		h = h_.get();
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return h;
+}
+
+static AddInX xai_multiroot_fdfsolver_set(
+	FunctionX(XLL_HANDLEX, _T("?xll_multiroot_fdfsolver_set"), PREFIX _T("MULTIROOT.FDFSOLVER.SET"))
+	.Arg(XLL_HANDLEX, _T("Solver"), _T("is a handle returned by ") PREFIX _T("MULTIROOT.FDFSOLVER"))
+	.Arg(XLL_HANDLEX, _T("Function"), _T("is a handle to a function from R^n to R^n."))
+	.Arg(XLL_HANDLEX, _T("Jacobian"), _T("is an optional handle returned by ") PREFIX _T("MULTIROOT.JACOBIAN.REGID."))
+	.Arg(XLL_FPX, _T("x"), _T("is the initial root guess."))
+	.Arg(XLL_DOUBLEX, _T("h"), _T("is the relative finite difference step if Jacobian is missing. Default is 1.5e-8"))
+	.Arg(XLL_BOOLX, _T("Parallel"), _T("evaluates finite difference columns in parallel if true. Default is false"))
+	.Category(CATEGORY)
+	.FunctionHelp(_T("Return a handle to a gsl::multiroot::fdfsolver object with function and initial guess set."))
+	.Documentation(
+		_T("If Jacobian is missing then it is computed by forward differences. ")
+		_T("Subsequent Jacobians are Broyden updates of the previous one and are kept ")
+		_T("when the solver is set again, so a recalc starts from the last Jacobian. ")
+		_T("A full finite difference Jacobian is recomputed if an iteration fails or the solver asks for the Jacobian alone, ")
+		_T("as the hybrid solvers do when their own updates go bad. ")
+		_T("Only set Parallel if the function can be called from several threads at once; ")
+		_T("functions calling back into Excel can not. ")
+	)
+);
+HANDLEX WINAPI xll_multiroot_fdfsolver_set(HANDLEX h, HANDLEX f, HANDLEX df, xfpx* px, double dx, BOOL parallel)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	try {
+		handle<gsl::multiroot::fdfsolver> h_(h);
+		handle<function> f_(f);
+
+		if (df == 0) {
+			if (dx <= 0)
+				dx = 1.4901161193847656e-08;
+
+			ensure (GSL_SUCCESS == h_->set(*f_, size(*px), px->array, dx, parallel != 0));
+		}
+		else {
+			handle<jacobian> df_(df);
+
+			ensure (GSL_SUCCESS == h_->set(*f_, *df_, size(*px), px->array));
+		}
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return h;
+}
+
+static AddInX xai_multiroot_fdfsolver_iterate(
+	FunctionX(XLL_HANDLEX, _T("?xll_multiroot_fdfsolver_iterate"), PREFIX _T("MULTIROOT.FDFSOLVER.ITERATE"))
+	.Arg(XLL_HANDLEX, _T("Solver"), _T("is a handle returned by ") PREFIX _T("MULTIROOT.FDFSOLVER"))
+	.Category(CATEGORY)
+	.FunctionHelp(_T("Return a handle to a gsl::multiroot::fdfsolver object after one iteration step."))
+	.Documentation(_T(""))
+);
+HANDLEX WINAPI xll_multiroot_fdfsolver_iterate(HANDLEX h)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	try {
+		handle<gsl::multiroot::fdfsolver> h_(h);
+
+		ensure (GSL_SUCCESS == h_->iterate());
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return h;
+}
+
+static AddInX xai_multiroot_fdfsolver_root(
+	FunctionX(XLL_FPX, _T("?xll_multiroot_fdfsolver_root"), PREFIX _T("MULTIROOT.FDFSOLVER.ROOT"))
+	.Arg(XLL_HANDLEX, _T("Solver"), _T("is a handle returned by ") PREFIX _T("MULTIROOT.FDFSOLVER"))
+	.Category(CATEGORY)
+	.FunctionHelp(_T("Return the current root estimate of a gsl::multiroot::fdfsolver object."))
+	.Documentation(_T(""))
+);
+xfpx* WINAPI xll_multiroot_fdfsolver_root(HANDLEX h)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	static FPX x;
+
+	try {
+		handle<gsl::multiroot::fdfsolver> h_(h);
+
+		xword n = static_cast<xword>(h_->size());
+		x.resize(1, n);
+		std::copy(h_->root(), h_->root() + n, x.begin());
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+
+		return 0;
+	}
+
+	return x.get();
+}
+
+static AddInX xai_multiroot_fdfsolver_f(
+	FunctionX(XLL_FPX, _T("?xll_multiroot_fdfsolver_f"), PREFIX _T("MULTIROOT.FDFSOLVER.F"))
+	.Arg(XLL_HANDLEX, _T("Solver"), _T("is a handle returned by ") PREFIX _T("MULTIROOT.FDFSOLVER"))
+	.Category(CATEGORY)
+	.FunctionHelp(_T("Return the function value at the current root estimate of a gsl::multiroot::fdfsolver object."))
+	.Documentation(_T(""))
+);
+xfpx* WINAPI xll_multiroot_fdfsolver_f(HANDLEX h)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	static FPX y;
+
+	try {
+		handle<gsl::multiroot::fdfsolver> h_(h);
+
+		xword n = static_cast<xword>(h_->size());
+		y.resize(1, n);
+		std::copy(h_->f(), h_->f() + n, y.begin());
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+
+		return 0;
+	}
+
+	return y.get();
+}
+
+static AddInX xai_multiroot_fdfsolver_solve(
+	FunctionX(XLL_FPX, _T("?xll_multiroot_fdfsolver_solve"), PREFIX _T("MULTIROOT.FDFSOLVER.SOLVE"))
+	.Arg(XLL_HANDLEX, _T("Solver"), _T("is a handle returned by ") PREFIX _T("MULTIROOT.FDFSOLVER.SET"))
+	.Arg(XLL_DOUBLEX, _T("Epsabs"), _T("is the absolute residual tolerance. Default is 1e-10"), 1e-10)
+	.Arg(XLL_LONGX, _T("Maxiter"), _T("is the maximum number of iterations. Default is 1000"), 1000)
+	.Category(CATEGORY)
+	.FunctionHelp(_T("Iterate until all residuals are less than Epsabs and return the root."))
+	.Documentation(_T(""))
+);
+xfpx* WINAPI xll_multiroot_fdfsolver_solve(HANDLEX h, double epsabs, LONG maxiter)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	static FPX x;
+
+	try {
+		if (epsabs <= 0)
+			epsabs = 1e-10;
+		if (maxiter <= 0)
+			maxiter = 1000;
+
+		handle<gsl::multiroot::fdfsolver> h_(h);
+
+		xword n = static_cast<xword>(h_->size());
+		const double* root = h_->solve(gsl::multiroot::test_residual(epsabs), maxiter);
+		x.resize(1, n);
+		std::copy(root, root + n, x.begin());
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+
+		return 0;
+	}
+
+	return x.get();
+}
+
+#ifdef _DEBUG
+
+XLL_TEST_BEGIN(xll_test_multiroot)
+
+	test_gsl_parallel();
+	test_gsl_multiroot();
+
+XLL_TEST_END(xll_test_multiroot)
+
+#endif // _DEBUG
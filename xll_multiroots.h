@@ -0,0 +1,429 @@
+// xll_multiroots.h - GSL multidimensional root finding
+// http://www.gnu.org/software/gsl/manual/html_node/Multidimensional-Root_002dFinding.html#Multidimensional-Root_002dFinding
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "gsl/gsl_errno.h"
+#include "gsl/gsl_multiroots.h"
+#include "xll_deriv.h"
+
+namespace gsl {
+
+	namespace multiroot {
+
+		// f: R^n -> R^n
+		using function = std::function<void(size_t n, const double* x, double* y)>;
+		// row major Jacobian J[i*n + j] = df_i/dx_j
+		using jacobian = std::function<void(size_t n, const double* x, double* J)>;
+
+		// call f from GSL without letting exceptions escape into C code
+		inline int call(const function& f, const gsl_vector* x, gsl_vector* y)
+		{
+			if (x->stride != 1 || y->stride != 1)
+				return GSL_EINVAL;
+
+			try {
+				f(x->size, x->data, y->data);
+			}
+			catch (const std::exception&) {
+				return GSL_EBADFUNC;
+			}
+
+			return GSL_SUCCESS;
+		}
+
+		// solvers not using derivatives
+		class fsolver {
+			using multiroot_fsolver = std::unique_ptr<gsl_multiroot_fsolver,decltype(&::gsl_multiroot_fsolver_free)>;
+
+			multiroot_fsolver s;
+			function F;
+			gsl_multiroot_function F_;
+
+			static int static_f(const gsl_vector* x, void* params, gsl_vector* y)
+			{
+				return call(*static_cast<function*>(params), x, y);
+			}
+		public:
+			fsolver(const gsl_multiroot_fsolver_type* type, size_t n)
+				: s{gsl_multiroot_fsolver_alloc(type, n), &::gsl_multiroot_fsolver_free}
+			{
+				if (!s)
+					throw std::runtime_error(__FILE__ ": " __FUNCTION__ ": gsl_multiroot_fsolver_alloc failed");
+			}
+			fsolver(const fsolver&) = delete;
+			fsolver& operator=(const fsolver&) = delete;
+
+			// needed for gsl_multiroot_fsolver_* routines
+			gsl_multiroot_fsolver* get() const
+			{
+				return s.get();
+			}
+			// syntactic sugar
+			operator gsl_multiroot_fsolver*() const
+			{
+				return get();
+			}
+
+			// x is copied
+			int set(const function& f, size_t n, const double* x)
+			{
+				F = f;
+				F_.f = static_f;
+				F_.n = n;
+				F_.params = &F;
+
+				gsl_vector_const_view x_ = gsl_vector_const_view_array(x, n);
+
+				return gsl_multiroot_fsolver_set(s.get(), &F_, &x_.vector);
+			}
+
+			int iterate()
+			{
+				return gsl_multiroot_fsolver_iterate(s.get());
+			}
+
+			size_t size() const
+			{
+				return s->x->size;
+			}
+			// current root estimate
+			const double* root() const
+			{
+				return s->x->data;
+			}
+			// function value at the root estimate
+			const double* f() const
+			{
+				return s->f->data;
+			}
+			// last step
+			const double* dx() const
+			{
+				return s->dx->data;
+			}
+
+			// iterate until done or at most maxiter times
+			const double* solve(const std::function<bool(const fsolver&)>& done, size_t maxiter = 1000)
+			{
+				while (maxiter-- && GSL_SUCCESS == iterate()) {
+					if (done(*this))
+						break;
+				}
+
+				return root();
+			}
+		};
+
+		// solvers using the Jacobian
+		// If no Jacobian is supplied it is computed by forward differences with
+		// the columns evaluated in parallel. Later Jacobians are rank one Broyden
+		// updates of the last one, and it is kept across calls to set with the
+		// same dimension so a recalc starts from the previous Jacobian.
+		class fdfsolver {
+			using multiroot_fdfsolver = std::unique_ptr<gsl_multiroot_fdfsolver,decltype(&::gsl_multiroot_fdfsolver_free)>;
+
+			multiroot_fdfsolver s;
+			function F;
+			jacobian dF;
+			gsl_multiroot_function_fdf FdF_;
+
+			// finite difference and Broyden state
+			double h;
+			bool parallel, valid;
+			size_t nfd; // number of full finite difference Jacobians
+			size_t nbroyden; // Broyden updates since the last full Jacobian
+			std::vector<double> J, x0, f0, y;
+
+			// J at x with f(x) = fx
+			void jacobian_(size_t n, const double* x, const double* fx, double* J_)
+			{
+				if (dF) {
+					dF(n, x, J_);
+
+					return;
+				}
+
+				if (!valid || x0.size() != n) {
+					finite_difference(n, x, fx);
+				}
+				else {
+					broyden(n, x, fx);
+				}
+				std::copy(J.begin(), J.end(), J_);
+			}
+			// forward differences reusing f(x)
+			void finite_difference(size_t n, const double* x, const double* fx)
+			{
+				gsl::deriv::options o;
+				o.method = gsl::deriv::scheme::forward;
+				o.parallel = parallel;
+				o.h.resize(n);
+				for (size_t j = 0; j < n; ++j)
+					o.h[j] = h*(std::max)(fabs(x[j]), 1.);
+
+				J.resize(n*n);
+				gsl::deriv::jacobian(F, n, n, x, J.data(), o, fx);
+
+				x0.assign(x, x + n);
+				f0.assign(fx, fx + n);
+				valid = true;
+				++nfd;
+				nbroyden = 0;
+			}
+			// J += (df - J dx) dx'/dx'dx
+			void broyden(size_t n, const double* x, const double* fx)
+			{
+				double dx2 = 0;
+				for (size_t j = 0; j < n; ++j) {
+					x0[j] = x[j] - x0[j];
+					dx2 += x0[j]*x0[j];
+				}
+				if (dx2 > 0) {
+					for (size_t i = 0; i < n; ++i) {
+						double r = fx[i] - f0[i];
+						for (size_t j = 0; j < n; ++j)
+							r -= J[i*n + j]*x0[j];
+						r /= dx2;
+						for (size_t j = 0; j < n; ++j)
+							J[i*n + j] += r*x0[j];
+					}
+				}
+
+				x0.assign(x, x + n);
+				f0.assign(fx, fx + n);
+				++nbroyden;
+			}
+
+			// J at x given f(x)
+			int jacobian_at(const gsl_vector* x, const double* fx, gsl_matrix* J_)
+			{
+				if (J_->tda != J_->size2)
+					return GSL_EINVAL;
+
+				try {
+					jacobian_(x->size, x->data, fx, J_->data);
+				}
+				catch (const std::exception&) {
+					return GSL_EBADFUNC;
+				}
+
+				return GSL_SUCCESS;
+			}
+
+			static int static_f(const gsl_vector* x, void* params, gsl_vector* y)
+			{
+				return call(static_cast<fdfsolver*>(params)->F, x, y);
+			}
+			// Solvers such as hybridj keep their own Broyden updates and only ask for
+			// the Jacobian alone when those went bad, so always difference it fresh.
+			static int static_df(const gsl_vector* x, void* params, gsl_matrix* J)
+			{
+				fdfsolver& s = *static_cast<fdfsolver*>(params);
+
+				s.refresh();
+
+				s.y.resize(x->size);
+				gsl_vector_view y_ = gsl_vector_view_array(s.y.data(), s.y.size());
+
+				int status = call(s.F, x, &y_.vector);
+				if (status != GSL_SUCCESS)
+					return status;
+
+				return s.jacobian_at(x, s.y.data(), J);
+			}
+			static int static_fdf(const gsl_vector* x, void* params, gsl_vector* y, gsl_matrix* J)
+			{
+				fdfsolver& s = *static_cast<fdfsolver*>(params);
+
+				int status = call(s.F, x, y);
+				if (status != GSL_SUCCESS)
+					return status;
+
+				return s.jacobian_at(x, y->data, J);
+			}
+		public:
+			fdfsolver(const gsl_multiroot_fdfsolver_type* type, size_t n)
+				: s{gsl_multiroot_fdfsolver_alloc(type, n), &::gsl_multiroot_fdfsolver_free},
+				  h(1.4901161193847656e-08), parallel(false), valid(false), nfd(0), nbroyden(0)
+			{
+				if (!s)
+					throw std::runtime_error(__FILE__ ": " __FUNCTION__ ": gsl_multiroot_fdfsolver_alloc failed");
+
+				FdF_.f = static_f;
+				FdF_.df = static_df;
+				FdF_.fdf = static_fdf;
+				FdF_.params = this;
+			}
+			fdfsolver(const fdfsolver&) = delete;
+			fdfsolver& operator=(const fdfsolver&) = delete;
+
+			// needed for gsl_multiroot_fdfsolver_* routines
+			gsl_multiroot_fdfsolver* get() const
+			{
+				return s.get();
+			}
+			// syntactic sugar
+			operator gsl_multiroot_fdfsolver*() const
+			{
+				return get();
+			}
+
+			// analytic Jacobian, x is copied
+			int set(const function& f, const jacobian& df, size_t n, const double* x)
+			{
+				F = f;
+				dF = df;
+				FdF_.n = n;
+
+				gsl_vector_const_view x_ = gsl_vector_const_view_array(x, n);
+
+				return gsl_multiroot_fdfsolver_set(s.get(), &FdF_, &x_.vector);
+			}
+			// finite difference Jacobian with relative step h, x is copied
+			// Set parallel only if f can be called from several threads at once.
+			int set(const function& f, size_t n, const double* x, double h_ = 1.4901161193847656e-08, bool parallel_ = false)
+			{
+				h = h_;
+				parallel = parallel_;
+
+				return set(f, jacobian(), n, x);
+			}
+
+			// compute a full finite difference Jacobian on the next evaluation
+			void refresh()
+			{
+				valid = false;
+			}
+			// number of full finite difference Jacobians computed
+			size_t evaluations() const
+			{
+				return nfd;
+			}
+
+			int iterate()
+			{
+				int status = gsl_multiroot_fdfsolver_iterate(s.get());
+
+				// stale Broyden Jacobian, restart from the current point with a fresh one
+				if (status != GSL_SUCCESS && !dF && valid && nbroyden) {
+					refresh();
+					gsl_multiroot_fdfsolver_set(s.get(), &FdF_, s->x);
+					status = gsl_multiroot_fdfsolver_iterate(s.get());
+				}
+
+				return status;
+			}
+
+			size_t size() const
+			{
+				return s->x->size;
+			}
+			// current root estimate
+			const double* root() const
+			{
+				return s->x->data;
+			}
+			// function value at the root estimate
+			const double* f() const
+			{
+				return s->f->data;
+			}
+			// last step
+			const double* dx() const
+			{
+				return s->dx->data;
+			}
+
+			// iterate until done or at most maxiter times
+			const double* solve(const std::function<bool(const fdfsolver&)>& done, size_t maxiter = 1000)
+			{
+				while (maxiter-- && GSL_SUCCESS == iterate()) {
+					if (done(*this))
+						break;
+				}
+
+				return root();
+			}
+		};
+
+		// convergence helper functions
+		// |f_i| < epsabs
+		inline auto test_residual(double epsabs)
+		{
+			return [epsabs](const auto& s) {
+				return GSL_SUCCESS == gsl_multiroot_test_residual(s.get()->f, epsabs);
+			};
+		}
+		// |dx_i| < epsabs + epsrel |x_i|
+		inline auto test_delta(double epsabs, double epsrel)
+		{
+			return [epsabs,epsrel](const auto& s) {
+				return GSL_SUCCESS == gsl_multiroot_test_delta(s.get()->dx, s.get()->x, epsabs, epsrel);
+			};
+		}
+
+	} // multiroot
+
+} // gsl
+
+#ifdef _DEBUG
+#include <cassert>
+
+// http://www.gnu.org/software/gsl/manual/html_node/Example-programs-for-Multidimensional-Root-finding.html
+// f(x) = (a(1 - x_0), b(x_1 - x_0^2)) has a root at (1, 1)
+inline void test_gsl_multiroot()
+{
+	double a = 1, b = 10;
+	auto f = [a,b](size_t n, const double* x, double* y) {
+		assert (n == 2);
+		y[0] = a*(1 - x[0]);
+		y[1] = b*(x[1] - x[0]*x[0]);
+	};
+	auto df = [a,b](size_t n, const double* x, double* J) {
+		assert (n == 2);
+		J[0] = -a;         J[1] = 0;
+		J[2] = -2*b*x[0];  J[3] = b;
+	};
+	double x[] = {-10, -5};
+	double eps = 1e-7;
+
+	{
+		gsl::multiroot::fsolver s(gsl_multiroot_fsolver_hybrids, 2);
+		s.set(f, 2, x);
+		s.solve(gsl::multiroot::test_residual(eps));
+		assert (fabs(s.root()[0] - 1) < 1e-6);
+		assert (fabs(s.root()[1] - 1) < 1e-6);
+	}
+	{
+		gsl::multiroot::fdfsolver s(gsl_multiroot_fdfsolver_gnewton, 2);
+		s.set(f, df, 2, x);
+		s.solve(gsl::multiroot::test_residual(eps));
+		assert (fabs(s.root()[0] - 1) < 1e-6);
+		assert (fabs(s.root()[1] - 1) < 1e-6);
+		assert (s.evaluations() == 0);
+	}
+	{
+		gsl::multiroot::fdfsolver s(gsl_multiroot_fdfsolver_hybridsj, 2);
+		s.set(f, 2, x, 1e-8, true);
+		s.solve(gsl::multiroot::test_residual(eps));
+		assert (fabs(s.root()[0] - 1) < 1e-6);
+		assert (fabs(s.root()[1] - 1) < 1e-6);
+		size_t nfd = s.evaluations();
+		assert (nfd >= 1);
+
+		// recalc near the previous root reuses the Jacobian
+		double x1[] = {1.1, 0.9};
+		s.set(f, 2, x1);
+		assert (s.evaluations() == nfd);
+		s.solve(gsl::multiroot::test_residual(eps));
+		assert (fabs(s.root()[0] - 1) < 1e-6);
+		assert (fabs(s.root()[1] - 1) < 1e-6);
+	}
+}
+
+#endif // _DEBUG
@@ -1,5 +1,6 @@
 // xll_njr.cpp - normal Jarrow-Rudd
 #include "xll/xll.h"
+#include "xll_profile.h"
 #include "xll_njr.h"
 
 using namespace xll;
@@ -14,6 +15,7 @@ static AddInX xai_std_normal_ddf(
 double WINAPI xll_std_normal_ddf(WORD n, double x)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	return njr::std_normal_ddf(n, x);
 }
 
@@ -21,13 +23,15 @@ static AddInX xai_njr_bell(
 	FunctionX(XLL_FPX, _T("?xll_njr_bell"), _T("NJR.BELL"))
 	.Arg(XLL_WORDX, _T("n"), _T("is the order of the bell polynomial"))
 	.Arg(XLL_FPX, _T("x"), _T("are the values at which to compute the Bell polynomial."))
+	.ThreadSafe()
 	.Category(_T("NJR"))
 	.FunctionHelp(_T("Return (n + 1) x 1 array of B_0,...,B_n(x_0,...,x_{n-1}"))
 );
 xfpx* WINAPI xll_njr_bell(WORD n, const xfpx* px)
 {
 #pragma XLLEXPORT
-	static FPX B;
+	XLL_PROFILE;
+	static thread_local FPX B;
 
 	B.resize(n + 1, 1);
 	njr::Bell(size(*px), px->array, B.size(), B.array());
@@ -38,13 +42,15 @@ static AddInX xai_njr_bell_reduced(
 	FunctionX(XLL_FPX, _T("?xll_njr_bell_reduced"), _T("NJR.BELL.REDUCED"))
 	.Arg(XLL_WORDX, _T("n"), _T("is the order of the bell polynomial"))
 	.Arg(XLL_FPX, _T("x"), _T("are the values at which to compute the reduced Bell polynomial."))
+	.ThreadSafe()
 	.Category(_T("NJR"))
 	.FunctionHelp(_T("Return (n + 1) x 1 array of b_0,...,b_n(x_0,...,x_{n-1}"))
 	);
 xfpx* WINAPI xll_njr_bell_reduced(WORD n, const xfpx* px)
 {
 #pragma XLLEXPORT
-	static FPX b;
+	XLL_PROFILE;
+	static thread_local FPX b;
 
 	b.resize(n + 1, 1);
 	njr::bell(size(*px), px->array, b.size(), b.array());
@@ -57,13 +63,15 @@ static AddInX xai_njr_kappa_(
 	.Num(_T("s"), _T("is a number."))
 	.Arg(XLL_FPX, _T("x"), _T("are the cumulant values."))
 	.Arg(XLL_WORDX, _T("n"), _T("is number of adjusted cumulants to compute."))
+	.ThreadSafe()
 	.Category(_T("NJR"))
 	.FunctionHelp(_T("Return kappa_[i] = sum_{j>=0} kappa[i + j] s^j/j!"))
 );
 xfpx* WINAPI xll_njr_kappa_(double s, const xfpx* pk, WORD n)
 {
 #pragma XLLEXPORT
-	static FPX k_;
+	XLL_PROFILE;
+	static thread_local FPX k_;
 
 	try {
 		if (n == 0)
@@ -72,6 +80,7 @@ xfpx* WINAPI xll_njr_kappa_(double s, const xfpx* pk, WORD n)
 		njr::kappa_(s, size(*pk), pk->array, k_.size(), k_.array());
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 
 		return 0;
@@ -90,12 +99,14 @@ static AddInX xai_njr_cdf(
 double WINAPI xll_njr_cdf(double x, xfpx* pkappa)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex G;
 
 	try {
 		G = njr::cdf(x, size(*pkappa), pkappa->array);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -117,12 +128,14 @@ static AddInX xai_njr_put_value(
 double WINAPI xll_njr_put_value(double f, double sigma, double k, double t, xfpx* pkappa)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex v;
 
 	try {
 		v = njr::put_value(f, sigma, k, t, size(*pkappa), pkappa->array);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
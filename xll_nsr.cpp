@@ -21,12 +21,14 @@ static AddInX xai_caplet_value(
 double WINAPI xll_caplet_value(double Du, double Dv, double sigma, double k, double u, double v)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex c;
 
 	try {
 		c = nsr::caplet_value(Du, Dv, sigma, k, u, v);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
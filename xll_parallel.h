@@ -0,0 +1,103 @@
+// xll_parallel.h - run independent work items on all cores
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gsl {
+
+	namespace parallel {
+
+		// number of hardware threads, at least 1
+		inline size_t concurrency()
+		{
+			size_t n = std::thread::hardware_concurrency();
+
+			return n ? n : 1;
+		}
+
+		// call f(i) for 0 <= i < n on up to nthreads threads
+		// Workers pull the next index from a shared counter so uneven work balances out.
+		// The first exception thrown by f is rethrown on the calling thread.
+		inline void for_each(size_t n, const std::function<void(size_t)>& f, size_t nthreads = concurrency())
+		{
+			nthreads = (std::min)(nthreads, n);
+			if (nthreads <= 1) {
+				for (size_t i = 0; i < n; ++i)
+					f(i);
+
+				return;
+			}
+
+			std::atomic<size_t> next(0);
+			std::exception_ptr error;
+			std::mutex m;
+
+			auto work = [&]() {
+				for (size_t i = next++; i < n; i = next++) {
+					try {
+						f(i);
+					}
+					catch (...) {
+						std::lock_guard<std::mutex> lock(m);
+						if (!error)
+							error = std::current_exception();
+						next = n;
+					}
+				}
+			};
+
+			std::vector<std::thread> threads;
+			threads.reserve(nthreads - 1);
+			for (size_t k = 1; k < nthreads; ++k)
+				threads.emplace_back(work);
+			work();
+			for (auto& t : threads)
+				t.join();
+
+			if (error)
+				std::rethrow_exception(error);
+		}
+
+	} // parallel
+
+} // gsl
+
+#ifdef _DEBUG
+#include <cassert>
+#include <stdexcept>
+
+inline void test_gsl_parallel()
+{
+	{
+		std::vector<size_t> v(1000);
+		gsl::parallel::for_each(v.size(), [&v](size_t i) { v[i] = i*i; });
+		for (size_t i = 0; i < v.size(); ++i)
+			assert (v[i] == i*i);
+	}
+	{
+		std::vector<int> v(10);
+		gsl::parallel::for_each(v.size(), [&v](size_t i) { v[i] = 1; }, 1);
+		for (auto vi : v)
+			assert (vi == 1);
+	}
+	{
+		bool thrown = false;
+		try {
+			gsl::parallel::for_each(100, [](size_t i) {
+				if (i == 17)
+					throw std::runtime_error("17");
+			});
+		}
+		catch (const std::runtime_error&) {
+			thrown = true;
+		}
+		assert (thrown);
+	}
+}
+
+#endif // _DEBUG
@@ -16,6 +16,7 @@ static AddIn xai_poly_solve_quadratic(
 	.Arg(XLL_DOUBLE, "a", "is the coefficient of x^2.")
 	.Arg(XLL_DOUBLE, "b", "is the coefficient of x.")
 	.Arg(XLL_DOUBLE, "c", "is the constant term. ")
+	.ThreadSafe()
 	.Category("GSL")
 	.FunctionHelp("Return the roots of ax^2 + bx + c = 0 in a 1x2 array.")
 	.Documentation(
@@ -27,7 +28,8 @@ static AddIn xai_poly_solve_quadratic(
 xfpx* WINAPI xll_poly_solve_quadratic(double a, double b, double c)
 {
 #pragma XLLEXPORT
-	static FPX x(1,2);
+	XLL_PROFILE;
+	static thread_local FPX x(1,2);
 
 	x[0] = std::numeric_limits<double>::quiet_NaN();
 	x[1] = std::numeric_limits<double>::quiet_NaN();
@@ -50,6 +52,7 @@ double WINAPI
 xll_poly_eval(const xfp* pa, double x)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	return gsl_poly_eval(pa->array, size(*pa), x);
 }
 
@@ -79,6 +82,7 @@ public:
 static AddInX xai_poly_complex_solve(
 	FunctionX(XLL_FPX, _T("?xll_poly_complex_solve"), PREFIX _T("POLY.COMPLEX.SOLVE"))
 	.Arg(XLL_FPX, _T("p"), IS_POLY)
+	.ThreadSafe()
 	.Category(CATEGORY)
 	.FunctionHelp(_T("Compute all the roots of a the polynomial p."))
 	.Documentation(
@@ -91,7 +95,8 @@ xfpx* WINAPI
 xll_poly_complex_solve(const xfp* pp)
 {
 #pragma XLLEXPORT
-	static FPX r;
+	XLL_PROFILE;
+	static thread_local FPX r;
 
 	try {
 		xword n = size(*pp);
@@ -102,6 +107,7 @@ xll_poly_complex_solve(const xfp* pp)
 		ensure (0 == pc.solve(pp->array, n, r.array()));
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 
 		return 0;
@@ -0,0 +1,120 @@
+// xll_profile.cpp - report call counts and latencies of add-in entry points
+#include <algorithm>
+#include <fstream>
+#include "xll_profile.h"
+#include "xll/xll.h"
+
+using namespace xll;
+
+static AddInX xai_profile(
+	FunctionX(XLL_LPOPERX, _T("?xll_profile"), _T("XLL.PROFILE"))
+	.Arg(XLL_WORDX, _T("Count"), _T("is the maximum number of functions to return. Default is all"))
+	.Volatile()
+	.Category(_T("XLL"))
+	.FunctionHelp(_T("Return a table of calls, errors and latencies of add-in functions since the last reset."))
+	.Documentation(
+		_T("The first row is a header and the remaining rows are the functions that have been called ")
+		_T("sorted by total time, largest first. Times are in seconds. ")
+		_T("Percentiles are estimated from histograms with four buckets per power of two nanoseconds. ")
+		_T("Each thread counts its own calls and the counts are merged when this is called. ")
+	)
+);
+LPOPERX WINAPI xll_profile(WORD count)
+{
+#pragma XLLEXPORT
+	static OPERX o;
+
+	try {
+		std::vector<profile::stats> s = profile::snapshot();
+		s.erase(std::remove_if(s.begin(), s.end(), [](const profile::stats& s) { return s.calls == 0; }), s.end());
+		std::sort(s.begin(), s.end(), [](const profile::stats& a, const profile::stats& b) { return a.ns > b.ns; });
+		if (count > 0 && count < s.size())
+			s.resize(count);
+
+		const xchar* header[] = {_T("Function"), _T("Calls"), _T("Errors"), _T("Total"), _T("Mean"), _T("P50"), _T("P90"), _T("P99")};
+		o.resize(static_cast<xword>(s.size() + 1), 8);
+		for (xword j = 0; j < 8; ++j)
+			o[j] = header[j];
+
+		for (size_t i = 0; i < s.size(); ++i) {
+			const profile::stats& si = s[i];
+			xword r = static_cast<xword>(8*(i + 1));
+
+			o[r] = OPERX(std::basic_string<xchar>(si.name.begin(), si.name.end()).c_str());
+			o[r + 1] = static_cast<double>(si.calls);
+			o[r + 2] = static_cast<double>(si.errors);
+			o[r + 3] = si.seconds();
+			o[r + 4] = si.mean();
+			o[r + 5] = si.percentile(0.5);
+			o[r + 6] = si.percentile(0.9);
+			o[r + 7] = si.percentile(0.99);
+		}
+	}
+	catch (const std::exception& ex) {
+		XLL_ERROR(ex.what());
+
+		return 0;
+	}
+
+	return &o;
+}
+
+static AddInX xai_profile_reset(
+	FunctionX(XLL_BOOLX, _T("?xll_profile_reset"), _T("XLL.PROFILE.RESET"))
+	.Category(_T("XLL"))
+	.FunctionHelp(_T("Start counting calls and latencies from zero."))
+	.Documentation(_T("Returns TRUE. "))
+);
+BOOL WINAPI xll_profile_reset(void)
+{
+#pragma XLLEXPORT
+	try {
+		profile::reset();
+	}
+	catch (const std::exception& ex) {
+		XLL_ERROR(ex.what());
+
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static AddInX xai_profile_csv(
+	FunctionX(XLL_BOOLX, _T("?xll_profile_csv"), _T("XLL.PROFILE.CSV"))
+	.Arg(XLL_CSTRINGX, _T("File"), _T("is the name of the file to write."))
+	.Category(_T("XLL"))
+	.FunctionHelp(_T("Write the profile of add-in functions to a comma separated value file."))
+	.Documentation(
+		_T("The columns are function, calls, errors, total, mean, p50, p90 and p99 with times in seconds. ")
+		_T("The file is overwritten. Returns TRUE on success. ")
+	)
+);
+BOOL WINAPI xll_profile_csv(const xchar* file)
+{
+#pragma XLLEXPORT
+	try {
+		std::ofstream os(file);
+		ensure (os || !"XLL.PROFILE.CSV: could not open file");
+
+		profile::csv(os);
+		ensure (os || !"XLL.PROFILE.CSV: write failed");
+	}
+	catch (const std::exception& ex) {
+		XLL_ERROR(ex.what());
+
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+#ifdef _DEBUG
+
+XLL_TEST_BEGIN(xll_test_profile)
+
+	test_xll_profile();
+
+XLL_TEST_END(xll_test_profile)
+
+#endif // _DEBUG
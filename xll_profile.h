@@ -0,0 +1,404 @@
+// xll_profile.h - call counts, errors and latency histograms for add-in entry points
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace xll {
+
+	namespace profile {
+
+		// Latencies in nanoseconds are counted in buckets with four per power of two.
+		// Bucket i < 4 holds exactly i, otherwise [lower(i), lower(i + 1)).
+		enum : size_t { subbuckets = 4, buckets = 4*40 };
+
+		inline size_t bucket(std::uint64_t ns)
+		{
+			if (ns < subbuckets)
+				return static_cast<size_t>(ns);
+
+			size_t e = 0; // most significant bit
+			for (std::uint64_t m = ns; m > 1; m >>= 1)
+				++e;
+			size_t i = (e - 1)*subbuckets + static_cast<size_t>((ns >> (e - 2)) & (subbuckets - 1));
+
+			return (std::min)(i, static_cast<size_t>(buckets - 1));
+		}
+		inline double lower(size_t i)
+		{
+			if (i < subbuckets)
+				return static_cast<double>(i);
+
+			return static_cast<double>(subbuckets + i%subbuckets)*std::pow(2., static_cast<double>(i/subbuckets - 1));
+		}
+
+		// counters for one call site on one thread
+		// Only the owning thread writes so increments are plain relaxed loads and stores.
+		struct counters {
+			std::atomic<std::uint64_t> calls, errors, ns;
+			std::atomic<std::uint64_t> hist[buckets];
+
+			counters()
+				: calls(0), errors(0), ns(0)
+			{
+				for (auto& h : hist)
+					h.store(0, std::memory_order_relaxed);
+			}
+
+			static void add(std::atomic<std::uint64_t>& a, std::uint64_t n)
+			{
+				a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+			}
+		};
+
+		// merged counts for one call site
+		struct stats {
+			std::string name;
+			std::uint64_t calls = 0, errors = 0, ns = 0;
+			std::vector<std::uint64_t> hist = std::vector<std::uint64_t>(buckets);
+
+			void add(const counters& c)
+			{
+				calls += c.calls.load(std::memory_order_relaxed);
+				errors += c.errors.load(std::memory_order_relaxed);
+				ns += c.ns.load(std::memory_order_relaxed);
+				for (size_t i = 0; i < buckets; ++i)
+					hist[i] += c.hist[i].load(std::memory_order_relaxed);
+			}
+			void add(const stats& s)
+			{
+				calls += s.calls;
+				errors += s.errors;
+				ns += s.ns;
+				for (size_t i = 0; i < buckets; ++i)
+					hist[i] += s.hist[i];
+			}
+			void subtract(const stats& s)
+			{
+				calls -= s.calls;
+				errors -= s.errors;
+				ns -= s.ns;
+				for (size_t i = 0; i < buckets; ++i)
+					hist[i] -= s.hist[i];
+			}
+
+			// total time in seconds
+			double seconds() const
+			{
+				return ns*1e-9;
+			}
+			// mean time per call in seconds
+			double mean() const
+			{
+				return calls ? seconds()/calls : 0;
+			}
+			// latency in seconds at 0 <= p <= 1, the midpoint of the bucket containing it
+			double percentile(double p) const
+			{
+				if (calls == 0)
+					return 0;
+
+				double n = p*calls;
+				std::uint64_t m = 0;
+				size_t i = 0;
+				for (; i + 1 < buckets; ++i) {
+					m += hist[i];
+					if (m >= n && m > 0)
+						break;
+				}
+
+				return i < subbuckets ? i*1e-9 : 0.5e-9*(lower(i) + lower(i + 1));
+			}
+		};
+
+		// per thread counters allocated in fixed blocks so readers never see them move
+		class table {
+			enum : size_t { block_size = 64, max_blocks = 64 };
+			std::atomic<counters*> blocks[max_blocks];
+		public:
+			enum : size_t { capacity = block_size*max_blocks };
+
+			table()
+			{
+				for (auto& b : blocks)
+					b.store(nullptr, std::memory_order_relaxed);
+			}
+			table(const table&) = delete;
+			table& operator=(const table&) = delete;
+			~table()
+			{
+				for (auto& b : blocks)
+					delete [] b.load(std::memory_order_relaxed);
+			}
+
+			// called only by the owning thread
+			counters& operator[](size_t id)
+			{
+				auto& b = blocks[id/block_size];
+				counters* p = b.load(std::memory_order_relaxed);
+				if (!p) {
+					p = new counters[block_size];
+					b.store(p, std::memory_order_release);
+				}
+
+				return p[id%block_size];
+			}
+			// null if the owning thread has not called id
+			const counters* find(size_t id) const
+			{
+				const counters* p = blocks[id/block_size].load(std::memory_order_acquire);
+
+				return p ? p + id%block_size : nullptr;
+			}
+		};
+
+		// call site names and the tables of live threads
+		// Tables of threads that exit are folded into retired. Reset records
+		// a baseline that is subtracted instead of touching other threads' counters.
+		class registry {
+			std::mutex m;
+			std::vector<std::string> names;
+			std::vector<const table*> tables;
+			std::vector<stats> retired, baseline;
+
+			std::vector<stats> merge_()
+			{
+				std::vector<stats> s(names.size());
+				for (size_t id = 0; id < s.size(); ++id) {
+					s[id].name = names[id];
+					s[id].add(retired[id]);
+					for (const auto* t : tables) {
+						const counters* c = t->find(id);
+						if (c)
+							s[id].add(*c);
+					}
+				}
+
+				return s;
+			}
+		public:
+			static registry& instance()
+			{
+				static registry r;
+
+				return r;
+			}
+
+			size_t site(const char* name)
+			{
+				std::lock_guard<std::mutex> lock(m);
+
+				if (names.size() == table::capacity)
+					throw std::length_error(__FILE__ ": " __FUNCTION__ ": too many profiled functions");
+
+				names.emplace_back(name);
+				retired.emplace_back();
+				baseline.emplace_back();
+
+				return names.size() - 1;
+			}
+
+			void attach(const table* t)
+			{
+				std::lock_guard<std::mutex> lock(m);
+
+				tables.push_back(t);
+			}
+			void detach(const table* t)
+			{
+				std::lock_guard<std::mutex> lock(m);
+
+				for (size_t id = 0; id < names.size(); ++id) {
+					const counters* c = t->find(id);
+					if (c)
+						retired[id].add(*c);
+				}
+				tables.erase(std::remove(tables.begin(), tables.end(), t), tables.end());
+			}
+
+			// counts since the last reset for every call site
+			std::vector<stats> snapshot()
+			{
+				std::lock_guard<std::mutex> lock(m);
+
+				std::vector<stats> s = merge_();
+				for (size_t id = 0; id < s.size(); ++id)
+					s[id].subtract(baseline[id]);
+
+				return s;
+			}
+			void reset()
+			{
+				std::lock_guard<std::mutex> lock(m);
+
+				baseline = merge_();
+			}
+		};
+
+		// this thread's counters
+		inline table& local()
+		{
+			struct holder {
+				table t;
+				holder()
+				{
+					registry::instance().attach(&t);
+				}
+				~holder()
+				{
+					registry::instance().detach(&t);
+				}
+			};
+			static thread_local holder h;
+
+			return h.t;
+		}
+
+		inline size_t site(const char* name)
+		{
+			return registry::instance().site(name);
+		}
+
+		// time a call from construction to destruction
+		class scope {
+			using clock = std::chrono::steady_clock;
+
+			counters& c;
+			clock::time_point start;
+			bool failed;
+			scope* outer;
+
+			static scope*& current()
+			{
+				static thread_local scope* p = nullptr;
+
+				return p;
+			}
+		public:
+			explicit scope(size_t id)
+				: c(local()[id]), failed(false), outer(current())
+			{
+				current() = this;
+				start = clock::now();
+			}
+			scope(const scope&) = delete;
+			scope& operator=(const scope&) = delete;
+			~scope()
+			{
+				std::uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+
+				counters::add(c.calls, 1);
+				counters::add(c.ns, ns);
+				counters::add(c.hist[bucket(ns)], 1);
+				if (failed)
+					counters::add(c.errors, 1);
+
+				current() = outer;
+			}
+
+			// mark the innermost active scope on this thread as failed
+			static void error()
+			{
+				if (current())
+					current()->failed = true;
+			}
+		};
+
+		inline std::vector<stats> snapshot()
+		{
+			return registry::instance().snapshot();
+		}
+		inline void reset()
+		{
+			registry::instance().reset();
+		}
+
+		// one line per call site that has been called, times in seconds
+		inline void csv(std::ostream& os)
+		{
+			os << "function,calls,errors,total,mean,p50,p90,p99\n";
+			for (const auto& s : snapshot()) {
+				if (s.calls == 0)
+					continue;
+
+				os << s.name << ',' << s.calls << ',' << s.errors << ',' << s.seconds() << ',' << s.mean()
+				   << ',' << s.percentile(0.5) << ',' << s.percentile(0.9) << ',' << s.percentile(0.99) << '\n';
+			}
+		}
+
+	} // profile
+
+} // xll
+
+// Put XLL_PROFILE at the top of an entry point and XLL_PROFILE_ERROR in its error handler.
+// Define XLL_NO_PROFILE to compile them away.
+#ifdef XLL_NO_PROFILE
+#define XLL_PROFILE
+#define XLL_PROFILE_ERROR
+#else
+#define XLL_PROFILE static const size_t xll_profile_id_ = xll::profile::site(__FUNCTION__); \
+	xll::profile::scope xll_profile_scope_(xll_profile_id_)
+#define XLL_PROFILE_ERROR xll::profile::scope::error()
+#endif
+
+#ifdef _DEBUG
+#include <cassert>
+#include <sstream>
+#include <thread>
+
+inline void test_xll_profile()
+{
+	using xll::profile::bucket;
+	using xll::profile::lower;
+
+	for (std::uint64_t ns : {0ULL, 1ULL, 3ULL, 4ULL, 5ULL, 7ULL, 8ULL, 1000ULL, 123456789ULL}) {
+		size_t i = bucket(ns);
+		assert (lower(i) <= ns && ns < lower(i + 1));
+	}
+
+	static const size_t id = xll::profile::site("test_xll_profile");
+	auto find = [](const std::vector<xll::profile::stats>& s) {
+		return s[id];
+	};
+	xll::profile::reset();
+	assert (find(xll::profile::snapshot()).calls == 0);
+
+	auto f = [](bool fail) {
+		xll::profile::scope s(id);
+		if (fail)
+			xll::profile::scope::error();
+	};
+	f(false);
+	f(true);
+	{
+		// threads that exit keep their counts
+		std::thread t([&f]() {
+			for (int i = 0; i < 10; ++i)
+				f(false);
+		});
+		t.join();
+	}
+	auto s = find(xll::profile::snapshot());
+	assert (s.calls == 12);
+	assert (s.errors == 1);
+	assert (s.percentile(0.5) <= s.percentile(0.99));
+	assert (s.mean() >= 0);
+
+	std::ostringstream os;
+	xll::profile::csv(os);
+	assert (os.str().find("test_xll_profile,12,1,") != std::string::npos);
+
+	xll::profile::reset();
+	assert (find(xll::profile::snapshot()).calls == 0);
+	f(false);
+	assert (find(xll::profile::snapshot()).calls == 1);
+}
+
+#endif // _DEBUG
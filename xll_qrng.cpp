@@ -0,0 +1,146 @@
+// xll_qrng.cpp - Quasi-random sequences
+#include "xll_qrng.h"
+#include "gsl/gsl_cdf.h"
+#include "../xll8/xll/xll.h"
+#include "xll_profile.h"
+
+using namespace xll;
+
+XLL_ENUM_DOCX(p2h<const gsl_qrng_type>(gsl_qrng_halton), GSL_QRNG_HALTON, _T("GSL"), _T("Halton quasi-random sequence type."),
+	_T("Supports up to 1229 dimensions. "));
+XLL_ENUM_DOCX(p2h<const gsl_qrng_type>(gsl_qrng_niederreiter_2), GSL_QRNG_NIEDERREITER_2, _T("GSL"), _T("Niederreiter base 2 quasi-random sequence type."),
+	_T("Supports up to 12 dimensions. "));
+XLL_ENUM_DOCX(p2h<const gsl_qrng_type>(gsl_qrng_reversehalton), GSL_QRNG_REVERSEHALTON, _T("GSL"), _T("Reverse Halton quasi-random sequence type."),
+	_T("Supports up to 1229 dimensions. "));
+XLL_ENUM_DOCX(p2h<const gsl_qrng_type>(gsl_qrng_sobol), GSL_QRNG_SOBOL, _T("GSL"), _T("Sobol quasi-random sequence type."),
+	_T("Supports up to 40 dimensions. "));
+
+#define IS_QRNG_TYPE _T("is the type of quasi-random sequence from GSL_QRNG_* enumeration. Default is GSL_QRNG_SOBOL()")
+#define IS_SKIP _T("is the number of points to skip at the start of the sequence. Default is 0")
+#define IS_SHIFT _T("is the seed of a random shift of the points. Default is 0 for no shift")
+
+inline const gsl_qrng_type* qrng_type(HANDLEX type)
+{
+	return type ? h2p<const gsl_qrng_type>(type) : gsl_qrng_sobol;
+}
+
+// shift points of a sequence using a generator seeded with seed
+inline void qrng_shift(const gsl::qrng& q, LONG seed, size_t n, double* x)
+{
+	if (seed) {
+		gsl::rng r;
+		r.set(seed);
+		gsl::qrng_shift(q.type(), q.dimension(), r)(n, x);
+	}
+}
+
+static AddInX xai_qrng_points(
+	FunctionX(XLL_FPX, _T("?xll_qrng_points"), _T("GSL.QRNG.POINTS"))
+	.Arg(XLL_WORDX, _T("Rows"), _T("is the number of points to return."))
+	.Arg(XLL_WORDX, _T("Dimension"), _T("is the dimension of the points. Default is 1"))
+	.Arg(XLL_HANDLEX, _T("Type"), IS_QRNG_TYPE)
+	.Arg(XLL_DOUBLEX, _T("Skip"), IS_SKIP)
+	.Arg(XLL_LONGX, _T("Shift"), IS_SHIFT)
+	.ThreadSafe()
+	.Category(_T("GSL"))
+	.FunctionHelp(_T("Return a block of quasi-random points in the unit cube, one per row."))
+	.Documentation(
+		_T("Sobol and Niederreiter points get a random digital shift and Halton points a random rotation modulo 1 when Shift is not 0. ")
+		_T("Averages over points with different Shift seeds are independent unbiased estimates, so their standard deviation ")
+		_T("gives an error estimate for quasi-Monte Carlo integration. ")
+	)
+);
+xfpx* WINAPI xll_qrng_points(WORD rows, WORD dimension, HANDLEX type, double skip, LONG shift)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	static thread_local FPX x;
+
+	try {
+		ensure (rows > 0 || !"GSL.QRNG.POINTS: Rows must be positive");
+		ensure (skip >= 0 || !"GSL.QRNG.POINTS: Skip must not be negative");
+		if (dimension == 0)
+			dimension = 1;
+
+		gsl::qrng q(qrng_type(type), dimension);
+		q.skip(static_cast<size_t>(skip));
+
+		x.resize(rows, dimension);
+		q.get(rows, x.array());
+		qrng_shift(q, shift, rows, x.array());
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+
+		return 0;
+	}
+
+	return x.get();
+}
+
+static AddInX xai_qrng_brownian(
+	FunctionX(XLL_FPX, _T("?xll_qrng_brownian"), _T("GSL.QRNG.BROWNIAN"))
+	.Arg(XLL_WORDX, _T("Rows"), _T("is the number of paths to return."))
+	.Arg(XLL_FPX, _T("Times"), _T("is an array of positive increasing times."))
+	.Arg(XLL_HANDLEX, _T("Type"), IS_QRNG_TYPE)
+	.Arg(XLL_DOUBLEX, _T("Skip"), IS_SKIP)
+	.Arg(XLL_LONGX, _T("Shift"), IS_SHIFT)
+	.ThreadSafe()
+	.Category(_T("GSL"))
+	.FunctionHelp(_T("Return standard Brownian motion paths at Times, one per row, built from quasi-random points with a Brownian bridge."))
+	.Documentation(
+		_T("Each path uses one point with dimension the number of Times mapped to normals by the inverse normal distribution. ")
+		_T("The first coordinate sets the value at the last time and later coordinates fill in midpoints, ")
+		_T("so the well distributed leading coordinates determine most of the variance. ")
+		_T("Use Shift as in GSL.QRNG.POINTS for error estimates. ")
+	)
+);
+xfpx* WINAPI xll_qrng_brownian(WORD rows, const xfpx* pt, HANDLEX type, double skip, LONG shift)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	static thread_local FPX w;
+
+	try {
+		ensure (rows > 0 || !"GSL.QRNG.BROWNIAN: Rows must be positive");
+		ensure (skip >= 0 || !"GSL.QRNG.BROWNIAN: Skip must not be negative");
+
+		std::vector<double> t(pt->array, pt->array + size(*pt));
+		gsl::brownian_bridge b(t);
+		unsigned int n = static_cast<unsigned int>(t.size());
+
+		gsl::qrng q(qrng_type(type), n);
+		q.skip(static_cast<size_t>(skip));
+
+		std::vector<double> u(rows*n);
+		q.get(rows, u.data());
+		qrng_shift(q, shift, rows, u.data());
+		for (auto& ui : u) {
+			ensure ((0 < ui && ui < 1) || !"GSL.QRNG.BROWNIAN: point on the boundary of the unit cube; change Skip or Shift");
+			ui = gsl_cdf_ugaussian_Pinv(ui);
+		}
+
+		w.resize(rows, n);
+		for (WORD i = 0; i < rows; ++i)
+			b(u.data() + i*n, w.array() + i*n);
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+
+		return 0;
+	}
+
+	return w.get();
+}
+
+#ifdef _DEBUG
+
+XLL_TEST_BEGIN(xll_test_qrng)
+
+	test_gsl_qrng();
+
+XLL_TEST_END(xll_test_qrng)
+
+#endif // _DEBUG
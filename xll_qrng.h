@@ -0,0 +1,270 @@
+// xll_qrng.h - Quasi-random sequences and Brownian bridge path construction
+// http://www.gnu.org/software/gsl/manual/html_node/Quasi_002dRandom-Sequences.html
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <memory> // std::unique_ptr
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "gsl/gsl_qrng.h"
+#include "xll_rng.h"
+
+namespace gsl {
+
+	class qrng {
+		// call gsl_qrng_free when out of scope
+		std::unique_ptr<::gsl_qrng,decltype(&::gsl_qrng_free)> q;
+	public:
+		qrng(const gsl_qrng_type* type, unsigned int dimension)
+			: q{gsl_qrng_alloc(type, dimension), &::gsl_qrng_free}
+		{
+			if (!q)
+				throw std::invalid_argument(__FILE__ ": " __FUNCTION__ ": dimension must be positive and at most the maximum for the type");
+		}
+		qrng(const qrng& q_)
+			: q{gsl_qrng_clone(q_.q.get()), &::gsl_qrng_free}
+		{ }
+		qrng& operator=(const qrng& q_)
+		{
+			if (this != &q_) {
+				if (q->type != q_.q->type || q->dimension != q_.q->dimension) {
+					q.reset(gsl_qrng_clone(q_.q.get()));
+				}
+				else {
+					gsl_qrng_memcpy(q.get(), q_.q.get());
+				}
+			}
+
+			return *this;
+		}
+
+		// to interoperate with GSL C functions
+		operator const gsl_qrng*() const
+		{
+			return q.get();
+		}
+
+		const gsl_qrng_type* type() const
+		{
+			return q->type;
+		}
+		unsigned int dimension() const
+		{
+			return q->dimension;
+		}
+		const char* name() const
+		{
+			return gsl_qrng_name(q.get());
+		}
+
+		// restart the sequence
+		qrng& init()
+		{
+			gsl_qrng_init(q.get());
+
+			return *this;
+		}
+		// next point x[0], ..., x[dimension() - 1]
+		void get(double* x) const
+		{
+			if (q->type->get(q->state, q->dimension, x))
+				throw std::runtime_error(__FILE__ ": " __FUNCTION__ ": sequence exhausted");
+		}
+		// next n points in row major order
+		void get(size_t n, double* x) const
+		{
+			int (*get)(void*, unsigned int, double*) = q->type->get;
+			void* state = q->state;
+			unsigned int d = q->dimension;
+
+			for (size_t i = 0; i < n; ++i)
+				if (get(state, d, x + i*d))
+					throw std::runtime_error(__FILE__ ": " __FUNCTION__ ": sequence exhausted");
+		}
+		// discard the next n points
+		qrng& skip(size_t n)
+		{
+			std::vector<double> x(q->dimension);
+
+			while (n--)
+				get(x.data());
+
+			return *this;
+		}
+	};
+
+	// Randomize points so independent shifts give independent unbiased estimates
+	// whose spread is an error estimate. Base 2 sequences (Sobol and Niederreiter)
+	// use a random digital shift that xors the 32 bit fraction of each coordinate.
+	// Other sequences use a random rotation modulo 1 (Cranley-Patterson).
+	class qrng_shift {
+		std::vector<std::uint32_t> s;
+		bool digital;
+	public:
+		qrng_shift(const gsl_qrng_type* type, unsigned int dimension, const rng& r)
+			: s(dimension), digital(type == gsl_qrng_sobol || type == gsl_qrng_niederreiter_2)
+		{
+			for (auto& si : s)
+				si = static_cast<std::uint32_t>(r.uniform()*4294967296.0);
+		}
+
+		// shift n points of dimension() in place
+		void operator()(size_t n, double* x) const
+		{
+			const double two32 = 4294967296.0;
+			size_t d = s.size();
+
+			for (size_t i = 0; i < n; ++i, x += d) {
+				for (size_t j = 0; j < d; ++j) {
+					if (digital) {
+						std::uint32_t u = static_cast<std::uint32_t>(x[j]*two32);
+						x[j] = ((u^s[j]) + 0.5)/two32; // midpoint of the shifted cell
+					}
+					else {
+						x[j] += s[j]/two32;
+						if (x[j] >= 1)
+							x[j] -= 1;
+					}
+				}
+			}
+		}
+	};
+
+	// Brownian motion at times 0 < t[0] < ... < t[n-1] from n independent standard normals.
+	// The first normal sets the terminal value and later ones fill in successive midpoints
+	// so the leading coordinates of quasi-random points determine the shape of the path.
+	class brownian_bridge {
+		std::vector<size_t> index, left, right; // 1-based with 0 for time 0
+		std::vector<double> lw, rw, sd;
+	public:
+		explicit brownian_bridge(const std::vector<double>& t)
+			: index(t.size()), left(t.size()), right(t.size()), lw(t.size()), rw(t.size()), sd(t.size())
+		{
+			size_t n = t.size();
+			if (n == 0)
+				throw std::invalid_argument(__FILE__ ": " __FUNCTION__ ": there must be at least one time");
+			for (size_t i = 0; i < n; ++i)
+				if (t[i] <= (i ? t[i - 1] : 0))
+					throw std::invalid_argument(__FILE__ ": " __FUNCTION__ ": times must be positive and increasing");
+
+			auto time = [&t](size_t i) { return i ? t[i - 1] : 0.; };
+
+			index[0] = n;
+			sd[0] = sqrt(t[n - 1]);
+
+			// breadth first over intervals (l, r) with both ends known
+			std::vector<std::pair<size_t,size_t>> q{{0, n}};
+			size_t k = 1;
+			for (size_t i = 0; i < q.size(); ++i) {
+				size_t l = q[i].first, r = q[i].second;
+				if (r - l < 2)
+					continue;
+
+				size_t m = l + (r - l)/2;
+				double tl = time(l), tm = time(m), tr = time(r);
+				index[k] = m;
+				left[k] = l;
+				right[k] = r;
+				lw[k] = (tr - tm)/(tr - tl);
+				rw[k] = (tm - tl)/(tr - tl);
+				sd[k] = sqrt((tm - tl)*(tr - tm)/(tr - tl));
+				++k;
+
+				q.emplace_back(l, m);
+				q.emplace_back(m, r);
+			}
+		}
+
+		size_t size() const
+		{
+			return index.size();
+		}
+
+		// w[i] is the value at t[i] given normals z[0], ..., z[size() - 1]
+		void operator()(const double* z, double* w) const
+		{
+			auto at = [w](size_t i) { return i ? w[i - 1] : 0.; };
+
+			w[index[0] - 1] = sd[0]*z[0];
+			for (size_t k = 1; k < index.size(); ++k)
+				w[index[k] - 1] = lw[k]*at(left[k]) + rw[k]*at(right[k]) + sd[k]*z[k];
+		}
+	};
+
+} // gsl
+
+#ifdef _DEBUG
+#include <algorithm>
+#include <cassert>
+
+inline void test_gsl_qrng()
+{
+	{
+		gsl::qrng q(gsl_qrng_halton, 2);
+		assert (q.dimension() == 2);
+
+		double x[2];
+		q.get(x);
+		assert (fabs(x[0] - 1./2) < 1e-15 && fabs(x[1] - 1./3) < 1e-15);
+		q.get(x);
+		assert (fabs(x[0] - 1./4) < 1e-15 && fabs(x[1] - 2./3) < 1e-15);
+
+		// bulk matches single points
+		gsl::qrng p(q);
+		std::vector<double> y(200);
+		q.get(100, y.data());
+		for (size_t i = 0; i < 100; ++i) {
+			p.get(x);
+			assert (x[0] == y[2*i] && x[1] == y[2*i + 1]);
+		}
+
+		q.init().skip(2);
+		q.get(x);
+		assert (fabs(x[0] - 3./4) < 1e-15 && fabs(x[1] - 1./9) < 1e-15);
+	}
+	{
+		// shifted estimates of the integral of xy over the unit square
+		gsl::rng r;
+		std::vector<double> x(2*4096);
+		double avg = 0;
+		for (int k = 0; k < 8; ++k) {
+			gsl::qrng q(gsl_qrng_halton, 2);
+			q.get(4096, x.data());
+			gsl::qrng_shift(gsl_qrng_halton, 2, r)(4096, x.data());
+
+			double s = 0;
+			for (size_t i = 0; i < 4096; ++i) {
+				assert (0 <= x[2*i] && x[2*i] < 1);
+				s += x[2*i]*x[2*i + 1];
+			}
+			avg += s/4096;
+		}
+		assert (fabs(avg/8 - 0.25) < 1e-3);
+	}
+	{
+		// covariance of the bridge is min(s, t)
+		std::vector<double> t{0.25, 0.5, 1, 1.5, 2.5};
+		gsl::brownian_bridge b(t);
+		size_t n = t.size();
+
+		std::vector<double> a(n*n), z(n), w(n);
+		for (size_t j = 0; j < n; ++j) {
+			std::fill(z.begin(), z.end(), 0.);
+			z[j] = 1;
+			b(z.data(), w.data());
+			for (size_t i = 0; i < n; ++i)
+				a[i*n + j] = w[i];
+		}
+		for (size_t i = 0; i < n; ++i) {
+			for (size_t j = 0; j < n; ++j) {
+				double c = 0;
+				for (size_t k = 0; k < n; ++k)
+					c += a[i*n + k]*a[j*n + k];
+				assert (fabs(c - (t[i] < t[j] ? t[i] : t[j])) < 1e-12);
+			}
+		}
+	}
+}
+
+#endif // _DEBUG
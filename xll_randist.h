@@ -1,6 +1,227 @@
 // xll_randist.h - GSL random number distributions
 // http://www.gnu.org/software/gsl/manual/html_node/Random-Number-Distributions.html#Random-Number-Distributions
 #pragma once
+#include <cctype>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
 #include "gsl/gsl_randist.h"
 #include "gsl/gsl_cdf.h"
+#include "xll_rng.h"
+#include "xll_ziggurat.h"
 
+namespace gsl {
+
+	// x[i] = f(r, p...) for i < n with the parameters bound once
+	template<class F, class... P>
+	inline void ran_fill(const gsl_rng* r, size_t n, double* x, F f, P... p)
+	{
+		for (size_t i = 0; i < n; ++i)
+			x[i] = static_cast<double>(f(r, p...));
+	}
+
+	// Batch sampler for a GSL sampler T f(const gsl_rng*, P...) with parameters from an array.
+	template<class F, F f>
+	struct ran_batch;
+	template<class T, class... P, T (*f)(const gsl_rng*, P...)>
+	struct ran_batch<T (*)(const gsl_rng*, P...), f> {
+		enum : size_t { arity = sizeof...(P) };
+
+		template<size_t... I>
+		static void fill_(const gsl_rng* r, size_t n, double* x, const double* p, std::index_sequence<I...>)
+		{
+			ran_fill(r, n, x, f, static_cast<P>(p[I])...);
+		}
+		static void fill(rng& g, size_t n, double* x, const double* p)
+		{
+			fill_(g, n, x, p, std::index_sequence_for<P...>{});
+		}
+	};
+#define GSL_RAN_BATCH(f) gsl::ran_batch<decltype(&f), &f>
+
+	namespace detail {
+
+		// Samplers rewritten over blocks of uniforms. They give the same values as the GSL sampler.
+		inline void ran_flat(rng& g, size_t n, double* x, const double* p)
+		{
+			double a = p[0], b = p[1];
+
+			g.uniform(n, x);
+			for (size_t i = 0; i < n; ++i)
+				x[i] = a*(1 - x[i]) + b*x[i];
+		}
+		// GSL 1.13 form, later versions use log1p(-u) with u in [0,1)
+		inline void ran_exponential(rng& g, size_t n, double* x, const double* p)
+		{
+			double mu = p[0];
+
+			g.uniform_pos(n, x);
+			for (size_t i = 0; i < n; ++i)
+				x[i] = -mu*log(x[i]);
+		}
+		// ziggurat instead of the polar method
+		inline void ran_gaussian(rng& g, size_t n, double* x, const double* p)
+		{
+			gsl::ran_gaussian(g, n, x, p[0]);
+		}
+
+		inline bool positive(const double* p)
+		{
+			return p[0] > 0;
+		}
+		inline bool positive2(const double* p)
+		{
+			return p[0] > 0 && p[1] > 0;
+		}
+		inline bool probability(const double* p)
+		{
+			return 0 <= p[0] && p[0] <= 1;
+		}
+		inline bool binomial(const double* p)
+		{
+			return 0 <= p[0] && p[0] <= 1 && p[1] >= 0;
+		}
+		inline bool any(const double*)
+		{
+			return true;
+		}
+
+	} // detail
+
+	// distribution name, parameters, parameter check and batch sampler
+	struct ran_distribution {
+		const char* name;
+		const char* params; // comma separated names
+		size_t arity;
+		bool (*valid)(const double* p);
+		void (*fill)(rng& g, size_t n, double* x, const double* p);
+	};
+
+	inline const ran_distribution* ran_distributions(size_t& n)
+	{
+		using namespace detail;
+		static const ran_distribution d[] = {
+			{"BERNOULLI", "p", 1, probability, GSL_RAN_BATCH(gsl_ran_bernoulli)::fill},
+			{"BETA", "a, b", 2, positive2, GSL_RAN_BATCH(gsl_ran_beta)::fill},
+			{"BINOMIAL", "p, n", 2, binomial, GSL_RAN_BATCH(gsl_ran_binomial)::fill},
+			{"CAUCHY", "a", 1, positive, GSL_RAN_BATCH(gsl_ran_cauchy)::fill},
+			{"CHISQ", "nu", 1, positive, GSL_RAN_BATCH(gsl_ran_chisq)::fill},
+			{"EXPONENTIAL", "mu", 1, positive, detail::ran_exponential},
+			{"EXPPOW", "a, b", 2, positive2, GSL_RAN_BATCH(gsl_ran_exppow)::fill},
+			{"FDIST", "nu1, nu2", 2, positive2, GSL_RAN_BATCH(gsl_ran_fdist)::fill},
+			{"FLAT", "a, b", 2, [](const double* p) { return p[0] < p[1]; }, detail::ran_flat},
+			{"GAMMA", "a, b", 2, positive2, GSL_RAN_BATCH(gsl_ran_gamma)::fill},
+			{"GAUSSIAN", "sigma", 1, positive, detail::ran_gaussian},
+			{"GAUSSIAN_TAIL", "a, sigma", 2, [](const double* p) { return p[1] > 0; }, GSL_RAN_BATCH(gsl_ran_gaussian_tail)::fill},
+			{"GEOMETRIC", "p", 1, [](const double* p) { return 0 < p[0] && p[0] <= 1; }, GSL_RAN_BATCH(gsl_ran_geometric)::fill},
+			{"GUMBEL1", "a, b", 2, any, GSL_RAN_BATCH(gsl_ran_gumbel1)::fill},
+			{"GUMBEL2", "a, b", 2, any, GSL_RAN_BATCH(gsl_ran_gumbel2)::fill},
+			{"HYPERGEOMETRIC", "n1, n2, t", 3, [](const double* p) { return p[0] >= 0 && p[1] >= 0 && 0 <= p[2] && p[2] <= p[0] + p[1]; }, GSL_RAN_BATCH(gsl_ran_hypergeometric)::fill},
+			{"LANDAU", "", 0, any, GSL_RAN_BATCH(gsl_ran_landau)::fill},
+			{"LAPLACE", "a", 1, positive, GSL_RAN_BATCH(gsl_ran_laplace)::fill},
+			{"LEVY", "c, alpha", 2, [](const double* p) { return 0 < p[1] && p[1] <= 2; }, GSL_RAN_BATCH(gsl_ran_levy)::fill},
+			{"LEVY_SKEW", "c, alpha, beta", 3, [](const double* p) { return 0 < p[1] && p[1] <= 2 && -1 <= p[2] && p[2] <= 1; }, GSL_RAN_BATCH(gsl_ran_levy_skew)::fill},
+			{"LOGARITHMIC", "p", 1, [](const double* p) { return 0 < p[0] && p[0] < 1; }, GSL_RAN_BATCH(gsl_ran_logarithmic)::fill},
+			{"LOGISTIC", "a", 1, positive, GSL_RAN_BATCH(gsl_ran_logistic)::fill},
+			{"LOGNORMAL", "zeta, sigma", 2, [](const double* p) { return p[1] > 0; }, GSL_RAN_BATCH(gsl_ran_lognormal)::fill},
+			{"NEGATIVE_BINOMIAL", "p, n", 2, [](const double* p) { return 0 < p[0] && p[0] <= 1 && p[1] > 0; }, GSL_RAN_BATCH(gsl_ran_negative_binomial)::fill},
+			{"PARETO", "a, b", 2, positive2, GSL_RAN_BATCH(gsl_ran_pareto)::fill},
+			{"PASCAL", "p, n", 2, [](const double* p) { return 0 < p[0] && p[0] <= 1 && p[1] >= 0; }, GSL_RAN_BATCH(gsl_ran_pascal)::fill},
+			{"POISSON", "mu", 1, positive, GSL_RAN_BATCH(gsl_ran_poisson)::fill},
+			{"RAYLEIGH", "sigma", 1, positive, GSL_RAN_BATCH(gsl_ran_rayleigh)::fill},
+			{"RAYLEIGH_TAIL", "a, sigma", 2, [](const double* p) { return p[1] > 0; }, GSL_RAN_BATCH(gsl_ran_rayleigh_tail)::fill},
+			{"TDIST", "nu", 1, positive, GSL_RAN_BATCH(gsl_ran_tdist)::fill},
+			{"WEIBULL", "a, b", 2, positive2, GSL_RAN_BATCH(gsl_ran_weibull)::fill},
+		};
+		n = sizeof(d)/sizeof(*d);
+
+		return d;
+	}
+
+	// case insensitive lookup, null if there is no distribution with this name
+	inline const ran_distribution* find_ran_distribution(const char* name)
+	{
+		size_t n;
+		const ran_distribution* d = ran_distributions(n);
+		for (size_t i = 0; i < n; ++i) {
+			const char* s = d[i].name;
+			const char* t = name;
+			while (*s && *s == toupper(static_cast<unsigned char>(*t))) {
+				++s;
+				++t;
+			}
+			if (!*s && !*t)
+				return d + i;
+		}
+
+		return nullptr;
+	}
+
+	// n draws from distribution d with parameters p checked once
+	inline void ran_array(const ran_distribution& d, rng& g, size_t n, double* x, const double* p, size_t np)
+	{
+		if (np != d.arity)
+			throw std::invalid_argument(__FILE__ ": " __FUNCTION__ ": wrong number of distribution parameters");
+		if (!d.valid(p))
+			throw std::invalid_argument(__FILE__ ": " __FUNCTION__ ": distribution parameters out of range");
+
+		d.fill(g, n, x, p);
+	}
+
+} // gsl
+
+#ifdef _DEBUG
+#include <cassert>
+#include <cstring>
+#include <vector>
+
+inline void test_gsl_randist()
+{
+	size_t n;
+	const gsl::ran_distribution* d = gsl::ran_distributions(n);
+	for (size_t i = 0; i < n; ++i) {
+		size_t commas = 0;
+		for (const char* s = d[i].params; *s; ++s)
+			commas += *s == ',';
+		assert (d[i].arity == (*d[i].params ? commas + 1 : 0));
+		assert (gsl::find_ran_distribution(d[i].name) == d + i);
+		assert (i == 0 || strcmp(d[i - 1].name, d[i].name) < 0);
+	}
+	assert (gsl::find_ran_distribution("negative_binomial") == gsl::find_ran_distribution("NEGATIVE_BINOMIAL"));
+	assert (!gsl::find_ran_distribution("NORMAL"));
+	assert (!gsl::find_ran_distribution("GAUSS"));
+	assert (!gsl::find_ran_distribution("GAUSSIAN_"));
+
+	// batches match scalar GSL samplers
+	gsl::rng g, h;
+	std::vector<double> x(1000);
+	double p[] = {2, 5};
+
+	gsl::ran_array(*gsl::find_ran_distribution("FLAT"), g, x.size(), x.data(), p, 2);
+	for (auto xi : x)
+		assert (xi == gsl_ran_flat(h, 2, 5));
+	gsl::ran_array(*gsl::find_ran_distribution("EXPONENTIAL"), g, x.size(), x.data(), p, 1);
+	for (auto xi : x)
+		assert (xi == gsl_ran_exponential(h, 2));
+	double q[] = {0.3, 10};
+	gsl::ran_array(*gsl::find_ran_distribution("BINOMIAL"), g, x.size(), x.data(), q, 2);
+	for (auto xi : x)
+		assert (xi == gsl_ran_binomial(h, 0.3, 10));
+
+	// parameters are checked once per call
+	try {
+		gsl::ran_array(*gsl::find_ran_distribution("POISSON"), g, x.size(), x.data(), p, 2);
+		assert (false);
+	}
+	catch (const std::invalid_argument&) {
+	}
+	try {
+		q[0] = -1;
+		gsl::ran_array(*gsl::find_ran_distribution("POISSON"), g, x.size(), x.data(), q, 1);
+		assert (false);
+	}
+	catch (const std::invalid_argument&) {
+	}
+}
+
+#endif // _DEBUG
@@ -1,11 +1,19 @@
+#include <fstream>
+#include <iterator>
+#include "xll_base64.h"
 #include "xll_rng.h"
+#include "xll_cbrng.h"
+#include "xll_rng_bench.h"
 #include "../xll8/xll/xll.h"
+#include "xll_profile.h"
 
 using namespace xll;
 
 XLL_ENUM_DOCX(p2h<const gsl_rng_type>(gsl_rng_borosh13), GSL_RNG_BOROSH13, _T("GSL"), _T("A GSL random number generator type."), _T(""));
 XLL_ENUM_DOCX(p2h<const gsl_rng_type>(gsl_rng_coveyou), GSL_RNG_COVEYOU, _T("GSL"), _T("A GSL random number generator type."), _T(""));
 XLL_ENUM_DOCX(p2h<const gsl_rng_type>(gsl_rng_cmrg), GSL_RNG_CMRG, _T("GSL"), _T("A GSL random number generator type."), _T(""));
+XLL_ENUM_DOCX(p2h<const gsl_rng_type>(gsl::sfmt::dsfmt19937_type()), GSL_RNG_DSFMT19937, _T("GSL"), _T("A double precision SIMD oriented fast Mersenne twister random number generator type."),
+	_T("Doubles are generated directly in [1, 2) and shifted to [0, 1). "));
 XLL_ENUM_DOCX(p2h<const gsl_rng_type>(gsl_rng_fishman18), GSL_RNG_FISHMAN18, _T("GSL"), _T("A GSL random number generator type."), _T(""));
 XLL_ENUM_DOCX(p2h<const gsl_rng_type>(gsl_rng_fishman20), GSL_RNG_FISHMAN20, _T("GSL"), _T("A GSL random number generator type."), _T(""));
 XLL_ENUM_DOCX(p2h<const gsl_rng_type>(gsl_rng_fishman2x), GSL_RNG_FISHMAN2X, _T("GSL"), _T("A GSL random number generator type."), _T(""));
@@ -53,11 +61,16 @@ XLL_ENUM_DOCX(p2h<const gsl_rng_type>(gsl_rng_ranlxd2), GSL_RNG_RANLXD2, _T("GSL
 XLL_ENUM_DOCX(p2h<const gsl_rng_type>(gsl_rng_ranlxs0), GSL_RNG_RANLXS0, _T("GSL"), _T("A GSL random number generator type."), _T(""));
 XLL_ENUM_DOCX(p2h<const gsl_rng_type>(gsl_rng_ranlxs1), GSL_RNG_RANLXS1, _T("GSL"), _T("A GSL random number generator type."), _T(""));
 XLL_ENUM_DOCX(p2h<const gsl_rng_type>(gsl_rng_ranlxs2), GSL_RNG_RANLXS2, _T("GSL"), _T("A GSL random number generator type."), _T(""));
+XLL_ENUM_DOCX(p2h<const gsl_rng_type>(gsl::cbrng::philox4x32_type()), GSL_RNG_PHILOX, _T("GSL"), _T("A counter based Philox4x32-10 random number generator type."),
+	_T("Use GSL.RNG.STREAM to create independent streams from a key and stream index. "));
 XLL_ENUM_DOCX(p2h<const gsl_rng_type>(gsl_rng_ranmar), GSL_RNG_RANMAR, _T("GSL"), _T("A GSL random number generator type."), _T(""));
+XLL_ENUM_DOCX(p2h<const gsl_rng_type>(gsl::sfmt::sfmt19937_type()), GSL_RNG_SFMT19937, _T("GSL"), _T("A SIMD oriented fast Mersenne twister random number generator type."), _T(""));
 XLL_ENUM_DOCX(p2h<const gsl_rng_type>(gsl_rng_slatec), GSL_RNG_SLATEC, _T("GSL"), _T("A GSL random number generator type."), _T(""));
 XLL_ENUM_DOCX(p2h<const gsl_rng_type>(gsl_rng_taus), GSL_RNG_TAUS, _T("GSL"), _T("A GSL random number generator type."), _T(""));
 XLL_ENUM_DOCX(p2h<const gsl_rng_type>(gsl_rng_taus2), GSL_RNG_TAUS2, _T("GSL"), _T("A GSL random number generator type."), _T(""));
 XLL_ENUM_DOCX(p2h<const gsl_rng_type>(gsl_rng_taus113), GSL_RNG_TAUS113, _T("GSL"), _T("A GSL random number generator type."), _T(""));
+XLL_ENUM_DOCX(p2h<const gsl_rng_type>(gsl::cbrng::threefry4x64_type()), GSL_RNG_THREEFRY, _T("GSL"), _T("A counter based Threefry4x64-20 random number generator type."),
+	_T("Use GSL.RNG.STREAM to create independent streams from a key and stream index. "));
 XLL_ENUM_DOCX(p2h<const gsl_rng_type>(gsl_rng_transputer), GSL_RNG_TRANSPUTER, _T("GSL"), _T("A GSL random number generator type."), _T(""));
 XLL_ENUM_DOCX(p2h<const gsl_rng_type>(gsl_rng_tt800), GSL_RNG_TT800, _T("GSL"), _T("A GSL random number generator type."), _T(""));
 XLL_ENUM_DOCX(p2h<const gsl_rng_type>(gsl_rng_uni), GSL_RNG_UNI, _T("GSL"), _T("A GSL random number generator type."), _T(""));
@@ -72,10 +85,13 @@ static AddIn xai_rng(
 	.Uncalced()
 	.Category(_T("GSL"))
 	.FunctionHelp(_T("Return a handle to a GSL random number generator."))
+	.Documentation(_T("The generator has a single state. GSL.RAN.* functions recalculating on multiple threads take turns drawing from it. ")
+		_T("Use GSL.RNG.POOL to give each thread its own stream instead. "))
 );
 HANDLEX WINAPI xll_rng(HANDLEX type)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	handlex h;
 
 	try {
@@ -87,6 +103,131 @@ HANDLEX WINAPI xll_rng(HANDLEX type)
 		h = h_.get();
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return h;
+}
+
+static AddIn xai_rng_pool(
+	FunctionX(XLL_HANDLEX, _T("?xll_rng_pool"), _T("GSL.RNG.POOL"))
+	.Arg(XLL_LONGX, _T("Seed"), _T("is the seed of the master generator, or the key of counter based generators. Default is 0 which uses the GSL default seed"))
+	.Arg(XLL_HANDLEX, _T("Type"), _T("is the type of random number generator from GSL_RNG_* enumeration. Default is GSL_RNG_MT19937()"))
+	.Arg(XLL_WORDX, _T("Log2Stride"), _T("is the base 2 logarithm of the number of draws between thread streams. Default is 100"))
+	.Uncalced()
+	.Category(_T("GSL"))
+	.FunctionHelp(_T("Return a handle to a random number generator with one stream per recalculation thread."))
+	.Documentation(
+		_T("The handle can be used anywhere a handle returned by GSL.RNG is expected. ")
+		_T("Each thread that draws from it gets its own stream so GSL.RAN.* functions can recalculate on every core. ")
+		_T("Streams are split from a master generator as in GSL.RNG.SPLIT, or are streams 0, 1, ... of the key for ")
+		_T("counter based generators. The first thread to draw gets the master sequence. ")
+		_T("Type must be the Mersenne twister, mrg, cmrg or counter based. ")
+	)
+);
+HANDLEX WINAPI xll_rng_pool(LONG seed, HANDLEX type, WORD e)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	handlex h;
+
+	try {
+		handle<gsl::rng> h_(new gsl::rng_pool(type ? h2p<gsl_rng_type>(type) : gsl_rng_mt19937, seed, e ? e : 100));
+
+		h = h_.get();
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return h;
+}
+
+static AddIn xai_rng_save(
+	FunctionX(XLL_LPOPERX, _T("?xll_rng_save"), _T("GSL.RNG.SAVE"))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_CSTRINGX, _T("File"), _T("is an optional file to write the binary state to."))
+	.Category(_T("GSL"))
+	.FunctionHelp(_T("Return the type and state of a random number generator as a base64 string, or write it to File."))
+	.Documentation(
+		_T("GSL.RNG.LOAD creates a generator that continues exactly where rng was when this was called. ")
+		_T("If File is given the state is written in binary and File is returned. ")
+		_T("Generators with large states such as GSL_RNG_GFSR4 do not fit in a cell and need File. ")
+		_T("For GSL.RNG.POOL handles this saves the stream of the calling thread. ")
+		_T("States can only be loaded by a build with the same state layout. ")
+	)
+);
+LPOPERX WINAPI xll_rng_save(HANDLEX rng, const xchar* file)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	static OPERX o;
+
+	try {
+		handle<gsl::rng> r(rng);
+		std::string b = r->save();
+
+		if (file && *file) {
+			std::ofstream os(file, std::ios::binary);
+			ensure (os || !"GSL.RNG.SAVE: could not open file");
+			os.write(b.data(), b.size());
+			ensure (os || !"GSL.RNG.SAVE: write failed");
+
+			o = file;
+		}
+		else {
+			std::string t = xll::base64::encode(b);
+			// Excel cells hold at most 32767 characters
+			ensure (t.size() <= 32767 || !"GSL.RNG.SAVE: state is too large for a cell; pass File to save it in binary");
+			o = OPERX(std::basic_string<xchar>(t.begin(), t.end()).c_str());
+		}
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+
+		return 0;
+	}
+
+	return &o;
+}
+
+static AddIn xai_rng_load(
+	FunctionX(XLL_HANDLEX, _T("?xll_rng_load"), _T("GSL.RNG.LOAD"))
+	.Arg(XLL_CSTRINGX, _T("State"), _T("is a base64 string returned by GSL.RNG.SAVE."))
+	.Arg(XLL_CSTRINGX, _T("File"), _T("is an optional file written by GSL.RNG.SAVE to read instead of State."))
+	.Uncalced()
+	.Category(_T("GSL"))
+	.FunctionHelp(_T("Return a handle to a random number generator restored from GSL.RNG.SAVE."))
+	.Documentation(_T("The generator has the saved type and continues exactly where the saved generator stopped. "))
+);
+HANDLEX WINAPI xll_rng_load(const xchar* state, const xchar* file)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	handlex h;
+
+	try {
+		std::string b;
+
+		if (file && *file) {
+			std::ifstream is(file, std::ios::binary);
+			ensure (is || !"GSL.RNG.LOAD: could not open file");
+			b.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+		}
+		else {
+			std::basic_string<xchar> t(state);
+			b = xll::base64::decode(std::string(t.begin(), t.end()));
+		}
+
+		handle<gsl::rng> h_(new gsl::rng(gsl::rng::load(b)));
+
+		h = h_.get();
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -102,6 +243,7 @@ static AddIn xai_rng_max(
 double WINAPI xll_rng_max(HANDLEX rng)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex x;
 
 	try {
@@ -110,6 +252,7 @@ double WINAPI xll_rng_max(HANDLEX rng)
 		x = (r->max)();
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -125,6 +268,7 @@ static AddIn xai_rng_min(
 double WINAPI xll_rng_min(HANDLEX rng)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex x;
 
 	try {
@@ -133,16 +277,306 @@ double WINAPI xll_rng_min(HANDLEX rng)
 		x = (r->max)();
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
 	return x;
 }
 
+static AddIn xai_rng_stream(
+	FunctionX(XLL_HANDLEX, _T("?xll_rng_stream"), _T("GSL.RNG.STREAM"))
+	.Arg(XLL_DOUBLEX, _T("Key"), _T("is the key shared by all streams of a simulation."))
+	.Arg(XLL_DOUBLEX, _T("Stream"), _T("is the index of the stream, e.g. a thread or path number."))
+	.Arg(XLL_DOUBLEX, _T("Position"), _T("is the number of values to skip at the start of the stream. Default is 0"))
+	.Arg(XLL_HANDLEX, _T("Type"), _T("is GSL_RNG_PHILOX() or GSL_RNG_THREEFRY(). Default is GSL_RNG_PHILOX()"))
+	.Uncalced()
+	.Category(_T("GSL"))
+	.FunctionHelp(_T("Return a handle to a counter based random number generator positioned in stream (Key, Stream)."))
+	.Documentation(
+		_T("Counter based generators compute output i of a stream directly from the key, stream index and i ")
+		_T("so every stream is independent and skipping ahead takes constant time. ")
+	)
+);
+HANDLEX WINAPI xll_rng_stream(double key, double stream, double position, HANDLEX type)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	handlex h;
+
+	try {
+		ensure (key >= 0 && stream >= 0 && position >= 0);
+
+		handle<gsl::rng> h_(new gsl::rng(type ? h2p<gsl_rng_type>(type) : gsl::cbrng::philox4x32_type()));
+		ensure (gsl::cbrng::is_counter(*h_) || !"GSL.RNG.STREAM: Type must be a counter based generator");
+		gsl::cbrng::set(*h_, static_cast<std::uint64_t>(key), static_cast<std::uint64_t>(stream), static_cast<std::uint64_t>(position));
+
+		h = h_.get();
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return h;
+}
+
+static AddIn xai_rng_split(
+	FunctionX(XLL_FPX, _T("?xll_rng_split"), _T("GSL.RNG.SPLIT"))
+	.Arg(XLL_HANDLEX, _T("rng"), _T("is a handle returned by GSL.RNG."))
+	.Arg(XLL_WORDX, _T("k"), _T("is the number of generators to return."))
+	.Arg(XLL_WORDX, _T("Log2Stride"), _T("is the base 2 logarithm of the number of draws between generators. Default is 100"))
+	.Uncalced()
+	.Category(_T("GSL"))
+	.FunctionHelp(_T("Return a column of k handles to generators spaced 2^Log2Stride draws apart in the sequence of rng."))
+	.Documentation(
+		_T("The first generator is a copy of rng. The streams do not overlap as long as each uses fewer than 2^Log2Stride draws. ")
+		_T("The Mersenne twister jumps using its characteristic polynomial and mrg and cmrg use powers of their transition matrices. ")
+		_T("Counter based generators should use GSL.RNG.STREAM instead. ")
+	)
+);
+xfpx* WINAPI xll_rng_split(HANDLEX rng, WORD k, WORD e)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	static FPX h;
+
+	try {
+		if (e == 0)
+			e = 100;
+
+		handle<gsl::rng> r(rng);
+		ensure (k > 0);
+
+		std::vector<gsl::rng> rs = r->split(k, e);
+
+		h.resize(k, 1);
+		for (WORD i = 0; i < k; ++i) {
+			handle<gsl::rng> h_(new gsl::rng(rs[i]));
+			h[i] = h_.get();
+		}
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+
+		return 0;
+	}
+
+	return h.get();
+}
+
+// Array functions create their own generator so the result only depends on the arguments.
+#define IS_ROWS _T("is the number of rows to return.")
+#define IS_COLUMNS _T("is the number of columns to return. Default is 1")
+#define IS_SEED _T("is the seed of the generator. Default is 0 which uses the GSL default seed")
+#define IS_TYPE _T("is the type of random number generator from GSL_RNG_* enumeration. Default is GSL_RNG_MT19937()")
+
+inline const gsl_rng_type* rng_type(HANDLEX type)
+{
+	return type ? h2p<const gsl_rng_type>(type) : gsl_rng_mt19937;
+}
+
+inline void rng_resize(FPX& x, WORD rows, WORD columns)
+{
+	ensure (rows > 0 || !"GSL.RNG.*.ARRAY: Rows must be positive");
+
+	x.resize(rows, columns ? columns : 1);
+}
+
+static AddInX xai_rng_uniform_array(
+	FunctionX(XLL_FPX, _T("?xll_rng_uniform_array"), _T("GSL.RNG.UNIFORM.ARRAY"))
+	.Arg(XLL_WORDX, _T("Rows"), IS_ROWS)
+	.Arg(XLL_WORDX, _T("Columns"), IS_COLUMNS)
+	.Arg(XLL_LONGX, _T("Seed"), IS_SEED)
+	.Arg(XLL_HANDLEX, _T("Type"), IS_TYPE)
+	.ThreadSafe()
+	.Category(_T("GSL"))
+	.FunctionHelp(_T("Return an array of random numbers uniformly distributed in [0, 1)."))
+	.Documentation(_T("The values are filled in row major order from a new generator set to Seed. "))
+);
+xfpx* WINAPI xll_rng_uniform_array(WORD rows, WORD columns, LONG seed, HANDLEX type)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	static thread_local FPX x;
+
+	try {
+		gsl::rng r(rng_type(type));
+		r.set(seed);
+
+		rng_resize(x, rows, columns);
+		r.uniform(x.size(), x.array());
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+
+		return 0;
+	}
+
+	return x.get();
+}
+
+static AddInX xai_rng_uniform_pos_array(
+	FunctionX(XLL_FPX, _T("?xll_rng_uniform_pos_array"), _T("GSL.RNG.UNIFORM.POS.ARRAY"))
+	.Arg(XLL_WORDX, _T("Rows"), IS_ROWS)
+	.Arg(XLL_WORDX, _T("Columns"), IS_COLUMNS)
+	.Arg(XLL_LONGX, _T("Seed"), IS_SEED)
+	.Arg(XLL_HANDLEX, _T("Type"), IS_TYPE)
+	.ThreadSafe()
+	.Category(_T("GSL"))
+	.FunctionHelp(_T("Return an array of random numbers uniformly distributed in (0, 1)."))
+	.Documentation(_T("The values are filled in row major order from a new generator set to Seed. "))
+);
+xfpx* WINAPI xll_rng_uniform_pos_array(WORD rows, WORD columns, LONG seed, HANDLEX type)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	static thread_local FPX x;
+
+	try {
+		gsl::rng r(rng_type(type));
+		r.set(seed);
+
+		rng_resize(x, rows, columns);
+		r.uniform_pos(x.size(), x.array());
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+
+		return 0;
+	}
+
+	return x.get();
+}
+
+static AddInX xai_rng_uniform_int_array(
+	FunctionX(XLL_FPX, _T("?xll_rng_uniform_int_array"), _T("GSL.RNG.UNIFORM.INT.ARRAY"))
+	.Arg(XLL_DOUBLEX, _T("n"), _T("is one more than the largest integer to return. It must be at most the range of the generator."))
+	.Arg(XLL_WORDX, _T("Rows"), IS_ROWS)
+	.Arg(XLL_WORDX, _T("Columns"), IS_COLUMNS)
+	.Arg(XLL_LONGX, _T("Seed"), IS_SEED)
+	.Arg(XLL_HANDLEX, _T("Type"), IS_TYPE)
+	.ThreadSafe()
+	.Category(_T("GSL"))
+	.FunctionHelp(_T("Return an array of random integers uniformly distributed in [0, n)."))
+	.Documentation(_T("The values are filled in row major order from a new generator set to Seed. "))
+);
+xfpx* WINAPI xll_rng_uniform_int_array(double n, WORD rows, WORD columns, LONG seed, HANDLEX type)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	static thread_local FPX x;
+
+	try {
+		gsl::rng r(rng_type(type));
+		// check before converting since casting an out of range double is undefined
+		ensure ((n >= 1 && n <= static_cast<double>(r.max() - r.min())) || !"GSL.RNG.UNIFORM.INT.ARRAY: n must be at least 1 and at most the range of the generator");
+		r.set(seed);
+
+		rng_resize(x, rows, columns);
+		r.uniform_int(static_cast<unsigned long>(n), x.size(), x.array());
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+
+		return 0;
+	}
+
+	return x.get();
+}
+
+static AddInX xai_rng_get_array(
+	FunctionX(XLL_FPX, _T("?xll_rng_get_array"), _T("GSL.RNG.GET.ARRAY"))
+	.Arg(XLL_WORDX, _T("Rows"), IS_ROWS)
+	.Arg(XLL_WORDX, _T("Columns"), IS_COLUMNS)
+	.Arg(XLL_LONGX, _T("Seed"), IS_SEED)
+	.Arg(XLL_HANDLEX, _T("Type"), IS_TYPE)
+	.ThreadSafe()
+	.Category(_T("GSL"))
+	.FunctionHelp(_T("Return an array of raw generator output uniformly distributed in [min, max]."))
+	.Documentation(_T("The values are filled in row major order from a new generator set to Seed. "))
+);
+xfpx* WINAPI xll_rng_get_array(WORD rows, WORD columns, LONG seed, HANDLEX type)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	static thread_local FPX x;
+
+	try {
+		gsl::rng r(rng_type(type));
+		r.set(seed);
+
+		rng_resize(x, rows, columns);
+		r.get(x.size(), x.array());
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+
+		return 0;
+	}
+
+	return x.get();
+}
+
+static AddInX xai_rng_benchmark(
+	FunctionX(XLL_LPOPERX, _T("?xll_rng_benchmark"), _T("GSL.RNG.BENCHMARK"))
+	.Arg(XLL_DOUBLEX, _T("Count"), _T("is the number of uniform values to draw from each generator. Default is 1000000"))
+	.Category(_T("GSL"))
+	.FunctionHelp(_T("Return a table of nanoseconds per uniform value for every GSL_RNG_* generator type."))
+	.Documentation(
+		_T("The first row is a header. Single is the time per call to gsl_rng_uniform and ")
+		_T("Bulk is the time per value filling a buffer of 1024 using the array fast paths. ")
+		_T("Generators are seeded with the GSL default seed. ")
+	)
+);
+LPOPERX WINAPI xll_rng_benchmark(double count)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	static OPERX o;
+
+	try {
+		size_t n = count > 0 ? static_cast<size_t>(count) : 1000000;
+
+		const std::vector<const gsl_rng_type*>& types = gsl::rng_types();
+
+		o.resize(static_cast<xword>(types.size() + 1), 3);
+		o[0] = _T("Type");
+		o[1] = _T("Single");
+		o[2] = _T("Bulk");
+		for (size_t i = 0; i < types.size(); ++i) {
+			gsl::rng_timing timing = gsl::rng_benchmark(types[i], n);
+			xword r = static_cast<xword>(3*(i + 1));
+
+			o[r] = OPERX(std::basic_string<xchar>(types[i]->name, types[i]->name + strlen(types[i]->name)).c_str());
+			o[r + 1] = timing.single;
+			o[r + 2] = timing.bulk;
+		}
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+
+		return 0;
+	}
+
+	return &o;
+}
+
 #ifdef _DEBUG
 XLL_TEST_BEGIN(xll_rng_test)
 
 gsl_rng_test();
+test_gsl_cbrng();
+test_gsl_rng_jump();
+test_gsl_sfmt();
+test_gsl_rng_bench();
+test_xll_base64();
 
 XLL_TEST_END(xll_rng_test)
 #endif // _DEBUG
\ No newline at end of file
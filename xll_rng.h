@@ -1,29 +1,81 @@
 // xll_rng.h - Random number generation
 // http://www.gnu.org/software/gsl/manual/html_node/Random-Number-Generation.html#Random-Number-Generation
 #pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
 #include <memory> // std::unique_ptr
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include "gsl/gsl_rng.h"
+#include "xll_cbrng.h"
+#include "xll_rng_jump.h"
+#include "xll_sfmt.h"
 
 namespace gsl {
 
+	// GSL generator types followed by the types added here
+	inline const std::vector<const gsl_rng_type*>& rng_types()
+	{
+		static const std::vector<const gsl_rng_type*> ts = []() {
+			std::vector<const gsl_rng_type*> ts;
+			for (const gsl_rng_type** t = gsl_rng_types_setup(); *t; ++t)
+				ts.push_back(*t);
+			ts.push_back(gsl::cbrng::philox4x32_type());
+			ts.push_back(gsl::cbrng::threefry4x64_type());
+			ts.push_back(gsl::sfmt::sfmt19937_type());
+			ts.push_back(gsl::sfmt::dsfmt19937_type());
+
+			return ts;
+		}();
+
+		return ts;
+	}
+	// null if there is no type with this name
+	inline const gsl_rng_type* find_rng_type(const std::string& name)
+	{
+		for (const gsl_rng_type* t : rng_types())
+			if (name == t->name)
+				return t;
+
+		return nullptr;
+	}
+
 	class rng {
+	protected:
 		// call gsl_rng_free when out of scope
 		std::unique_ptr<::gsl_rng,decltype(&::gsl_rng_free)> r;
+
+		// the generator draws come from
+		virtual ::gsl_rng* ptr() const
+		{
+			return r.get();
+		}
+	private:
+		mutable std::mutex guard; // held by lock()
 	public:
 		explicit rng(const gsl_rng_type *type = gsl_rng_mt19937)
 			: r{gsl_rng_alloc(type), &::gsl_rng_free}
 		{ }
+		// copies the stream of the calling thread for pools
 		rng(const rng& r)
-			: r{gsl_rng_clone(r.r.get()), &::gsl_rng_free}
+			: r{gsl_rng_clone(r.ptr()), &::gsl_rng_free}
+		{ }
+		virtual ~rng()
 		{ }
 		rng& operator=(const rng& r_)
 		{ 
 			if (this != &r_) {
-				if (r->type != r_.r->type) {
-					r.reset(gsl_rng_clone(r_.r.get()));
+				if (r->type != r_.ptr()->type) {
+					r.reset(gsl_rng_clone(r_.ptr()));
 				}
 				else {
-					gsl_rng_memcpy(r.get(), r_.r.get());
+					gsl_rng_memcpy(r.get(), r_.ptr());
 				}
 			}
 
@@ -33,26 +85,33 @@ namespace gsl {
 		// to interoperate with GSL C functions
 		operator const gsl_rng*()
 		{
-			return r.get();
+			return ptr();
+		}
+
+		// Hold while drawing from a generator shared by concurrent threads.
+		// Pools give each thread its own stream and return a lock that owns nothing.
+		virtual std::unique_lock<std::mutex> lock() const
+		{
+			return std::unique_lock<std::mutex>(guard);
 		}
 
 		// rng properties
 		unsigned long max() const
 		{
-			return gsl_rng_max(r.get());
+			return gsl_rng_max(ptr());
 		}
 		unsigned long min() const
 		{
-			return gsl_rng_min(r.get());
+			return gsl_rng_min(ptr());
 		}
 		const char* name() const
 		{
-			return gsl_rng_name(r.get());
+			return gsl_rng_name(ptr());
 		}
 	
 		rng& set(unsigned long int s)
 		{
-			gsl_rng_set(r.get(), s);
+			gsl_rng_set(ptr(), s);
 
 			return *this;
 		}
@@ -60,29 +119,290 @@ namespace gsl {
 		// uniformly distributed in the range [min(), max()]
 		unsigned long get() const
 		{
-			return gsl_rng_get(r.get());
+			return gsl_rng_get(ptr());
 		}
 		// uniformly distributed in the range [0,1)
 		double uniform() const
 		{
-			return gsl_rng_uniform(r.get());
+			return gsl_rng_uniform(ptr());
 		}
 		// uniformly distributed in the range (0,1)
 		double uniform_pos() const
 		{
-			return gsl_rng_uniform_pos(r.get());
+			return gsl_rng_uniform_pos(ptr());
 		}
 		// uniformly distributed in the range [0, n)
 		unsigned long uniform_int(unsigned long n) const
 		{
-			return gsl_rng_uniform_int(r.get(), n);
+			return gsl_rng_uniform_int(ptr(), n);
+		}
+
+		// Blob with the type name and a copy of the state so load continues exactly
+		// where this left off: "GRNG", version, name length, name, state size (little endian), state.
+		// The state layout depends on the build so load checks the size.
+		std::string save() const
+		{
+			const ::gsl_rng* p = ptr();
+			std::string name = gsl_rng_name(p);
+			std::uint32_t size = static_cast<std::uint32_t>(gsl_rng_size(p));
+
+			if (name.size() > 255)
+				throw std::length_error(__FILE__ ": " __FUNCTION__ ": generator name too long");
+
+			std::string b("GRNG");
+			b += static_cast<char>(1);
+			b += static_cast<char>(name.size());
+			b += name;
+			for (int i = 0; i < 4; ++i)
+				b += static_cast<char>((size >> 8*i) & 0xFF);
+			b.append(static_cast<const char*>(gsl_rng_state(p)), size);
+
+			return b;
+		}
+		static rng load(const std::string& b)
+		{
+			if (b.size() < 6 || b.compare(0, 4, "GRNG") != 0 || b[4] != 1)
+				throw std::invalid_argument(__FILE__ ": " __FUNCTION__ ": not a saved generator");
+
+			size_t n = static_cast<unsigned char>(b[5]);
+			if (b.size() < 6 + n + 4)
+				throw std::invalid_argument(__FILE__ ": " __FUNCTION__ ": saved generator is truncated");
+
+			const gsl_rng_type* type = find_rng_type(b.substr(6, n));
+			if (!type)
+				throw std::invalid_argument(__FILE__ ": " __FUNCTION__ ": unknown generator type");
+
+			std::uint32_t size = 0;
+			for (int i = 0; i < 4; ++i)
+				size |= static_cast<std::uint32_t>(static_cast<unsigned char>(b[6 + n + i])) << 8*i;
+			if (size != type->size || b.size() != 6 + n + 4 + size)
+				throw std::invalid_argument(__FILE__ ": " __FUNCTION__ ": saved state does not match the generator type");
+
+			rng r(type);
+			std::memcpy(gsl_rng_state(r.r.get()), b.data() + 6 + n + 4, size);
+
+			return r;
+		}
+
+		// advance as if get() was called n times
+		// Supported for the Mersenne twister, mrg, cmrg and counter based generators.
+		rng& jump(std::uint64_t n)
+		{
+			gsl::jump::ahead(ptr(), n);
+
+			return *this;
+		}
+		// k generators where generator i starts i 2^e draws after this one
+		// The streams are disjoint if each uses at most 2^e draws.
+		virtual std::vector<rng> split(size_t k, unsigned e = 100) const
+		{
+			std::vector<rng> rs;
+			rs.reserve(k);
+
+			if (k > 0)
+				rs.push_back(*this);
+			while (rs.size() < k) {
+				rs.push_back(rs.back());
+				gsl::jump::ahead_pow2(rs.back().r.get(), e);
+			}
+
+			return rs;
+		}
+
+		// Bulk versions fill x[0], ..., x[n-1] with the same values as n single calls.
+		// They call the generator through its type directly instead of once per value
+		// through the gsl_rng_* wrappers. SFMT types copy whole regenerated blocks and
+		// counter based types generate several blocks at once.
+		template<class T>
+		void get(size_t n, T* x) const
+		{
+			if (gsl::sfmt::get(ptr(), n, x) || gsl::cbrng::get(ptr(), n, x))
+				return;
+
+			unsigned long (*get)(void*) = ptr()->type->get;
+			void* state = ptr()->state;
+
+			for (size_t i = 0; i < n; ++i)
+				x[i] = static_cast<T>(get(state));
+		}
+		void uniform(size_t n, double* x) const
+		{
+			if (gsl::sfmt::uniform(ptr(), n, x) || gsl::cbrng::uniform(ptr(), n, x))
+				return;
+
+			double (*get_double)(void*) = ptr()->type->get_double;
+			void* state = ptr()->state;
+
+			for (size_t i = 0; i < n; ++i)
+				x[i] = get_double(state);
+		}
+		void uniform_pos(size_t n, double* x) const
+		{
+			double (*get_double)(void*) = ptr()->type->get_double;
+			void* state = ptr()->state;
+
+			for (size_t i = 0; i < n; ++i) {
+				do {
+					x[i] = get_double(state);
+				} while (x[i] == 0);
+			}
+		}
+		// same algorithm as gsl_rng_uniform_int
+		template<class T>
+		void uniform_int(unsigned long m, size_t n, T* x) const
+		{
+			unsigned long (*get)(void*) = ptr()->type->get;
+			void* state = ptr()->state;
+			unsigned long offset = ptr()->type->min;
+			unsigned long range = ptr()->type->max - offset;
+
+			if (m > range || m == 0)
+				throw std::invalid_argument(__FILE__ ": " __FUNCTION__ ": m must be positive and at most max() - min()");
+
+			unsigned long scale = range/m;
+			for (size_t i = 0; i < n; ++i) {
+				unsigned long k;
+				do {
+					k = (get(state) - offset)/scale;
+				} while (k >= m);
+				x[i] = static_cast<T>(k);
+			}
+		}
+	};
+
+	// One stream per thread split from a master generator so a single handle can be
+	// used by concurrent recalc threads. Stream i starts i 2^e draws after the master,
+	// or is stream i of key seed for counter based generators. Streams are handed out
+	// to threads in the order they first draw, so a single thread sees the master sequence.
+	class rng_pool : public rng {
+		std::uint64_t id; // unlike this, never reused
+		unsigned long key;
+		unsigned e;
+		mutable std::mutex m;
+		mutable std::unique_ptr<::gsl_rng,decltype(&::gsl_rng_free)> next; // start of the next stream
+		mutable std::vector<std::unique_ptr<::gsl_rng,decltype(&::gsl_rng_free)>> streams;
+
+		::gsl_rng* create() const
+		{
+			std::lock_guard<std::mutex> lock(m);
+
+			streams.emplace_back(gsl_rng_clone(next.get()), &::gsl_rng_free);
+			if (gsl::cbrng::is_counter(next.get()))
+				gsl::cbrng::set(next.get(), key, streams.size());
+			else
+				gsl::jump::ahead_pow2(next.get(), e);
+
+			return streams.back().get();
+		}
+
+		// ids of live pools and the number destroyed so threads know when to prune
+		struct registry {
+			std::mutex m;
+			std::unordered_set<std::uint64_t> ids;
+			std::atomic<std::uint64_t> destroyed{0};
+		};
+		static registry& pools()
+		{
+			static registry g;
+
+			return g;
+		}
+		// streams of each pool the calling thread has drawn from
+		struct cache {
+			std::uint64_t destroyed = 0;
+			std::unordered_map<std::uint64_t, ::gsl_rng*> streams;
+		};
+		static cache& thread_cache()
+		{
+			static thread_local cache c;
+
+			return c;
+		}
+		::gsl_rng* ptr() const override
+		{
+			cache& c = thread_cache();
+			registry& g = pools();
+
+			std::uint64_t d = g.destroyed.load(std::memory_order_acquire);
+			if (c.destroyed != d) {
+				std::lock_guard<std::mutex> lock(g.m);
+				for (auto i = c.streams.begin(); i != c.streams.end(); )
+					i = g.ids.count(i->first) ? std::next(i) : c.streams.erase(i);
+				c.destroyed = d;
+			}
+
+			auto i = c.streams.find(id);
+			if (i != c.streams.end())
+				return i->second;
+
+			return c.streams[id] = create();
+		}
+	public:
+		// Counter based generators use seed as the key.
+		explicit rng_pool(const gsl_rng_type *type = gsl_rng_mt19937, unsigned long seed = 0, unsigned e = 100)
+			: rng(type), key(seed), e(e), next{nullptr, &::gsl_rng_free}
+		{
+			static std::atomic<std::uint64_t> serial(0);
+			id = ++serial;
+
+			if (gsl::cbrng::is_counter(r.get())) {
+				gsl::cbrng::set(r.get(), seed, 0);
+			}
+			else {
+				if (!gsl::jump::can_jump(r.get()))
+					throw std::invalid_argument(__FILE__ ": " __FUNCTION__ ": generator type must support jump ahead or be counter based");
+				gsl_rng_set(r.get(), seed);
+			}
+			next.reset(gsl_rng_clone(r.get()));
+
+			registry& g = pools();
+			std::lock_guard<std::mutex> lock(g.m);
+			g.ids.insert(id);
+		}
+		rng_pool(const rng_pool&) = delete;
+		rng_pool& operator=(const rng_pool&) = delete;
+		~rng_pool()
+		{
+			registry& g = pools();
+			{
+				std::lock_guard<std::mutex> lock(g.m);
+				g.ids.erase(id);
+			}
+			++g.destroyed;
+		}
+
+		std::unique_lock<std::mutex> lock() const override
+		{
+			return std::unique_lock<std::mutex>();
+		}
+		// streams split from a thread stream would overlap the streams of other threads
+		std::vector<rng> split(size_t, unsigned = 100) const override
+		{
+			throw std::invalid_argument(__FILE__ ": " __FUNCTION__ ": pools can not be split; use GSL.RNG to create the generator");
+		}
+
+		// number of threads that have drawn
+		size_t size() const
+		{
+			std::lock_guard<std::mutex> lock(m);
+
+			return streams.size();
+		}
+		// number of pools the calling thread has a stream from, including destroyed
+		// pools until its next draw from any pool
+		static size_t cached()
+		{
+			return thread_cache().streams.size();
 		}
 	};
 
 } // gsl
 
 #ifdef _DEBUG
+#include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <thread>
 #include <vector>
 
 inline void gsl_rng_test()
@@ -128,6 +448,154 @@ inline void gsl_rng_test()
 			assert (abs(hist[i] - 1e5) < 5e2);
 
 	}
+	{
+		// bulk draws match single draws from the same seed
+		for (const gsl_rng_type* t : {gsl_rng_mt19937, gsl::sfmt::sfmt19937_type(), gsl::sfmt::dsfmt19937_type(),
+			gsl::cbrng::philox4x32_type(), gsl::cbrng::threefry4x64_type()}) {
+			gsl::rng r(t), s(t);
+			std::vector<double> x(1000);
+			std::vector<unsigned long> k(1000);
+
+			r.set(42);
+			s.set(42);
+			r.uniform(x.size(), x.data());
+			for (auto xi : x)
+				assert (xi == s.uniform());
+			r.uniform_pos(x.size(), x.data());
+			for (auto xi : x)
+				assert (xi == s.uniform_pos() && xi > 0);
+			r.get(k.size(), k.data());
+			for (auto ki : k)
+				assert (ki == s.get());
+			r.uniform_int(7, k.size(), k.data());
+			for (auto ki : k)
+				assert (ki == s.uniform_int(7));
+			r.uniform_int(7, x.size(), x.data());
+			for (auto xi : x)
+				assert (xi == s.uniform_int(7));
+		}
+	}
+	{
+		// loaded generators continue where the saved one stopped
+		for (const gsl_rng_type* t : {gsl_rng_mt19937, gsl_rng_cmrg, gsl::cbrng::philox4x32_type(), gsl::sfmt::dsfmt19937_type()}) {
+			gsl::rng r(t);
+			r.set(11);
+			for (int i = 0; i < 1000; ++i)
+				r.get();
+
+			gsl::rng s = gsl::rng::load(r.save());
+			assert (strcmp(s.name(), r.name()) == 0);
+			for (int i = 0; i < 1000; ++i)
+				assert (s.uniform() == r.uniform());
+		}
+
+		std::string b = gsl::rng().save();
+		for (size_t n : {size_t(0), size_t(5), b.size() - 1}) {
+			try {
+				gsl::rng::load(b.substr(0, n));
+				assert (false);
+			}
+			catch (const std::invalid_argument&) {
+			}
+		}
+	}
+	{
+		// the first thread to draw from a pool gets the master sequence
+		gsl::rng r;
+		r.set(7);
+		gsl::rng_pool p(gsl_rng_mt19937, 7, 12);
+		for (int i = 0; i < 100; ++i)
+			assert (p.get() == r.get());
+		assert (p.size() == 1);
+
+		// other threads get the following streams
+		std::vector<unsigned long> x(100);
+		std::thread t([&p, &x]() {
+			p.get(x.size(), x.data());
+		});
+		t.join();
+		assert (p.size() == 2);
+		r.set(7);
+		r.jump(1 << 12);
+		for (auto xi : x)
+			assert (xi == r.get());
+
+		// concurrent draws from counter based streams
+		gsl::rng_pool q(gsl::cbrng::philox4x32_type(), 42);
+		std::vector<std::thread> ts;
+		std::vector<double> y(4);
+		for (size_t i = 0; i < y.size(); ++i)
+			ts.emplace_back([&q, &y, i]() {
+				for (int j = 0; j < 1000; ++j)
+					y[i] += q.uniform();
+			});
+		for (auto& ti : ts)
+			ti.join();
+		assert (q.size() == 4);
+		for (size_t i = 0; i < y.size(); ++i)
+			for (size_t j = 0; j < i; ++j)
+				assert (y[i] != y[j]);
+	}
+	{
+		// streams of destroyed pools are dropped from the thread cache
+		gsl::rng_pool p;
+		p.get();
+		size_t n = gsl::rng_pool::cached();
+		for (int i = 0; i < 100; ++i) {
+			gsl::rng_pool q(gsl_rng_mt19937, i);
+			q.get();
+		}
+		p.get();
+		assert (gsl::rng_pool::cached() == n);
+
+		// copies continue the stream of the calling thread
+		gsl::rng c(p);
+		assert (c.get() == p.get());
+		try {
+			p.split(2);
+			assert (false);
+		}
+		catch (const std::invalid_argument&) {
+		}
+	}
+	{
+		// threads sharing one generator under lock() draw each value exactly once
+		gsl::rng r, s;
+		std::vector<std::thread> ts;
+		std::vector<std::vector<unsigned long>> x(4);
+		for (size_t i = 0; i < x.size(); ++i)
+			ts.emplace_back([&r, &x, i]() {
+				for (int j = 0; j < 1000; ++j) {
+					auto lock = r.lock();
+					x[i].push_back(r.get());
+				}
+			});
+		for (auto& ti : ts)
+			ti.join();
+
+		std::vector<unsigned long> y, z(4000);
+		for (auto& xi : x)
+			y.insert(y.end(), xi.begin(), xi.end());
+		s.get(z.size(), z.data());
+		std::sort(y.begin(), y.end());
+		std::sort(z.begin(), z.end());
+		assert (y == z);
+	}
+	{
+		// split streams follow each other in the parent sequence
+		gsl::rng r;
+		r.set(7);
+		std::vector<gsl::rng> rs = r.split(3, 12);
+		assert (rs.size() == 3);
+		for (auto& ri : rs)
+			for (int i = 0; i < 4096; ++i)
+				assert (ri.get() == r.get());
+
+		gsl::rng s;
+		s.set(7);
+		s.jump(3*4096);
+		assert (s.get() == r.get());
+	}
 }
 
 #endif // _DEBUG
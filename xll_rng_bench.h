@@ -0,0 +1,217 @@
+// xll_rng_bench.h - time and test random number generator types
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include "gsl/gsl_cdf.h"
+#include "gsl/gsl_randist.h"
+#include "xll_rng.h"
+#include "xll_ziggurat.h"
+
+namespace gsl {
+
+	// nanoseconds per value
+	struct rng_timing {
+		double single; // gsl_rng_uniform once per value
+		double bulk;   // gsl::rng::uniform into a buffer
+		double check;  // sum of the values so they are not optimized away
+	};
+
+	// time n uniform draws from a new generator of type t
+	inline rng_timing rng_benchmark(const gsl_rng_type* t, size_t n, size_t block = 1024)
+	{
+		using clock = std::chrono::steady_clock;
+		auto ns = [](clock::duration d) {
+			return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+		};
+
+		rng_timing timing = {0, 0, 0};
+		if (n == 0)
+			return timing;
+
+		gsl::rng r(t);
+		auto start = clock::now();
+		for (size_t i = 0; i < n; ++i)
+			timing.check += r.uniform();
+		timing.single = ns(clock::now() - start)/n;
+
+		std::vector<double> x(block);
+		start = clock::now();
+		for (size_t i = 0; i < n; i += block) {
+			size_t m = n - i < block ? n - i : block;
+			r.uniform(m, x.data());
+			timing.check += x[m - 1];
+		}
+		timing.bulk = ns(clock::now() - start)/n;
+
+		return timing;
+	}
+
+	// nanoseconds per standard normal
+	struct gaussian_timing {
+		double polar;    // gsl_ran_gaussian
+		double gsl;      // gsl_ran_gaussian_ziggurat
+		double single;   // gsl::ran_gaussian once per value
+		double bulk;     // gsl::ran_gaussian into a buffer
+		double check;
+	};
+
+	inline gaussian_timing gaussian_benchmark(const gsl_rng_type* t, size_t n, size_t block = 1024)
+	{
+		using clock = std::chrono::steady_clock;
+		auto ns = [n](clock::time_point start) {
+			return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count())/n;
+		};
+
+		gaussian_timing timing = {0, 0, 0, 0, 0};
+		if (n == 0)
+			return timing;
+
+		gsl::rng r(t);
+		ziggurat::instance();
+
+		auto start = clock::now();
+		for (size_t i = 0; i < n; ++i)
+			timing.check += gsl_ran_gaussian(r, 1);
+		timing.polar = ns(start);
+
+		start = clock::now();
+		for (size_t i = 0; i < n; ++i)
+			timing.check += gsl_ran_gaussian_ziggurat(r, 1);
+		timing.gsl = ns(start);
+
+		start = clock::now();
+		for (size_t i = 0; i < n; ++i)
+			timing.check += ran_gaussian(r);
+		timing.single = ns(start);
+
+		std::vector<double> x(block);
+		start = clock::now();
+		for (size_t i = 0; i < n; i += block) {
+			size_t m = n - i < block ? n - i : block;
+			ran_gaussian(r, m, x.data());
+			timing.check += x[m - 1];
+		}
+		timing.bulk = ns(start);
+
+		return timing;
+	}
+
+	// Quick statistical tests returning p-values. Small values fail, and buckets values
+	// very close to 1 mean the draws are too evenly spread to be random.
+	namespace rng_quality {
+
+		// chi-square test of n uniforms counted in k equal buckets
+		inline double buckets(const rng& r, size_t n, size_t k = 1024)
+		{
+			std::vector<double> count(k);
+			for (size_t i = 0; i < n; ++i)
+				++count[static_cast<size_t>(r.uniform()*k)];
+
+			double e = static_cast<double>(n)/k, chi2 = 0;
+			for (auto c : count)
+				chi2 += (c - e)*(c - e)/e;
+
+			return gsl_cdf_chisq_Q(chi2, static_cast<double>(k - 1));
+		}
+
+		// two sided test that the lag 1 correlation of n uniforms is 0
+		inline double serial(const rng& r, size_t n)
+		{
+			double x0 = r.uniform() - 0.5, x = x0, sxy = 0, sxx = 0;
+			for (size_t i = 1; i < n; ++i) {
+				double y = r.uniform() - 0.5;
+				sxy += x*y;
+				sxx += x*x;
+				x = y;
+			}
+			sxy += x*x0; // circular
+			sxx += x*x;
+
+			double z = fabs(sxy/sxx)*sqrt(static_cast<double>(n));
+
+			return 2*gsl_cdf_ugaussian_Q(z);
+		}
+
+		// Marsaglia's birthday spacings: m = 512 birthdays in a year of 2^24 days have
+		// a Poisson(2) number of repeated spacings. The total over reps is Poisson(2 reps).
+		inline double birthday(const rng& r, size_t reps = 500)
+		{
+			const size_t m = 512;
+			const double days = 16777216.0;
+			std::vector<std::uint32_t> b(m);
+
+			unsigned int j = 0;
+			for (size_t k = 0; k < reps; ++k) {
+				for (auto& bi : b)
+					bi = static_cast<std::uint32_t>(r.uniform()*days);
+				std::sort(b.begin(), b.end());
+				for (size_t i = m - 1; i > 0; --i)
+					b[i] -= b[i - 1];
+				std::sort(b.begin(), b.end());
+				for (size_t i = 1; i < m; ++i)
+					if (b[i] == b[i - 1])
+						++j;
+			}
+
+			double mu = 2.*reps;
+			double p = gsl_cdf_poisson_P(j, mu);
+			double q = j ? gsl_cdf_poisson_Q(j - 1, mu) : 1;
+
+			return (std::min)(1., 2*(std::min)(p, q));
+		}
+
+	} // rng_quality
+
+} // gsl
+
+#ifdef _DEBUG
+#include <cassert>
+
+inline void test_gsl_rng_bench()
+{
+	for (const gsl_rng_type* t : {gsl_rng_mt19937, gsl::sfmt::sfmt19937_type(), gsl::sfmt::dsfmt19937_type()}) {
+		gsl::rng_timing timing = gsl::rng_benchmark(t, 10000);
+		assert (timing.single >= 0 && timing.bulk >= 0);
+		assert (timing.check > 0);
+	}
+	{
+		gsl::gaussian_timing timing = gsl::gaussian_benchmark(gsl_rng_mt19937, 10000);
+		assert (timing.polar >= 0 && timing.gsl >= 0 && timing.single >= 0 && timing.bulk >= 0);
+	}
+
+	gsl::rng r;
+	assert (gsl::rng_quality::buckets(r, 100000) > 1e-4);
+	assert (gsl::rng_quality::serial(r, 100000) > 1e-4);
+	assert (gsl::rng_quality::birthday(r, 100) > 1e-4);
+
+	// a Weyl sequence is too regular
+	struct weyl {
+		double x;
+		static void set(void* s, unsigned long)
+		{
+			static_cast<weyl*>(s)->x = 0;
+		}
+		static double get_double(void* s)
+		{
+			double& x = static_cast<weyl*>(s)->x;
+			x += 0.6180339887498949;
+			if (x >= 1)
+				x -= 1;
+
+			return x;
+		}
+		static unsigned long get(void* s)
+		{
+			return static_cast<unsigned long>(get_double(s)*4294967296.0);
+		}
+	};
+	static const gsl_rng_type weyl_type = {"weyl", 0xFFFFFFFFUL, 0, sizeof(weyl), &weyl::set, &weyl::get, &weyl::get_double};
+	gsl::rng w(&weyl_type);
+	assert (gsl::rng_quality::buckets(w, 100000) > 1 - 1e-4);
+	assert (gsl::rng_quality::serial(w, 100000) < 1e-4);
+	assert (gsl::rng_quality::birthday(w, 100) < 1e-4);
+}
+
+#endif // _DEBUG
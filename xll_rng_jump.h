@@ -0,0 +1,453 @@
+// xll_rng_jump.h - jump ahead for Mersenne twister and multiple recursive generators
+// Haramoto, Matsumoto, Nishimura, Panneton, L'Ecuyer "Efficient jump ahead for F2-linear
+// random number generators" INFORMS J. on Computing 20(3) 2008
+#pragma once
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "gsl/gsl_rng.h"
+#include "xll_cbrng.h"
+
+namespace gsl {
+
+namespace jump {
+
+	// polynomials over GF(2), bit i of the words is the coefficient of t^i
+	namespace gf2 {
+
+		using poly = std::vector<std::uint64_t>;
+
+		inline bool bit(const poly& p, size_t i)
+		{
+			return (p[i/64] >> (i%64)) & 1;
+		}
+		inline void flip(poly& p, size_t i)
+		{
+			p[i/64] ^= std::uint64_t(1) << (i%64);
+		}
+		// p ^= q t^s
+		inline void add_shifted(poly& p, const poly& q, size_t s)
+		{
+			size_t w = s/64, b = s%64;
+
+			for (size_t i = 0; i < q.size() && i + w < p.size(); ++i) {
+				p[i + w] ^= q[i] << b;
+				if (b && i + w + 1 < p.size())
+					p[i + w + 1] ^= q[i] >> (64 - b);
+			}
+		}
+
+		// p mod phi where phi has degree L, result has L bits
+		inline poly mod(poly p, const poly& phi, size_t L)
+		{
+			for (size_t i = 64*p.size(); i-- > L; )
+				if (bit(p, i))
+					add_shifted(p, phi, i - L);
+			p.resize((L + 63)/64);
+			if (L%64)
+				p.back() &= (std::uint64_t(1) << (L%64)) - 1;
+
+			return p;
+		}
+		// p^2 mod phi, squaring over GF(2) spreads the bits
+		inline poly square(const poly& p, const poly& phi, size_t L)
+		{
+			poly q(2*p.size());
+
+			for (size_t i = 0; i < p.size(); ++i) {
+				for (size_t j = 0; j < 64; ++j) {
+					if ((p[i] >> j) & 1)
+						q[(2*(64*i + j))/64] |= std::uint64_t(1) << ((2*j)%64);
+				}
+			}
+
+			return mod(q, phi, L);
+		}
+		// t p mod phi
+		inline poly times_t(poly p, const poly& phi, size_t L)
+		{
+			std::uint64_t carry = 0;
+			for (auto& w : p) {
+				std::uint64_t c = w >> 63;
+				w = (w << 1) | carry;
+				carry = c;
+			}
+			p.push_back(carry);
+
+			return mod(p, phi, L);
+		}
+
+		// minimal polynomial of the bit sequence s with Berlekamp-Massey
+		// Returns the connection polynomial C with C[0] = 1 and sets L to its degree.
+		inline poly berlekamp_massey(const std::vector<bool>& s, size_t& L)
+		{
+			size_t N = s.size(), W = (N + 64)/64;
+			poly C(W), B(W);
+			C[0] = B[0] = 1;
+
+			// bit k of R is s[N - 1 - k] so sum_i c_i s[n - i] is a word wise and with R >> (N - 1 - n)
+			poly R(W + 1);
+			for (size_t k = 0; k < N; ++k)
+				if (s[N - 1 - k])
+					flip(R, k);
+
+			L = 0;
+			size_t m = 1;
+			for (size_t n = 0; n < N; ++n) {
+				size_t off = N - 1 - n, ow = off/64, ob = off%64;
+				std::uint64_t d = 0;
+				for (size_t i = 0; i <= L/64; ++i) {
+					std::uint64_t r = ow + i < R.size() ? R[ow + i] >> ob : 0;
+					if (ob && ow + i + 1 < R.size())
+						r |= R[ow + i + 1] << (64 - ob);
+					d ^= C[i] & r;
+				}
+				// parity
+				d ^= d >> 32; d ^= d >> 16; d ^= d >> 8; d ^= d >> 4; d ^= d >> 2; d ^= d >> 1;
+
+				if ((d & 1) == 0) {
+					++m;
+				}
+				else if (2*L <= n) {
+					poly T = C;
+					add_shifted(C, B, m);
+					L = n + 1 - L;
+					B = T;
+					m = 1;
+				}
+				else {
+					add_shifted(C, B, m);
+					++m;
+				}
+			}
+
+			return C;
+		}
+
+	} // gf2
+
+	// Mersenne twister as used by gsl_rng_mt19937, gsl_rng_mt19937_1999 and gsl_rng_mt19937_1998
+	namespace mt {
+
+		enum : size_t { N = 624, M = 397 };
+
+		// layout of the GSL state
+		struct state {
+			unsigned long mt[N];
+			int mti;
+		};
+
+		inline bool is_mt(const gsl_rng* r)
+		{
+			return (r->type == gsl_rng_mt19937 || r->type == gsl_rng_mt19937_1999 || r->type == gsl_rng_mt19937_1998)
+				&& r->type->size == sizeof(state);
+		}
+
+		inline std::uint32_t twist(std::uint32_t u, std::uint32_t v)
+		{
+			std::uint32_t y = (u & 0x80000000UL) | (v & 0x7fffffffUL);
+
+			return (y >> 1) ^ ((v & 1) ? 0x9908b0dfUL : 0);
+		}
+
+		// window x[p], ..., x[p + N - 1] of the word sequence stored circularly
+		struct window {
+			std::uint32_t x[N];
+			size_t p;
+
+			// slide one word forward
+			void next()
+			{
+				std::uint32_t y = x[(p + M)%N] ^ twist(x[p], x[(p + 1)%N]);
+				x[p] = y;
+				p = (p + 1)%N;
+			}
+			void add(const std::uint32_t* w)
+			{
+				for (size_t i = 0; i < N; ++i)
+					x[(p + i)%N] ^= w[i];
+			}
+		};
+
+		// characteristic polynomial phi of the 19937 bit linear state, bit i is the coefficient of t^i
+		inline const gf2::poly& phi(size_t& L)
+		{
+			struct poly_ {
+				gf2::poly phi;
+				size_t L;
+
+				poly_()
+				{
+					// bit 0 of the word sequence from an arbitrary seed
+					window w;
+					w.p = 0;
+					w.x[0] = 5489;
+					for (size_t i = 1; i < N; ++i)
+						w.x[i] = 1812433253UL*(w.x[i - 1] ^ (w.x[i - 1] >> 30)) + static_cast<std::uint32_t>(i);
+
+					std::vector<bool> s(2*(32*N - 31) + 64);
+					for (size_t i = 0; i < s.size(); ++i) {
+						w.next();
+						s[i] = w.x[(w.p + N - 1)%N] & 1;
+					}
+
+					gf2::poly C = gf2::berlekamp_massey(s, L);
+					// phi(t) = t^L C(1/t)
+					phi.assign(L/64 + 1, 0);
+					for (size_t i = 0; i <= L; ++i)
+						if (gf2::bit(C, i))
+							gf2::flip(phi, L - i);
+				}
+			};
+			static const poly_ p;
+
+			L = p.L;
+
+			return p.phi;
+		}
+
+		// x = g(F) x where F slides the window one word
+		inline void apply(const gf2::poly& g, size_t L, state& s)
+		{
+			std::uint32_t x[N];
+			for (size_t i = 0; i < N; ++i)
+				x[i] = static_cast<std::uint32_t>(s.mt[i]);
+
+			window w = {};
+			for (size_t i = L; i-- > 0; ) {
+				w.next();
+				if (gf2::bit(g, i))
+					w.add(x);
+			}
+
+			for (size_t i = 0; i < N; ++i)
+				s.mt[i] = w.x[(w.p + i)%N];
+		}
+
+		// t^n mod phi
+		inline gf2::poly power(std::uint64_t n)
+		{
+			size_t L;
+			const gf2::poly& f = phi(L);
+			gf2::poly g((L + 63)/64);
+			g[0] = 1;
+
+			for (size_t i = 64; i-- > 0; ) {
+				g = gf2::square(g, f, L);
+				if ((n >> i) & 1)
+					g = gf2::times_t(g, f, L);
+			}
+
+			return g;
+		}
+		// t^(2^e) mod phi
+		inline gf2::poly power2(unsigned e)
+		{
+			size_t L;
+			const gf2::poly& f = phi(L);
+			gf2::poly g((L + 63)/64);
+			g[0] = 2;
+
+			for (unsigned i = 0; i < e; ++i)
+				g = gf2::square(g, f, L);
+
+			return g;
+		}
+
+		// GSL keeps the words of the current block in mt and the index of the next output in mti.
+		// Sliding the block by n words and keeping mti moves the output n places ahead.
+		// The low bits of mt[0] are not part of the linear state but they are only output
+		// when mti is 0, which GSL never leaves behind.
+		inline void jump(const gsl_rng* r, const gf2::poly& g)
+		{
+			size_t L;
+			phi(L);
+
+			state& s = *static_cast<state*>(r->state);
+			if (s.mti == 0)
+				throw std::logic_error(__FILE__ ": " __FUNCTION__ ": unexpected Mersenne twister state");
+
+			apply(g, L, s);
+		}
+
+	} // mt
+
+	// multiple recursive generators gsl_rng_mrg and gsl_rng_cmrg
+	// The state is a vector of longs updated by a linear map modulo m for each component.
+	namespace mrg {
+
+		struct component {
+			size_t offset, dimension;
+			std::uint64_t m;
+		};
+
+		inline std::vector<component> components(const gsl_rng* r)
+		{
+			if (r->type == gsl_rng_mrg && r->type->size == 5*sizeof(long))
+				return {{0, 5, 2147483647}};
+			if (r->type == gsl_rng_cmrg && r->type->size == 6*sizeof(long))
+				return {{0, 3, 2147483647}, {3, 3, 2145483479}};
+
+			return {};
+		}
+
+		using matrix = std::vector<std::uint64_t>; // row major d x d
+
+		inline matrix multiply(const matrix& A, const matrix& B, size_t d, std::uint64_t m)
+		{
+			matrix C(d*d);
+
+			for (size_t i = 0; i < d; ++i)
+				for (size_t j = 0; j < d; ++j) {
+					std::uint64_t c = 0;
+					for (size_t k = 0; k < d; ++k)
+						c = (c + (A[i*d + k]*B[k*d + j])%m)%m;
+					C[i*d + j] = c;
+				}
+
+			return C;
+		}
+
+		// one step transition matrix read off from the generator applied to unit vectors
+		inline matrix transition(const gsl_rng_type* T, const component& c)
+		{
+			matrix A(c.dimension*c.dimension);
+			std::vector<long> s(T->size/sizeof(long));
+
+			for (size_t j = 0; j < c.dimension; ++j) {
+				std::fill(s.begin(), s.end(), 0);
+				s[c.offset + j] = 1;
+				T->get(s.data());
+				for (size_t i = 0; i < c.dimension; ++i)
+					A[i*c.dimension + j] = static_cast<std::uint64_t>(s[c.offset + i]);
+			}
+
+			return A;
+		}
+
+		inline matrix identity(size_t d)
+		{
+			matrix I(d*d);
+			for (size_t i = 0; i < d; ++i)
+				I[i*d + i] = 1;
+
+			return I;
+		}
+
+		// s = A s for the component
+		inline void apply(const matrix& A, const component& c, long* s)
+		{
+			size_t d = c.dimension;
+			std::vector<std::uint64_t> x(d);
+
+			for (size_t i = 0; i < d; ++i)
+				for (size_t k = 0; k < d; ++k)
+					x[i] = (x[i] + (A[i*d + k]*static_cast<std::uint64_t>(s[c.offset + k]))%c.m)%c.m;
+			for (size_t i = 0; i < d; ++i)
+				s[c.offset + i] = static_cast<long>(x[i]);
+		}
+
+		// A^(n 2^e)
+		inline void jump(const gsl_rng* r, std::uint64_t n, unsigned e = 0)
+		{
+			for (const auto& c : components(r)) {
+				size_t d = c.dimension;
+				matrix A = transition(r->type, c);
+				for (unsigned i = 0; i < e; ++i)
+					A = multiply(A, A, d, c.m);
+
+				matrix P = identity(d);
+				for (std::uint64_t k = n; k; k >>= 1) {
+					if (k & 1)
+						P = multiply(P, A, d, c.m);
+					A = multiply(A, A, d, c.m);
+				}
+
+				apply(P, c, static_cast<long*>(r->state));
+			}
+		}
+
+	} // mrg
+
+	// true if r can jump ahead
+	inline bool can_jump(const gsl_rng* r)
+	{
+		return mt::is_mt(r) || !mrg::components(r).empty() || cbrng::is_counter(r);
+	}
+
+	// advance r as if gsl_rng_get was called n times
+	inline void ahead(const gsl_rng* r, std::uint64_t n)
+	{
+		if (mt::is_mt(r))
+			mt::jump(r, mt::power(n));
+		else if (!mrg::components(r).empty())
+			mrg::jump(r, n);
+		else if (cbrng::is_counter(r))
+			cbrng::discard(r, n);
+		else
+			throw std::invalid_argument(__FILE__ ": " __FUNCTION__ ": jump ahead is not supported for this generator type");
+	}
+
+	// advance r as if gsl_rng_get was called 2^e times
+	inline void ahead_pow2(const gsl_rng* r, unsigned e)
+	{
+		if (mt::is_mt(r)) {
+			// the polynomial only depends on e
+			static thread_local unsigned e_ = 0;
+			static thread_local gf2::poly g;
+			if (g.empty() || e != e_) {
+				g = mt::power2(e);
+				e_ = e;
+			}
+			mt::jump(r, g);
+		}
+		else if (!mrg::components(r).empty()) {
+			mrg::jump(r, 1, e);
+		}
+		else if (cbrng::is_counter(r) && e < 64) {
+			cbrng::discard(r, std::uint64_t(1) << e);
+		}
+		else {
+			throw std::invalid_argument(__FILE__ ": " __FUNCTION__ ": jump ahead is not supported for this generator type");
+		}
+	}
+
+} // jump
+
+} // gsl
+
+#ifdef _DEBUG
+#include <cassert>
+
+// jumps agree with sequential generation
+inline void test_gsl_rng_jump()
+{
+	for (const gsl_rng_type* T : {gsl_rng_mt19937, gsl_rng_cmrg, gsl_rng_mrg}) {
+		gsl_rng* r = gsl_rng_alloc(T);
+		gsl_rng* s = gsl_rng_alloc(T);
+		assert (gsl::jump::can_jump(r));
+
+		gsl_rng_set(r, 12345);
+		for (std::uint64_t n : {0, 1, 623, 624, 625, 2000}) {
+			gsl_rng_memcpy(s, r);
+			gsl::jump::ahead(s, n);
+			for (std::uint64_t i = 0; i < n; ++i)
+				gsl_rng_get(r);
+			for (int i = 0; i < 1000; ++i)
+				assert (gsl_rng_get(r) == gsl_rng_get(s));
+		}
+
+		// 2^e draws at a time
+		gsl_rng_memcpy(s, r);
+		gsl::jump::ahead_pow2(s, 10);
+		for (int i = 0; i < 1024; ++i)
+			gsl_rng_get(r);
+		for (int i = 0; i < 1000; ++i)
+			assert (gsl_rng_get(r) == gsl_rng_get(s));
+
+		gsl_rng_free(s);
+		gsl_rng_free(r);
+	}
+}
+
+#endif // _DEBUG
@@ -5,6 +5,7 @@
 using namespace xll;
 
 using function = std::function<double(double)>;
+using fdfpair = gsl::function_fdf::fdfpair;
 
 XLL_ENUM_DOCX(p2h<const gsl_root_fsolver_type>(gsl_root_fsolver_bisection),GSL_ROOT_FSOLVER_BISECTION, CATEGORY, _T("Bisection method solver"), _T("Documentation"));
 XLL_ENUM_DOCX(p2h<const gsl_root_fsolver_type>(gsl_root_fsolver_brent),GSL_ROOT_FSOLVER_BRENT, CATEGORY, _T("Brent method solver"), _T("Documentation"));
@@ -21,6 +22,7 @@ static AddInX xai_root_fsolver(
 HANDLEX WINAPI xll_root_fsolver(HANDLEX type)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	handlex h;
 
 	try {
@@ -29,6 +31,7 @@ HANDLEX WINAPI xll_root_fsolver(HANDLEX type)
 		h = h_.get();
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -48,6 +51,7 @@ static AddInX xai_root_fsolver_set(
 HANDLEX WINAPI xll_root_fsolver_set(HANDLEX h, HANDLEX f, double lo, double hi)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	try {
 		handle<gsl::root::fsolver> h_(h);
 		handle<function> f_(f);
@@ -55,6 +59,7 @@ HANDLEX WINAPI xll_root_fsolver_set(HANDLEX h, HANDLEX f, double lo, double hi)
 		h_->set(*f_, lo, hi);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -71,12 +76,14 @@ static AddInX xai_root_fsolver_iterate(
 HANDLEX WINAPI xll_root_fsolver_iterate(HANDLEX h)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	try {
 		handle<gsl::root::fsolver> h_(h);
 
 		ensure (GSL_SUCCESS == h_->iterate());
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -93,6 +100,7 @@ static AddInX xai_root_fsolver_root(
 HANDLEX WINAPI xll_root_fsolver_root(HANDLEX h)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	handlex root;
 
 	try {
@@ -101,6 +109,7 @@ HANDLEX WINAPI xll_root_fsolver_root(HANDLEX h)
 		root = h_->root();
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -117,6 +126,7 @@ static AddInX xai_root_fsolver_x_lower(
 HANDLEX WINAPI xll_root_fsolver_x_lower(HANDLEX h)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	handlex lo;
 
 	try {
@@ -125,6 +135,7 @@ HANDLEX WINAPI xll_root_fsolver_x_lower(HANDLEX h)
 		lo = h_->x_lower();
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -141,6 +152,7 @@ static AddInX xai_root_fsolver_x_upper(
 HANDLEX WINAPI xll_root_fsolver_x_upper(HANDLEX h)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	handlex lo;
 
 	try {
@@ -149,6 +161,7 @@ HANDLEX WINAPI xll_root_fsolver_x_upper(HANDLEX h)
 		lo = h_->x_upper();
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -170,6 +183,7 @@ static AddInX xai_root_fdfsolver(
 HANDLEX WINAPI xll_root_fdfsolver(HANDLEX type)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	handlex h;
 
 	try {
@@ -178,6 +192,7 @@ HANDLEX WINAPI xll_root_fdfsolver(HANDLEX type)
 		h = h_.get();
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -187,24 +202,37 @@ HANDLEX WINAPI xll_root_fdfsolver(HANDLEX type)
 static AddInX xai_root_fdfsolver_set(
 	FunctionX(XLL_HANDLEX, _T("?xll_root_fdfsolver_set"), PREFIX _T("ROOT.FDFSOLVER.SET"))
 	.Arg(XLL_HANDLEX, _T("Solver"), _T("is a handle returned by ") PREFIX _T("ROOT.FDFSOLVER"))
-	.Arg(XLL_HANDLEX, _T("F"), _T("is a handle used by XLL.."))
-	.Arg(XLL_HANDLEX, _T("dF"), _T("is a handle used by XLL.."))
+	.Arg(XLL_HANDLEX, _T("F"), _T("is a handle to a function, or to a function returning f and f' if dF is missing."))
+	.Arg(XLL_HANDLEX, _T("dF"), _T("is a handle to the derivative of F. "))
 	.Arg(XLL_DOUBLEX, _T("X0"), _T("is the initial root guess."))
 	.Category(CATEGORY)
 	.FunctionHelp(_T("Return a handle to a gsl::root::fsolver object."))
-	.Documentation(_T(""))
+	.Documentation(
+		_T("If dF is missing then F must be a handle returned by XLL.FUNCTION.FDF.REGID ")
+		_T("and the function and its derivative are computed in a single call. ")
+	)
 );
 HANDLEX WINAPI xll_root_fdfsolver_set(HANDLEX h, HANDLEX f, HANDLEX df, double x0)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	try {
 		handle<gsl::root::fdfsolver> h_(h);
-		handle<function> f_(f);
-		handle<function> df_(df);
 
-		h_->set(*f_, *df_, x0);
+		if (df == 0) {
+			handle<fdfpair> fdf_(f);
+
+			h_->set(*fdf_, x0);
+		}
+		else {
+			handle<function> f_(f);
+			handle<function> df_(df);
+
+			h_->set(*f_, *df_, x0);
+		}
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -221,12 +249,14 @@ static AddInX xai_root_fdfsolver_iterate(
 HANDLEX WINAPI xll_root_fdfsolver_iterate(HANDLEX h)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	try {
 		handle<gsl::root::fdfsolver> h_(h);
 
 		ensure (GSL_SUCCESS == h_->iterate());
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -243,6 +273,7 @@ static AddInX xai_root_fdfsolver_root(
 HANDLEX WINAPI xll_root_fdfsolver_root(HANDLEX h)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	handlex root;
 
 	try {
@@ -251,6 +282,7 @@ HANDLEX WINAPI xll_root_fdfsolver_root(HANDLEX h)
 		root = h_->root();
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -109,6 +109,13 @@ namespace root {
 
 			return gsl_root_fdfsolver_set(s.get(), &FdF, x0);
 		}
+		// function returning the pair f(x), f'(x) in one call
+		int set(const gsl::function_fdf::fdfpair& fdf, double x0)
+		{
+			FdF = gsl::function_fdf(fdf);
+
+			return gsl_root_fdfsolver_set(s.get(), &FdF, x0);
+		}
 
 		// forward to gsl_root_fdfsolver_* functions
 		int iterate()
@@ -256,6 +263,20 @@ inline void test_gsl_root_fdfsolver()
 		double x = 5.0, epsrel = 1e-6;
 		s.set(F, dF, x);
 
+		double root = s.solve(gsl::root::test_delta(0, epsrel));
+		double sqrt5 = sqrt(5.);
+		assert (fabs(root - sqrt5) < sqrt5*epsrel);
+	}
+	// f and df computed together
+	{
+		gsl::root::fdfsolver s(gsl_root_fdfsolver_newton);
+
+		auto FdF = [](double x) {
+			return std::make_pair(x*x - 5, 2*x);
+		};
+		double x = 5.0, epsrel = 1e-6;
+		s.set(FdF, x);
+
 		double root = s.solve(gsl::root::test_delta(0, epsrel));
 		double sqrt5 = sqrt(5.);
 		assert (fabs(root - sqrt5) < sqrt5*epsrel);
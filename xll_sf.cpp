@@ -21,6 +21,7 @@ XLL_ENUM_DOCX(GSL_PREC_APPROX, GSL_PREC_APPROX, CATEGORY, _T("Approximate values
 	.Arg(XLL_WORD, "mode", "is the precision from the PREC_* enumeration") \
 	.Category("GSL").FunctionHelp(FH).Documentation(D)); \
 	extern "C" __declspec(dllexport) xfp* xll_ ## f(double x, gsl_mode_t mode) { \
+	XLL_PROFILE; \
 	return sf_unary_mode(gsl_ ## f ## _e, x, mode ? mode : GSL_PREC_DOUBLE); }
 
 #if 0
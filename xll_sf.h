@@ -6,22 +6,25 @@
 // create the add-in object
 #define SF_UNARY(f, F, FH, D) static AddIn xai_ ## f(Function(XLL_FP, ENSURE_STRZ_(xll_ ## f), F) \
 	.Arg(XLL_DOUBLE, "x", "is a number") \
-	.Category("GSL").FunctionHelp(FH).Documentation(D)); \
+	.ThreadSafe().Category("GSL").FunctionHelp(FH).Documentation(D)); \
 	extern "C" __declspec(dllexport) xfp* xll_ ## f(double x, gsl_mode_t mode) { \
+	XLL_PROFILE; \
 	return sf_unary(gsl_ ## f ## _e, x); }
 
 #define SF_UNARY_MODE(f, F, FH, D) static AddIn xai_ ## f(Function(XLL_FP, ENSURE_STRZ_(xll_ ## f), F) \
 	.Arg(XLL_DOUBLE, "x", "is a number") \
 	.Arg(XLL_WORD, "mode", "is the precision from the PREC_* enumeration") \
-	.Category("GSL").FunctionHelp(FH).Documentation(D)); \
+	.ThreadSafe().Category("GSL").FunctionHelp(FH).Documentation(D)); \
 	extern "C" __declspec(dllexport) xfp* xll_ ## f(double x, gsl_mode_t mode) { \
+	XLL_PROFILE; \
 	return sf_unary_mode(gsl_ ## f ## _e, x, mode ? mode : GSL_PREC_DOUBLE); }
 
 namespace xll {
 
+	// The result buffers are thread_local so the add-ins can be registered thread safe.
 	inline xfpx*	sf_unary(int (*f)(double,gsl_sf_result*), double x)
 	{
-		static FPX y(1, 2);
+		static thread_local FPX y(1, 2);
 		gsl_sf_result r;
 
 		try {
@@ -30,6 +33,7 @@ namespace xll {
 			y[1] = r.err;
 		}
 		catch (const std::exception& ex) {
+			XLL_PROFILE_ERROR;
 			XLL_ERROR(ex.what());
 
 			return 0;
@@ -40,7 +44,7 @@ namespace xll {
 
 	inline xfpx*	sf_unary_mode(int (*f)(double,gsl_mode_t,gsl_sf_result*), double x, gsl_mode_t mode)
 	{
-		static FPX y(1, 2);
+		static thread_local FPX y(1, 2);
 		gsl_sf_result r;
 
 		try {
@@ -49,6 +53,7 @@ namespace xll {
 			y[1] = r.err;
 		}
 		catch (const std::exception& ex) {
+			XLL_PROFILE_ERROR;
 			XLL_ERROR(ex.what());
 
 			return 0;
@@ -0,0 +1,202 @@
+// xll_siman.cpp - simulated annealing and parallel tempering
+#include <type_traits>
+#include "xll_siman.h"
+#include "xll_multimin.h"
+#include "xll_gsl.h"
+
+using namespace xll;
+
+using energy = gsl::siman::energy;
+// f is a handle returned by MULTMIN.FUNCTION.REGID
+static_assert(std::is_same<energy, gsl::multimin::function<double>>::value, "energy must match the multimin function handle type");
+
+// optional bounds and integer steps
+inline gsl::siman::step siman_step(size_t n, const xfpx* plo, const xfpx* phi, BOOL integer)
+{
+	std::vector<double> lo, hi;
+
+	if (size(*plo) == n && size(*phi) == n) {
+		lo.assign(plo->array, plo->array + n);
+		hi.assign(phi->array, phi->array + n);
+	}
+	else {
+		ensure ((size(*plo) == 1 && size(*phi) == 1) || !"GSL.SIMAN: Lo and Hi must both have one entry per coordinate");
+	}
+
+	return gsl::siman::uniform_step(lo, hi, integer != 0);
+}
+
+#define IS_LO _T("is an optional array of lower bounds for each coordinate")
+#define IS_HI _T("is an optional array of upper bounds for each coordinate")
+#define IS_INTEGER _T("restricts steps to integers if true. Default is false")
+
+static AddInX xai_siman_solve(
+	FunctionX(XLL_FPX, _T("?xll_siman_solve"), PREFIX _T("SIMAN.SOLVE"))
+	.Arg(XLL_HANDLEX, _T("f"), _T("is a handle returned by ") PREFIX _T("MULTMIN.FUNCTION.REGID"))
+	.Arg(XLL_FPX, _T("x"), _T("is the initial point"))
+	.Arg(XLL_DOUBLEX, _T("Step"), _T("is the maximum step size. Default is 1"), 1)
+	.Arg(XLL_DOUBLEX, _T("Tinitial"), _T("is the initial temperature. Default is 1"), 1)
+	.Arg(XLL_DOUBLEX, _T("Mu"), _T("is the cooling factor. Default is 1.01"), 1.01)
+	.Arg(XLL_DOUBLEX, _T("Tmin"), _T("is the final temperature. Default is 1e-3"), 1e-3)
+	.Arg(XLL_LONGX, _T("Iterations"), _T("is the number of iterations at each temperature. Default is 100"), 100)
+	.Arg(XLL_LONGX, _T("Seed"), _T("is the seed of the random number generator. Default is 0"))
+	.Arg(XLL_FPX, _T("Lo"), IS_LO)
+	.Arg(XLL_FPX, _T("Hi"), IS_HI)
+	.Arg(XLL_BOOLX, _T("Integer"), IS_INTEGER)
+	.Category(CATEGORY)
+	.FunctionHelp(_T("Minimize f using gsl_siman_solve and return a one row array of the minimum value followed by the point."))
+	.Documentation(
+		_T("The temperature is divided by Mu after every Iterations steps until it is less than Tmin. ")
+		_T("Each step moves one random coordinate uniformly by at most Step. ")
+	)
+);
+xfpx* WINAPI xll_siman_solve(HANDLEX f, const xfpx* px, double step, double t, double mu, double tmin, LONG iters,
+	LONG seed, const xfpx* plo, const xfpx* phi, BOOL integer)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	static FPX x;
+
+	try {
+		if (step <= 0)
+			step = 1;
+		if (t <= 0)
+			t = 1;
+		if (mu <= 1)
+			mu = 1.01;
+		if (tmin <= 0)
+			tmin = 1e-3;
+		if (iters <= 0)
+			iters = 100;
+
+		handle<energy> f_(f);
+		size_t n = size(*px);
+
+		gsl_siman_params_t params = {1, static_cast<int>(iters), step, 1.0, t, mu, tmin};
+		gsl::rng r;
+		r.set(seed);
+
+		x.resize(1, static_cast<xword>(n + 1));
+		std::copy(px->array, px->array + n, x.begin() + 1);
+		x[0] = gsl::siman::solve(*f_, n, x.array() + 1, params, r, siman_step(n, plo, phi, integer));
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+
+		return 0;
+	}
+
+	return x.get();
+}
+
+static AddInX xai_siman_tempering(
+	FunctionX(XLL_HANDLEX, _T("?xll_siman_tempering"), PREFIX _T("SIMAN.TEMPERING"))
+	.Arg(XLL_HANDLEX, _T("f"), _T("is a handle returned by ") PREFIX _T("MULTMIN.FUNCTION.REGID"))
+	.Arg(XLL_FPX, _T("x"), _T("is the initial point"))
+	.Arg(XLL_WORDX, _T("Replicas"), _T("is the number of temperatures. Default is 8"), 8)
+	.Arg(XLL_DOUBLEX, _T("Tmin"), _T("is the temperature of the coldest replica. Default is 1e-3"), 1e-3)
+	.Arg(XLL_DOUBLEX, _T("Tmax"), _T("is the temperature of the hottest replica. Default is 1"), 1)
+	.Arg(XLL_DOUBLEX, _T("Step"), _T("is the maximum step size. Default is 1"), 1)
+	.Arg(XLL_LONGX, _T("Sweeps"), _T("is the number of steps per replica between swaps. Default is 100"), 100)
+	.Arg(XLL_LONGX, _T("Seed"), _T("is the seed of the generator the replica streams are split from. Default is 0"))
+	.Arg(XLL_BOOLX, _T("Parallel"), _T("runs the replicas in parallel if true. Functions from ") PREFIX _T("MULTMIN.FUNCTION.REGID call Excel and can not be run in parallel"))
+	.Arg(XLL_FPX, _T("Lo"), IS_LO)
+	.Arg(XLL_FPX, _T("Hi"), IS_HI)
+	.Arg(XLL_BOOLX, _T("Integer"), IS_INTEGER)
+	.Uncalced()
+	.Category(CATEGORY)
+	.FunctionHelp(_T("Return a handle to a gsl::siman::tempering object."))
+	.Documentation(
+		_T("Replicas at temperatures spaced geometrically from Tmin to Tmax run Metropolis walks ")
+		_T("with disjoint streams split from one Mersenne twister and periodically swap states with their neighbours. ")
+		_T("Use ") PREFIX _T("SIMAN.TEMPERING.RUN to advance the walk. ")
+	)
+);
+HANDLEX WINAPI xll_siman_tempering(HANDLEX f, const xfpx* px, WORD replicas, double tmin, double tmax, double step,
+	LONG sweeps, LONG seed, BOOL parallel, const xfpx* plo, const xfpx* phi, BOOL integer)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	handlex h;
+
+	try {
+		handle<energy> f_(f);
+		size_t n = size(*px);
+
+		gsl::siman::tempering_options o;
+		if (replicas > 0)
+			o.replicas = replicas;
+		if (tmin > 0)
+			o.t_min = tmin;
+		if (tmax > 0)
+			o.t_max = tmax;
+		if (step > 0)
+			o.step_size = step;
+		if (sweeps > 0)
+			o.sweeps = sweeps;
+		o.seed = seed;
+		o.parallel = parallel != 0;
+
+		handle<gsl::siman::tempering> h_(new gsl::siman::tempering(*f_, n, px->array, o, siman_step(n, plo, phi, integer)));
+
+		h = h_.get();
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+	}
+
+	return h;
+}
+
+static AddInX xai_siman_tempering_run(
+	FunctionX(XLL_FPX, _T("?xll_siman_tempering_run"), PREFIX _T("SIMAN.TEMPERING.RUN"))
+	.Arg(XLL_HANDLEX, _T("Tempering"), _T("is a handle returned by ") PREFIX _T("SIMAN.TEMPERING"))
+	.Arg(XLL_LONGX, _T("Iterations"), _T("is the maximum number of rounds of sweeps and swaps. Zero means no limit"))
+	.Arg(XLL_DOUBLEX, _T("Seconds"), _T("is the maximum running time in seconds. Zero means no limit"))
+	.Category(CATEGORY)
+	.FunctionHelp(_T("Run parallel tempering and return a one row array of the minimum value, the point, iterations and swap rate."))
+	.Documentation(
+		_T("At least one of Iterations or Seconds must be positive. ")
+		_T("Each call continues from where the last one stopped and the best point seen is kept. ")
+	)
+);
+xfpx* WINAPI xll_siman_tempering_run(HANDLEX h, LONG iters, double seconds)
+{
+#pragma XLLEXPORT
+	XLL_PROFILE;
+	static FPX x;
+
+	try {
+		handle<gsl::siman::tempering> h_(h);
+
+		ensure (iters >= 0);
+		h_->run(iters, seconds);
+
+		size_t n = h_->size();
+		x.resize(1, static_cast<xword>(n + 3));
+		x[0] = h_->minimum();
+		std::copy(h_->x(), h_->x() + n, x.begin() + 1);
+		x[static_cast<xword>(n + 1)] = static_cast<double>(h_->iterations());
+		x[static_cast<xword>(n + 2)] = h_->swap_rate();
+	}
+	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
+		XLL_ERROR(ex.what());
+
+		return 0;
+	}
+
+	return x.get();
+}
+
+#ifdef _DEBUG
+
+XLL_TEST_BEGIN(xll_test_siman)
+
+	test_gsl_siman();
+
+XLL_TEST_END(xll_test_siman)
+
+#endif // _DEBUG
@@ -0,0 +1,366 @@
+// xll_siman.h - simulated annealing and parallel tempering
+// http://www.gnu.org/software/gsl/manual/html_node/Simulated-Annealing.html
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include "gsl/gsl_math.h"
+#include "gsl/gsl_siman.h"
+#include "xll_parallel.h"
+#include "xll_rng.h"
+
+namespace gsl {
+
+namespace siman {
+
+	// function to minimize
+	using energy = std::function<double(size_t n, const double* x)>;
+	// modify x in place using r for a move of roughly size step_size
+	using step = std::function<void(const gsl_rng* r, size_t n, double* x, double step_size)>;
+
+	// move one random coordinate uniformly in [-step_size, step_size]
+	// If integer then coordinates move by at least one and stay integers.
+	// Coordinates are reflected back into [lo, hi] if the bounds are not empty.
+	inline step uniform_step(const std::vector<double>& lo = std::vector<double>{},
+		const std::vector<double>& hi = std::vector<double>{}, bool integer = false)
+	{
+		if (lo.size() != hi.size())
+			throw std::invalid_argument(__FILE__ ": " __FUNCTION__ ": lo and hi must have the same size");
+
+		return [lo,hi,integer](const gsl_rng* r, size_t n, double* x, double step_size) {
+			size_t j = gsl_rng_uniform_int(r, static_cast<unsigned long>(n));
+			double dx = step_size*(2*gsl_rng_uniform(r) - 1);
+
+			if (integer) {
+				dx = floor(dx + 0.5);
+				if (dx == 0)
+					dx = gsl_rng_uniform(r) < 0.5 ? -1 : 1;
+			}
+			x[j] += dx;
+
+			if (!lo.empty()) {
+				double a = lo[j], b = hi[j];
+				if (b > a) {
+					// reflect so the walk is symmetric near the boundary
+					double w = 2*(b - a);
+					double y = fmod(x[j] - a, w);
+					if (y < 0)
+						y += w;
+					x[j] = a + (y <= b - a ? y : w - y);
+				}
+				else {
+					x[j] = a;
+				}
+			}
+		};
+	}
+
+	// classic annealing using gsl_siman_solve on x of size n, x is overwritten with the best point
+	// Exceptions thrown by E are treated as infinite energy.
+	inline double solve(const energy& E, size_t n, double* x, const gsl_siman_params_t& params,
+		const gsl_rng* r, const step& S = uniform_step())
+	{
+		struct state {
+			const energy* E;
+			const step* S;
+			std::vector<double> x;
+		};
+
+		struct callback {
+			static double Ef(void* xp)
+			{
+				state& s = *static_cast<state*>(xp);
+
+				try {
+					return (*s.E)(s.x.size(), s.x.data());
+				}
+				catch (const std::exception&) {
+					return GSL_POSINF;
+				}
+			}
+			static void take_step(const gsl_rng* r, void* xp, double step_size)
+			{
+				state& s = *static_cast<state*>(xp);
+
+				(*s.S)(r, s.x.size(), s.x.data(), step_size);
+			}
+			static double distance(void* xp, void* yp)
+			{
+				const state& s = *static_cast<state*>(xp);
+				const state& t = *static_cast<state*>(yp);
+				double d = 0;
+
+				for (size_t i = 0; i < s.x.size(); ++i)
+					d += (s.x[i] - t.x[i])*(s.x[i] - t.x[i]);
+
+				return sqrt(d);
+			}
+			static void copy(void* source, void* dest)
+			{
+				*static_cast<state*>(dest) = *static_cast<state*>(source);
+			}
+			static void* copy_construct(void* xp)
+			{
+				return new state(*static_cast<state*>(xp));
+			}
+			static void destroy(void* xp)
+			{
+				delete static_cast<state*>(xp);
+			}
+		};
+
+		state s{&E, &S, std::vector<double>(x, x + n)};
+		gsl_siman_solve(r, &s, callback::Ef, callback::take_step, callback::distance, nullptr,
+			callback::copy, callback::copy_construct, callback::destroy, 0, params);
+		std::copy(s.x.begin(), s.x.end(), x);
+
+		return callback::Ef(&s);
+	}
+
+	struct tempering_options {
+		size_t replicas = 8;       // number of temperatures
+		double t_min = 1e-3;       // temperature of the coldest replica
+		double t_max = 1;          // temperature of the hottest replica
+		double step_size = 1;      // passed to the step function
+		size_t sweeps = 100;       // Metropolis steps per replica between swap attempts
+		unsigned long seed = 0;    // seed of the generator the replica streams are split from
+		bool parallel = false;     // only if E can be called from several threads at once
+	};
+
+	// Replicas at geometrically spaced temperatures each run a Metropolis walk on their own
+	// thread and a disjoint rng stream. After every round of sweeps adjacent replicas swap states with
+	// probability min(1, exp((1/T_k - 1/T_{k+1})(E_k - E_{k+1}))) so good states found by hot
+	// replicas migrate to cold ones. The best point seen by any replica is kept across runs.
+	class tempering {
+		struct replica {
+			gsl::rng r;
+			double T;
+			std::vector<double> x;
+			double e;
+			size_t accepted = 0, tried = 0;
+			std::vector<double> best_x;
+			double best_e;
+		};
+
+		energy E;
+		step S;
+		tempering_options o;
+		std::vector<replica> rs;
+		gsl::rng r; // swap decisions
+		std::vector<double> best_x;
+		double best_e;
+		size_t rounds, swaps, swap_tries;
+
+		double E_(const double* x) const
+		{
+			double e = E(best_x.size(), x);
+
+			return e == e ? e : GSL_POSINF; // NaN never accepted
+		}
+		void sweep(replica& p) const
+		{
+			size_t n = p.x.size();
+			std::vector<double> y(n);
+
+			for (size_t i = 0; i < o.sweeps; ++i) {
+				std::copy(p.x.begin(), p.x.end(), y.begin());
+				S(p.r, n, y.data(), o.step_size);
+				double e = E_(y.data());
+
+				++p.tried;
+				if (e <= p.e || p.r.uniform() < exp((p.e - e)/p.T)) {
+					p.x.swap(y);
+					p.e = e;
+					++p.accepted;
+					if (e < p.best_e) {
+						p.best_e = e;
+						p.best_x = p.x;
+					}
+				}
+			}
+		}
+	public:
+		tempering(const energy& E, size_t n, const double* x0,
+			const tempering_options& o = tempering_options{}, const step& S = uniform_step())
+			: E(E), S(S), o(o), best_x(x0, x0 + n), rounds(0), swaps(0), swap_tries(0)
+		{
+			if (n == 0)
+				throw std::invalid_argument(__FILE__ ": " __FUNCTION__ ": dimension must be positive");
+			if (o.replicas == 0 || !(o.t_min > 0) || o.t_max < o.t_min)
+				throw std::invalid_argument(__FILE__ ": " __FUNCTION__ ": need 0 < t_min <= t_max and at least one replica");
+
+			best_e = E_(x0);
+
+			// disjoint streams for the replicas and the swap decisions
+			size_t m = o.replicas;
+			gsl::rng g;
+			g.set(o.seed);
+			std::vector<gsl::rng> gs = g.split(m + 1);
+			r = gs[m];
+
+			rs.reserve(m);
+			for (size_t k = 0; k < m; ++k) {
+				rs.emplace_back();
+				replica& p = rs.back();
+				p.r = gs[k];
+				p.T = m == 1 ? o.t_min : o.t_min*pow(o.t_max/o.t_min, static_cast<double>(k)/(m - 1));
+				p.x = best_x;
+				p.e = best_e;
+				p.best_x = best_x;
+				p.best_e = best_e;
+			}
+		}
+		tempering(const tempering&) = delete;
+		tempering& operator=(const tempering&) = delete;
+
+		// run at most maxiter rounds or until seconds have elapsed, whichever comes first
+		// Zero means no limit but at least one of them must be positive.
+		void run(size_t maxiter, double seconds = 0)
+		{
+			if (maxiter == 0 && !(seconds > 0))
+				throw std::invalid_argument(__FILE__ ": " __FUNCTION__ ": need an iteration or time budget");
+
+			auto start = std::chrono::steady_clock::now();
+			size_t nthreads = o.parallel ? gsl::parallel::concurrency() : 1;
+
+			for (size_t iter = 0; maxiter == 0 || iter < maxiter; ++iter) {
+				gsl::parallel::for_each(rs.size(), [this](size_t k) {
+					sweep(rs[k]);
+				}, nthreads);
+
+				// alternate even and odd pairs so every pair gets a chance
+				for (size_t k = rounds%2; k + 1 < rs.size(); k += 2) {
+					replica& p = rs[k];
+					replica& q = rs[k + 1];
+					double a = (1/p.T - 1/q.T)*(p.e - q.e);
+
+					++swap_tries;
+					if (a >= 0 || r.uniform() < exp(a)) {
+						p.x.swap(q.x);
+						std::swap(p.e, q.e);
+						++swaps;
+					}
+				}
+				++rounds;
+
+				for (const auto& p : rs) {
+					if (p.best_e < best_e) {
+						best_e = p.best_e;
+						best_x = p.best_x;
+					}
+				}
+
+				if (seconds > 0) {
+					std::chrono::duration<double> dt = std::chrono::steady_clock::now() - start;
+					if (dt.count() >= seconds)
+						break;
+				}
+			}
+		}
+
+		size_t size() const
+		{
+			return best_x.size();
+		}
+		// lowest energy seen
+		double minimum() const
+		{
+			return best_e;
+		}
+		// point with the lowest energy seen
+		const double* x() const
+		{
+			return best_x.data();
+		}
+		// total rounds of sweeps and swaps
+		size_t iterations() const
+		{
+			return rounds;
+		}
+		// fraction of proposed swaps that were accepted
+		double swap_rate() const
+		{
+			return swap_tries ? static_cast<double>(swaps)/swap_tries : 0;
+		}
+		// fraction of Metropolis moves accepted by replica k, coldest first
+		double acceptance_rate(size_t k) const
+		{
+			const replica& p = rs.at(k);
+
+			return p.tried ? static_cast<double>(p.accepted)/p.tried : 0;
+		}
+		double temperature(size_t k) const
+		{
+			return rs.at(k).T;
+		}
+		size_t replicas() const
+		{
+			return rs.size();
+		}
+	};
+
+} // siman
+
+} // gsl
+
+#ifdef _DEBUG
+#include <cassert>
+
+// Rastrigin function has many local minima and a global minimum of 0 at the origin
+inline void test_gsl_siman()
+{
+	auto f = [](size_t n, const double* x) {
+		double y = 10.*n;
+		for (size_t i = 0; i < n; ++i)
+			y += x[i]*x[i] - 10*cos(2*M_PI*x[i]);
+		return y;
+	};
+	{
+		double x[] = {3.2, -2.7};
+		gsl::rng r;
+		gsl_siman_params_t params = {10, 100, 0.5, 1.0, 10, 1.01, 1e-3};
+		double e = gsl::siman::solve(f, 2, x, params, r);
+		assert (e < f(2, x) + 1e-12 && e > f(2, x) - 1e-12);
+		assert (e < 2);
+	}
+	{
+		double x[] = {3.2, -2.7, 4.1};
+		gsl::siman::tempering_options o;
+		o.t_min = 0.01;
+		o.t_max = 10;
+		o.step_size = 0.5;
+		o.parallel = true;
+		gsl::siman::tempering pt(f, 3, x, o);
+		pt.run(200);
+		assert (pt.iterations() == 200);
+		assert (pt.minimum() < 1);
+		assert (fabs(pt.minimum() - f(3, pt.x())) < 1e-12);
+		assert (pt.swap_rate() > 0);
+
+		// runs continue from the current states
+		double e = pt.minimum();
+		pt.run(0, 0.01);
+		assert (pt.iterations() > 200);
+		assert (pt.minimum() <= e);
+	}
+	{
+		// discrete: pick integers in [0, 20] closest to 7.3 and 12.6
+		auto g = [](size_t, const double* k) {
+			return (k[0] - 7.3)*(k[0] - 7.3) + (k[1] - 12.6)*(k[1] - 12.6);
+		};
+		double k[] = {0, 20};
+		gsl::siman::tempering_options o;
+		o.replicas = 4;
+		o.t_max = 10;
+		o.step_size = 3;
+		gsl::siman::tempering pt(g, 2, k, o, gsl::siman::uniform_step({0, 0}, {20, 20}, true));
+		pt.run(100);
+		assert (pt.x()[0] == 7 && pt.x()[1] == 13);
+	}
+}
+
+#endif // _DEBUG
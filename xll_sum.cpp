@@ -17,6 +17,7 @@ HANDLEX WINAPI
 xll_gsl_sum_levin(LONG n)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 
 	handle_sum_levin h(gsl_sum_levin_u_alloc(n), gsl_sum_levin_u_free);
 
@@ -34,6 +35,7 @@ xfp* WINAPI
 xll_gsl_sum_levin_accel(HANDLEX hx, xfp* px)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	static FPX result(2, 1);
 
 	try {
@@ -42,6 +44,7 @@ xll_gsl_sum_levin_accel(HANDLEX hx, xfp* px)
 		gsl_sum_levin_u_accel(px->array, size(*px), &*h, &result[0], &result[1]);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 
 		result = FPX();
@@ -1,6 +1,7 @@
 // xll_vswap.cpp - variance swap pricer
 #include "xll_vswap.h"
 #include "xll/xll.h"
+#include "xll_profile.h"
 
 using namespace xll;
 
@@ -22,6 +23,7 @@ double WINAPI xll_vswap(double D, double x0, double phi, double z,
 	xfpx* kput, xfpx* put, xfpx* kcall, xfpx* call)
 {
 #pragma XLLEXPORT
+	XLL_PROFILE;
 	doublex vswap;
 
 	try {
@@ -33,6 +35,7 @@ double WINAPI xll_vswap(double D, double x0, double phi, double z,
 			size(*kcall), kcall->array, call->array);
 	}
 	catch (const std::exception& ex) {
+		XLL_PROFILE_ERROR;
 		XLL_ERROR(ex.what());
 	}
 
@@ -0,0 +1,197 @@
+// xll_ziggurat.h - Ziggurat sampler for standard normal variates
+// Marsaglia, Tsang "The Ziggurat Method for Generating Random Variables" J. Stat. Software 2000
+// Doornik "An Improved Ziggurat Method to Generate Normal Random Samples" 2005
+#pragma once
+#include <cmath>
+#include "xll_rng.h"
+
+namespace gsl {
+
+	// The area under exp(-x^2/2), x >= 0, is covered by 256 layers of equal area V.
+	// Layer 0 is the base rectangle of height f(r) plus the tail beyond r.
+	// Layer i > 0 is the rectangle [0, x[i]] x [f(x[i]), f(x[i+1])].
+	// A single uniform picks a layer from its top 8 bits and a point in it from the rest.
+	class ziggurat {
+	public:
+		enum : int { layers = 256 };
+	private:
+		double r;                // start of the tail
+		double x[layers + 1];    // right edge of layer i, x[layers] = 0
+		double f[layers + 1];    // exp(-x[i]^2/2)
+		double ratio[layers];    // x[i+1]/x[i], points inside are always accepted
+
+		ziggurat()
+			: r(3.6541528853610088)
+		{
+			const double pi = 3.14159265358979323846;
+			double fr = exp(-0.5*r*r);
+			double V = r*fr + sqrt(pi/2)*erfc(r/sqrt(2.));
+
+			x[0] = V/fr;
+			x[1] = r;
+			for (int i = 2; i < layers; ++i)
+				x[i] = sqrt(-2*log(V/x[i - 1] + exp(-0.5*x[i - 1]*x[i - 1])));
+			x[layers] = 0;
+
+			for (int i = 0; i <= layers; ++i)
+				f[i] = exp(-0.5*x[i]*x[i]);
+			for (int i = 0; i < layers; ++i)
+				ratio[i] = x[i + 1]/x[i];
+		}
+		ziggurat(const ziggurat&) = delete;
+		ziggurat& operator=(const ziggurat&) = delete;
+
+		// Candidate u*x[i] failed the rectangle test. Return false to start over.
+		bool slow(const rng& g, int i, double u, double& z) const
+		{
+			if (i == 0) {
+				double a, b;
+				do {
+					a = -log(g.uniform_pos())/r;
+					b = -log(g.uniform_pos());
+				} while (b + b < a*a);
+				z = u < 0 ? -(r + a) : r + a;
+
+				return true;
+			}
+
+			double t = u*x[i];
+			if (f[i] + g.uniform()*(f[i + 1] - f[i]) < exp(-0.5*t*t)) {
+				z = t;
+
+				return true;
+			}
+
+			return false;
+		}
+	public:
+		// tables are built on first use
+		static const ziggurat& instance()
+		{
+			static const ziggurat z;
+
+			return z;
+		}
+
+		double tail() const
+		{
+			return r;
+		}
+
+		// one standard normal
+		double operator()(const rng& g) const
+		{
+			for (;;) {
+				double v = g.uniform()*layers;
+				int i = static_cast<int>(v);
+				double u = 2*(v - i) - 1;
+
+				if (fabs(u) < ratio[i])
+					return u*x[i];
+
+				double z;
+				if (slow(g, i, u, z))
+					return z;
+			}
+		}
+
+		// n standard normals
+		// Blocks of uniforms are turned into candidates and tested in a loop without
+		// branches the compiler can vectorize. The few rejected candidates are redone.
+		void operator()(const rng& g, size_t n, double* z) const
+		{
+			enum : size_t { block = 256 };
+			double v[block], t[block];
+			bool accept[block];
+
+			size_t k = 0;
+			while (k < n) {
+				size_t m = n - k < block ? n - k : block;
+				g.uniform(m, v);
+
+				for (size_t j = 0; j < m; ++j) {
+					double w = v[j]*layers;
+					int i = static_cast<int>(w);
+					double u = 2*(w - i) - 1;
+					t[j] = u*x[i];
+					accept[j] = fabs(u) < ratio[i];
+				}
+
+				for (size_t j = 0; j < m; ++j) {
+					if (accept[j]) {
+						z[k++] = t[j];
+					}
+					else {
+						double w = v[j]*layers;
+						int i = static_cast<int>(w);
+						if (slow(g, i, 2*(w - i) - 1, z[k]))
+							++k;
+					}
+				}
+			}
+		}
+	};
+
+	// Gaussian with standard deviation sigma using the ziggurat
+	inline double ran_gaussian(const rng& g, double sigma = 1)
+	{
+		return sigma*ziggurat::instance()(g);
+	}
+	inline void ran_gaussian(const rng& g, size_t n, double* z, double sigma = 1)
+	{
+		ziggurat::instance()(g, n, z);
+		if (sigma != 1)
+			for (size_t i = 0; i < n; ++i)
+				z[i] *= sigma;
+	}
+
+} // gsl
+
+#ifdef _DEBUG
+#include <cassert>
+#include <vector>
+#include "gsl/gsl_cdf.h"
+
+inline void test_gsl_ziggurat()
+{
+	gsl::rng g;
+	g.set(123);
+
+	std::vector<double> z(1000000);
+	gsl::ran_gaussian(g, z.size(), z.data());
+	for (size_t i = 0; i < 1000; ++i)
+		z[i] = gsl::ran_gaussian(g);
+
+	// moments
+	double n = static_cast<double>(z.size()), m1 = 0, m2 = 0, m4 = 0;
+	for (auto zi : z) {
+		m1 += zi;
+		m2 += zi*zi;
+		m4 += zi*zi*zi*zi;
+	}
+	m1 /= n;
+	m2 /= n;
+	m4 /= n;
+	assert (fabs(m1) < 5/sqrt(n));
+	assert (fabs(m2 - 1) < 5*sqrt(2/n));
+	assert (fabs(m4 - 3) < 5*sqrt(96/n));
+
+	// chi-square over 40 equal probability cells and the tails
+	std::vector<double> count(40);
+	size_t tail = 0;
+	double r = gsl::ziggurat::instance().tail();
+	for (auto zi : z) {
+		size_t c = static_cast<size_t>(gsl_cdf_ugaussian_P(zi)*count.size());
+		++count[c < count.size() ? c : count.size() - 1];
+		tail += fabs(zi) > r;
+	}
+	double e = n/count.size(), chi2 = 0;
+	for (auto c : count)
+		chi2 += (c - e)*(c - e)/e;
+	assert (gsl_cdf_chisq_Q(chi2, static_cast<double>(count.size() - 1)) > 1e-4);
+
+	double p = 2*gsl_cdf_ugaussian_Q(r);
+	assert (fabs(tail - n*p) < 5*sqrt(n*p));
+}
+
+#endif // _DEBUG